@@ -79,6 +79,12 @@ void		 gs_app_list_randomize		(GsAppList	*list);
 void		 gs_app_list_remove_all		(GsAppList	*list);
 void		 gs_app_list_truncate		(GsAppList	*list,
 						 guint		 length);
+void		 gs_app_list_skip		(GsAppList	*list,
+						 guint		 offset);
+void		 gs_app_list_sort_truncate	(GsAppList	*list,
+						 guint		 length,
+						 GsAppListSortFunc func,
+						 gpointer	 user_data);
 gboolean	 gs_app_list_has_flag		(GsAppList	*list,
 						 GsAppListFlags	 flag);
 void		 gs_app_list_add_flag		(GsAppList	*list,
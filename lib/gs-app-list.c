@@ -48,8 +48,31 @@ struct _GsAppList
 	GsAppListFlags		 flags;
 	AsAppState		 state;
 	guint			 progress;
+	GHashTable		*watched;		/* GsApp : GsAppListWatch */
+	gint64			 size_known;
+	gint64			 pc_known;
+	gint64			 pc_unknown;
+	gint			 n_known;
+	gint			 n_unknown;
+	gint			 n_installing;
+	gint			 n_removing;
+	gint			 n_purchasing;
+	guint			 notify_id;
+	gboolean		 notify_state;
+	gboolean		 notify_progress;
 };
 
+/* the last values a watched app added to the running totals */
+typedef struct {
+	guint			 refcount;
+	guint64			 size;			/* 0 for unknown */
+	guint			 progress;
+	AsAppState		 state;
+} GsAppListWatch;
+
+/* the aggregates drive the UI, so are not notified more than once a frame */
+#define GS_APP_LIST_NOTIFY_INTERVAL	16	/* ms */
+
 G_DEFINE_TYPE (GsAppList, gs_app_list, G_TYPE_OBJECT)
 
 enum {
@@ -75,7 +98,9 @@ enum {
 AsAppState
 gs_app_list_get_state (GsAppList *list)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_val_if_fail (GS_IS_APP_LIST (list), AS_APP_STATE_UNKNOWN);
+	locker = g_mutex_locker_new (&list->mutex);
 	return list->state;
 }
 
@@ -95,7 +120,9 @@ gs_app_list_get_state (GsAppList *list)
 guint
 gs_app_list_get_progress (GsAppList *list)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_return_val_if_fail (GS_IS_APP_LIST (list), 0);
+	locker = g_mutex_locker_new (&list->mutex);
 	return list->progress;
 }
 
@@ -128,95 +155,190 @@ gs_app_list_get_watched_for_app (GsAppList *list, GsApp *app)
 	return apps;
 }
 
-static GPtrArray *
-gs_app_list_get_watched (GsAppList *list)
+static void
+gs_app_list_watch_free (gpointer data)
 {
-	GPtrArray *apps = g_ptr_array_new ();
-	for (guint i = 0; i < list->array->len; i++) {
-		GsApp *app_tmp = g_ptr_array_index (list->array, i);
-		gs_app_list_add_watched_for_app (list, apps, app_tmp);
-	}
-	return apps;
+	g_slice_free (GsAppListWatch, data);
 }
 
+/* adds (@sign = 1) or takes away (@sign = -1) what @watch contributes to the
+ * running totals, so that changing one app never walks the whole list */
 static void
-gs_app_list_invalidate_progress (GsAppList *self)
+gs_app_list_totals_apply (GsAppList *list, GsAppListWatch *watch, gint sign)
 {
-	guint progress = 0;
-	g_autoptr(GPtrArray) apps = gs_app_list_get_watched (self);
+	gint64 n = sign * (gint64) watch->refcount;
 
-	/* find the average percentage complete of the list */
-	if (apps->len > 0) {
-		guint64 pc_cnt = 0;
-		for (guint i = 0; i < apps->len; i++) {
-			GsApp *app_tmp = g_ptr_array_index (apps, i);
-			pc_cnt += gs_app_get_progress (app_tmp);
-		}
-		progress = pc_cnt / apps->len;
+	if (watch->size > 0) {
+		list->size_known += n * (gint64) watch->size;
+		list->pc_known += n * (gint64) watch->size * watch->progress;
+		list->n_known += n;
+	} else {
+		list->pc_unknown += n * watch->progress;
+		list->n_unknown += n;
 	}
-	if (self->progress != progress) {
-		self->progress = progress;
-		g_object_notify (G_OBJECT (self), "progress");
+	switch (watch->state) {
+	case AS_APP_STATE_INSTALLING:
+		list->n_installing += n;
+		break;
+	case AS_APP_STATE_REMOVING:
+		list->n_removing += n;
+		break;
+	case AS_APP_STATE_PURCHASING:
+		list->n_purchasing += n;
+		break;
+	default:
+		break;
 	}
 }
 
 static void
-gs_app_list_invalidate_state (GsAppList *self)
+gs_app_list_watch_refresh (GsAppListWatch *watch, GsApp *app)
 {
-	AsAppState state = AS_APP_STATE_UNKNOWN;
-	g_autoptr(GPtrArray) apps = gs_app_list_get_watched (self);
+	guint64 size = gs_app_get_size_download (app);
+	watch->size = size != GS_APP_SIZE_UNKNOWABLE ? size : 0;
+	watch->progress = gs_app_get_progress (app);
+	watch->state = gs_app_get_state (app);
+}
 
+static guint
+gs_app_list_totals_get_progress (GsAppList *list)
+{
+	gint64 size_avg = 1;
+
+	/* find the percentage complete of the list, weighted by the download
+	 * size so that big downloads move the bar more than small ones, and
+	 * treating unknown sizes as the average known size */
+	if (list->n_known + list->n_unknown == 0)
+		return 0;
+	if (list->n_known > 0)
+		size_avg = list->size_known / list->n_known;
+	return (list->pc_known + size_avg * list->pc_unknown) /
+	       (list->size_known + size_avg * list->n_unknown);
+}
+
+static AsAppState
+gs_app_list_totals_get_state (GsAppList *list)
+{
 	/* find any action state of the list */
-	for (guint i = 0; i < apps->len; i++) {
-		GsApp *app_tmp = g_ptr_array_index (apps, i);
-		AsAppState state_tmp = gs_app_get_state (app_tmp);
-		if (state_tmp == AS_APP_STATE_INSTALLING ||
-		    state_tmp == AS_APP_STATE_REMOVING ||
-		    state_tmp == AS_APP_STATE_PURCHASING) {
-			state = state_tmp;
-			break;
-		}
-	}
-	if (self->state != state) {
-		self->state = state;
-		g_object_notify (G_OBJECT (self), "state");
-	}
+	if (list->n_installing > 0)
+		return AS_APP_STATE_INSTALLING;
+	if (list->n_removing > 0)
+		return AS_APP_STATE_REMOVING;
+	if (list->n_purchasing > 0)
+		return AS_APP_STATE_PURCHASING;
+	return AS_APP_STATE_UNKNOWN;
 }
 
+static gboolean
+gs_app_list_notify_cb (gpointer user_data)
+{
+	GsAppList *list = GS_APP_LIST (user_data);
+	gboolean notify_state;
+	gboolean notify_progress;
+
+	g_mutex_lock (&list->mutex);
+	notify_state = list->notify_state;
+	notify_progress = list->notify_progress;
+	list->notify_state = FALSE;
+	list->notify_progress = FALSE;
+	list->notify_id = 0;
+	g_mutex_unlock (&list->mutex);
+
+	/* the handlers will read the values, so the mutex is not held */
+	if (notify_state)
+		g_object_notify (G_OBJECT (list), "state");
+	if (notify_progress)
+		g_object_notify (G_OBJECT (list), "progress");
+	return G_SOURCE_REMOVE;
+}
+
+/* called with the mutex held */
 static void
-gs_app_list_progress_notify_cb (GsApp *app, GParamSpec *pspec, GsAppList *self)
+gs_app_list_update_aggregates (GsAppList *list)
 {
-	gs_app_list_invalidate_progress (self);
+	AsAppState state = gs_app_list_totals_get_state (list);
+	guint progress = gs_app_list_totals_get_progress (list);
+
+	if (list->state != state) {
+		list->state = state;
+		list->notify_state = TRUE;
+	}
+	if (list->progress != progress) {
+		list->progress = progress;
+		list->notify_progress = TRUE;
+	}
+
+	/* coalesce the changes until the next frame */
+	if ((list->notify_state || list->notify_progress) && list->notify_id == 0) {
+		list->notify_id = g_timeout_add_full (G_PRIORITY_DEFAULT,
+						      GS_APP_LIST_NOTIFY_INTERVAL,
+						      gs_app_list_notify_cb,
+						      g_object_ref (list),
+						      (GDestroyNotify) g_object_unref);
+	}
 }
 
 static void
-gs_app_list_state_notify_cb (GsApp *app, GParamSpec *pspec, GsAppList *self)
+gs_app_list_app_notify_cb (GsApp *app, GParamSpec *pspec, GsAppList *self)
 {
-	gs_app_list_invalidate_state (self);
+	GsAppListWatch *watch;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+	/* replace what this app added to the totals */
+	watch = g_hash_table_lookup (self->watched, app);
+	if (watch == NULL)
+		return;
+	gs_app_list_totals_apply (self, watch, -1);
+	gs_app_list_watch_refresh (watch, app);
+	gs_app_list_totals_apply (self, watch, 1);
+	gs_app_list_update_aggregates (self);
 }
 
+/* called with the mutex held */
 static void
 gs_app_list_maybe_watch_app (GsAppList *list, GsApp *app)
 {
 	g_autoptr(GPtrArray) apps = gs_app_list_get_watched_for_app (list, app);
 	for (guint i = 0; i < apps->len; i++) {
 		GsApp *app_tmp = g_ptr_array_index (apps, i);
-		g_signal_connect_object (app_tmp, "notify::progress",
-					 G_CALLBACK (gs_app_list_progress_notify_cb),
-					 list, 0);
-		g_signal_connect_object (app_tmp, "notify::state",
-					 G_CALLBACK (gs_app_list_state_notify_cb),
-					 list, 0);
+		GsAppListWatch *watch = g_hash_table_lookup (list->watched, app_tmp);
+
+		/* the same app can be the addon of more than one app */
+		if (watch == NULL) {
+			watch = g_slice_new0 (GsAppListWatch);
+			g_hash_table_insert (list->watched, app_tmp, watch);
+			g_signal_connect_object (app_tmp, "notify::progress",
+						 G_CALLBACK (gs_app_list_app_notify_cb),
+						 list, 0);
+			g_signal_connect_object (app_tmp, "notify::state",
+						 G_CALLBACK (gs_app_list_app_notify_cb),
+						 list, 0);
+		} else {
+			gs_app_list_totals_apply (list, watch, -1);
+		}
+		watch->refcount++;
+		gs_app_list_watch_refresh (watch, app_tmp);
+		gs_app_list_totals_apply (list, watch, 1);
 	}
 }
 
+/* called with the mutex held */
 static void
 gs_app_list_maybe_unwatch_app (GsAppList *list, GsApp *app)
 {
 	g_autoptr(GPtrArray) apps = gs_app_list_get_watched_for_app (list, app);
 	for (guint i = 0; i < apps->len; i++) {
 		GsApp *app_tmp = g_ptr_array_index (apps, i);
+		GsAppListWatch *watch = g_hash_table_lookup (list->watched, app_tmp);
+		if (watch == NULL)
+			continue;
+		gs_app_list_totals_apply (list, watch, -1);
+		if (--watch->refcount > 0) {
+			gs_app_list_totals_apply (list, watch, 1);
+			continue;
+		}
 		g_signal_handlers_disconnect_by_data (app_tmp, list);
+		g_hash_table_remove (list->watched, app_tmp);
 	}
 }
 
@@ -286,15 +408,23 @@ gs_app_list_has_flag (GsAppList *list, GsAppListFlags flag)
 void
 gs_app_list_add_flag (GsAppList *list, GsAppListFlags flag)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
+
 	if (list->flags & flag)
 		return;
-	list->flags |= flag;
 
-	/* turn this on for existing apps */
+	/* turn this on for existing apps, without watching any twice */
+	locker = g_mutex_locker_new (&list->mutex);
+	for (guint i = 0; i < list->array->len; i++) {
+		GsApp *app = g_ptr_array_index (list->array, i);
+		gs_app_list_maybe_unwatch_app (list, app);
+	}
+	list->flags |= flag;
 	for (guint i = 0; i < list->array->len; i++) {
 		GsApp *app = g_ptr_array_index (list->array, i);
 		gs_app_list_maybe_watch_app (list, app);
 	}
+	gs_app_list_update_aggregates (list);
 }
 
 static gboolean
@@ -409,8 +539,7 @@ gs_app_list_add (GsAppList *list, GsApp *app)
 	gs_app_list_add_safe (list, app, GS_APP_LIST_ADD_FLAG_CHECK_FOR_DUPE);
 
 	/* recalculate global state */
-	gs_app_list_invalidate_state (list);
-	gs_app_list_invalidate_progress (list);
+	gs_app_list_update_aggregates (list);
 }
 
 /**
@@ -450,8 +579,7 @@ gs_app_list_remove (GsAppList *list, GsApp *app)
 	}
 
 	/* recalculate global state */
-	gs_app_list_invalidate_state (list);
-	gs_app_list_invalidate_progress (list);
+	gs_app_list_update_aggregates (list);
 }
 
 /**
@@ -482,8 +610,7 @@ gs_app_list_add_list (GsAppList *list, GsAppList *donor)
 	}
 
 	/* recalculate global state */
-	gs_app_list_invalidate_state (list);
-	gs_app_list_invalidate_progress (list);
+	gs_app_list_update_aggregates (list);
 }
 
 /**
@@ -529,8 +656,6 @@ gs_app_list_remove_all_safe (GsAppList *list)
 	}
 	g_ptr_array_set_size (list->array, 0);
 	g_hash_table_remove_all (list->hash_by_id);
-	gs_app_list_invalidate_state (list);
-	gs_app_list_invalidate_progress (list);
 }
 
 /**
@@ -548,6 +673,7 @@ gs_app_list_remove_all (GsAppList *list)
 	g_return_if_fail (GS_IS_APP_LIST (list));
 	locker = g_mutex_locker_new (&list->mutex);
 	gs_app_list_remove_all_safe (list);
+	gs_app_list_update_aggregates (list);
 }
 
 /**
@@ -583,6 +709,9 @@ gs_app_list_filter (GsAppList *list, GsAppListFilterFunc func, gpointer user_dat
 		if (func (app, user_data))
 			gs_app_list_add_safe (list, app, GS_APP_LIST_ADD_FLAG_NONE);
 	}
+
+	/* recalculate global state */
+	gs_app_list_update_aggregates (list);
 }
 
 typedef struct {
@@ -596,7 +725,7 @@ gs_app_list_sort_cb (gconstpointer a, gconstpointer b, gpointer user_data)
 	GsApp *app1 = GS_APP (*(GsApp **) a);
 	GsApp *app2 = GS_APP (*(GsApp **) b);
 	GsAppListSortHelper *helper = (GsAppListSortHelper *) user_data;
-	return helper->func (app1, app2, user_data);
+	return helper->func (app1, app2, helper->user_data);
 }
 
 /**
@@ -621,6 +750,146 @@ gs_app_list_sort (GsAppList *list, GsAppListSortFunc func, gpointer user_data)
 	g_ptr_array_sort_with_data (list->array, gs_app_list_sort_cb, &helper);
 }
 
+typedef struct {
+	GsAppListSortFunc	 func;
+	gpointer		 user_data;
+	GPtrArray		*array;
+} GsAppListTopHelper;
+
+/* compares positions in the array, using the position to break ties so that
+ * the result is the same as for a stable sort */
+static gint
+gs_app_list_top_cmp (GsAppListTopHelper *helper, guint idx1, guint idx2)
+{
+	GsApp *app1 = g_ptr_array_index (helper->array, idx1);
+	GsApp *app2 = g_ptr_array_index (helper->array, idx2);
+	gint rc = helper->func (app1, app2, helper->user_data);
+	if (rc != 0)
+		return rc;
+	if (idx1 < idx2)
+		return -1;
+	if (idx1 > idx2)
+		return 1;
+	return 0;
+}
+
+static gint
+gs_app_list_top_sort_cb (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	return gs_app_list_top_cmp ((GsAppListTopHelper *) user_data,
+				    *((const guint *) a),
+				    *((const guint *) b));
+}
+
+/* the heap root is the app that would sort last */
+static void
+gs_app_list_top_sift_down (GsAppListTopHelper *helper, guint *heap, guint len, guint i)
+{
+	for (;;) {
+		guint largest = i;
+		guint left = 2 * i + 1;
+		guint right = 2 * i + 2;
+		guint tmp;
+		if (left < len && gs_app_list_top_cmp (helper, heap[left], heap[largest]) > 0)
+			largest = left;
+		if (right < len && gs_app_list_top_cmp (helper, heap[right], heap[largest]) > 0)
+			largest = right;
+		if (largest == i)
+			return;
+		tmp = heap[i];
+		heap[i] = heap[largest];
+		heap[largest] = tmp;
+		i = largest;
+	}
+}
+
+/**
+ * gs_app_list_sort_truncate:
+ * @list: A #GsAppList
+ * @length: the number of applications to keep
+ * @func: A #GsAppListSortFunc
+ * @user_data: user data to pass to @func
+ *
+ * Sorts the application list and truncates it to @length, in the same way as
+ * gs_app_list_sort() followed by gs_app_list_truncate(). Only the applications
+ * that are kept are sorted, so this is much faster when @length is small.
+ *
+ * Since: 3.32
+ **/
+void
+gs_app_list_sort_truncate (GsAppList *list,
+			   guint length,
+			   GsAppListSortFunc func,
+			   gpointer user_data)
+{
+	GsAppListTopHelper helper;
+	GPtrArray *array_new;
+	g_autofree guint *heap = NULL;
+	g_autofree gboolean *kept = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_APP_LIST (list));
+	g_return_if_fail (func != NULL);
+
+	/* nothing to remove */
+	if (length >= list->array->len) {
+		gs_app_list_sort (list, func, user_data);
+		return;
+	}
+
+	/* everything */
+	if (length == 0) {
+		gs_app_list_truncate (list, 0);
+		return;
+	}
+
+	locker = g_mutex_locker_new (&list->mutex);
+	helper.func = func;
+	helper.user_data = user_data;
+	helper.array = list->array;
+
+	/* keep the best @length in a heap, replacing the worst one when a
+	 * better app is found */
+	heap = g_new (guint, length);
+	for (guint i = 0; i < length; i++)
+		heap[i] = i;
+	for (guint i = length / 2; i > 0; i--)
+		gs_app_list_top_sift_down (&helper, heap, length, i - 1);
+	for (guint i = length; i < list->array->len; i++) {
+		if (gs_app_list_top_cmp (&helper, i, heap[0]) >= 0)
+			continue;
+		heap[0] = i;
+		gs_app_list_top_sift_down (&helper, heap, length, 0);
+	}
+	g_qsort_with_data (heap, (gint) length, sizeof(guint),
+			   gs_app_list_top_sort_cb, &helper);
+
+	/* the apps are only unreffed when the old array is freed */
+	kept = g_new0 (gboolean, list->array->len);
+	array_new = g_ptr_array_new_full (length, (GDestroyNotify) g_object_unref);
+	for (guint i = 0; i < length; i++) {
+		GsApp *app = g_ptr_array_index (list->array, heap[i]);
+		g_ptr_array_add (array_new, g_object_ref (app));
+		kept[heap[i]] = TRUE;
+	}
+	for (guint i = 0; i < list->array->len; i++) {
+		GsApp *app = g_ptr_array_index (list->array, i);
+		const gchar *unique_id;
+		if (kept[i])
+			continue;
+		gs_app_list_maybe_unwatch_app (list, app);
+		unique_id = gs_app_get_unique_id (app);
+		if (unique_id != NULL)
+			g_hash_table_remove (list->hash_by_id, unique_id);
+	}
+	g_ptr_array_unref (list->array);
+	list->array = array_new;
+	gs_app_list_update_aggregates (list);
+
+	/* mark this list as unworthy */
+	list->flags |= GS_APP_LIST_FLAG_IS_TRUNCATED;
+}
+
 /**
  * gs_app_list_truncate:
  * @list: A #GsAppList
@@ -653,6 +922,7 @@ gs_app_list_truncate (GsAppList *list, guint length)
 	for (guint i = length; i < list->array->len; i++) {
 		GsApp *app = g_ptr_array_index (list->array, i);
 		const gchar *unique_id;
+		gs_app_list_maybe_unwatch_app (list, app);
 		unique_id = gs_app_get_unique_id (app);
 		if (unique_id != NULL) {
 			GsApp *app_tmp = g_hash_table_lookup (list->hash_by_id, unique_id);
@@ -662,6 +932,38 @@ gs_app_list_truncate (GsAppList *list, guint length)
 
 	}
 	g_ptr_array_set_size (list->array, length);
+	gs_app_list_update_aggregates (list);
+}
+
+/**
+ * gs_app_list_skip:
+ * @list: A #GsAppList
+ * @offset: the number of applications to remove
+ *
+ * Removes the first @offset applications from the list, for instance when
+ * returning a later page of a sorted result. It is not an error if @offset is
+ * larger than the size of the list.
+ *
+ * Since: 3.32
+ **/
+void
+gs_app_list_skip (GsAppList *list, guint offset)
+{
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_APP_LIST (list));
+
+	locker = g_mutex_locker_new (&list->mutex);
+	offset = MIN (offset, list->array->len);
+	for (guint i = 0; i < offset; i++) {
+		GsApp *app = g_ptr_array_index (list->array, i);
+		const gchar *unique_id = gs_app_get_unique_id (app);
+		gs_app_list_maybe_unwatch_app (list, app);
+		if (unique_id != NULL)
+			g_hash_table_remove (list->hash_by_id, unique_id);
+	}
+	g_ptr_array_remove_range (list->array, 0, offset);
+	gs_app_list_update_aggregates (list);
 }
 
 static gint
@@ -869,6 +1171,9 @@ gs_app_list_filter_duplicates (GsAppList *list, GsAppListFilterFlags flags)
 		if (g_hash_table_contains (kept_apps, app))
 			gs_app_list_add_safe (list, app, GS_APP_LIST_ADD_FLAG_NONE);
 	}
+
+	/* recalculate global state */
+	gs_app_list_update_aggregates (list);
 }
 
 /**
@@ -903,10 +1208,10 @@ gs_app_list_get_property (GObject *object, guint prop_id, GValue *value, GParamS
 	GsAppList *self = GS_APP_LIST (object);
 	switch (prop_id) {
 	case PROP_STATE:
-		g_value_set_uint (value, self->state);
+		g_value_set_uint (value, gs_app_list_get_state (self));
 		break;
 	case PROP_PROGRESS:
-		g_value_set_uint (value, self->progress);
+		g_value_set_uint (value, gs_app_list_get_progress (self));
 		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -930,6 +1235,7 @@ gs_app_list_finalize (GObject *object)
 	GsAppList *list = GS_APP_LIST (object);
 	g_ptr_array_unref (list->array);
 	g_hash_table_unref (list->hash_by_id);
+	g_hash_table_unref (list->watched);
 	g_mutex_clear (&list->mutex);
 	G_OBJECT_CLASS (gs_app_list_parent_class)->finalize (object);
 }
@@ -970,6 +1276,8 @@ gs_app_list_init (GsAppList *list)
 						  (GEqualFunc) as_utils_unique_id_equal,
 						  g_free,
 						  (GDestroyNotify) g_object_unref);
+	list->watched = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+					       NULL, gs_app_list_watch_free);
 }
 
 /**
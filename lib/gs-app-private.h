@@ -40,6 +40,8 @@ void		 gs_app_set_pending_action	(GsApp		*app,
 						 GsPluginAction	 action);
 gint		 gs_app_compare_priority	(GsApp		*app1,
 						 GsApp		*app2);
+gsize		 gs_app_get_size_retained	(GsApp		*app);
+GVariant	*gs_app_get_memory_stats	(guint		 n_largest);
 
 G_END_DECLS
 
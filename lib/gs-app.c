@@ -55,6 +55,7 @@
 #include "gs-app-private.h"
 #include "gs-os-release.h"
 #include "gs-plugin.h"
+#include "gs-trace.h"
 #include "gs-utils.h"
 
 typedef struct
@@ -67,6 +68,7 @@ typedef struct
 	gboolean		 unique_id_valid;
 	gchar			*branch;
 	gchar			*name;
+	gchar			*name_sort_key;
 	GsAppQuality		 name_quality;
 	GPtrArray		*icons;
 	GPtrArray		*sources;
@@ -150,6 +152,11 @@ enum {
 
 G_DEFINE_TYPE_WITH_PRIVATE (GsApp, gs_app, G_TYPE_OBJECT)
 
+/* every GsApp that is alive, so that the memory use can be looked at */
+G_LOCK_DEFINE_STATIC (live_apps);
+static GHashTable *live_apps = NULL;
+static guint live_apps_peak = 0;
+
 static gboolean
 _g_set_str (gchar **str_ptr, const gchar *new_str)
 {
@@ -892,6 +899,7 @@ gs_app_set_state_recover (GsApp *app)
 	gs_app_set_progress (app, 0);
 
 	priv->state = priv->state_recover;
+	gs_trace_record (GS_TRACE_KIND_STATE, gs_app_get_unique_id (app), priv->state);
 	gs_app_queue_notify (app, "state");
 }
 
@@ -1013,6 +1021,8 @@ gs_app_set_state_internal (GsApp *app, AsAppState state)
 	}
 
 	priv->state = state;
+	gs_trace_record (GS_TRACE_KIND_STATE,
+			 gs_app_get_unique_id_unlocked (app), state);
 
 	if (state == AS_APP_STATE_UNKNOWN ||
 	    state == AS_APP_STATE_AVAILABLE_LOCAL ||
@@ -1062,6 +1072,8 @@ gs_app_set_progress (GsApp *app, guint percentage)
 		percentage = 100;
 	}
 	priv->progress = percentage;
+	gs_trace_record (GS_TRACE_KIND_PROGRESS,
+			 gs_app_get_unique_id_unlocked (app), percentage);
 	gs_app_queue_notify (app, "progress");
 }
 
@@ -1098,6 +1110,8 @@ gs_app_set_pending_action_internal (GsApp *app,
 		return;
 
 	priv->pending_action = action;
+	gs_trace_record (GS_TRACE_KIND_PENDING_ACTION,
+			 gs_app_get_unique_id_unlocked (app), action);
 	gs_app_queue_notify (app, "pending-action");
 }
 
@@ -1330,8 +1344,37 @@ gs_app_set_name (GsApp *app, GsAppQuality quality, const gchar *name)
 	if (quality <= priv->name_quality)
 		return;
 	priv->name_quality = quality;
-	if (_g_set_str (&priv->name, name))
+	if (_g_set_str (&priv->name, name)) {
+		g_clear_pointer (&priv->name_sort_key, g_free);
 		g_object_notify (G_OBJECT (app), "name");
+	}
+}
+
+/**
+ * gs_app_get_name_sort_key:
+ * @app: a #GsApp
+ *
+ * Gets a collation key for the application name, suitable for sorting
+ * with strcmp(). The key is case-insensitive, and is only recalculated
+ * when the name changes.
+ *
+ * Returns: a string, or %NULL for unset
+ *
+ * Since: 3.32
+ **/
+const gchar *
+gs_app_get_name_sort_key (GsApp *app)
+{
+	GsAppPrivate *priv = gs_app_get_instance_private (app);
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_val_if_fail (GS_IS_APP (app), NULL);
+
+	locker = g_mutex_locker_new (&priv->mutex);
+	if (priv->name_sort_key == NULL && priv->name != NULL) {
+		g_autofree gchar *casefolded = g_utf8_casefold (priv->name, -1);
+		priv->name_sort_key = g_utf8_collate_key (casefolded, -1);
+	}
+	return priv->name_sort_key;
 }
 
 /**
@@ -4032,6 +4075,281 @@ gs_app_set_pending_action (GsApp *app,
 	gs_app_set_pending_action_internal (app, action);
 }
 
+static gsize
+gs_app_strsize (const gchar *str)
+{
+	return str != NULL ? strlen (str) + 1 : 0;
+}
+
+static gsize
+gs_app_strv_size (GPtrArray *array)
+{
+	gsize sz = 0;
+	if (array == NULL)
+		return 0;
+	for (guint i = 0; i < array->len; i++)
+		sz += sizeof(gpointer) + gs_app_strsize (g_ptr_array_index (array, i));
+	return sz;
+}
+
+static gsize
+gs_app_str_hash_size (GHashTable *hash)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	gsize sz = 0;
+	if (hash == NULL)
+		return 0;
+	g_hash_table_iter_init (&iter, hash);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		sz += 3 * sizeof(gpointer) + gs_app_strsize (key) + gs_app_strsize (value);
+	return sz;
+}
+
+static gsize
+gs_app_pixbuf_size (GdkPixbuf *pixbuf)
+{
+	if (pixbuf == NULL)
+		return 0;
+	return sizeof(GObject) + gdk_pixbuf_get_byte_length (pixbuf);
+}
+
+/**
+ * gs_app_get_size_retained:
+ * @app: a #GsApp
+ *
+ * Gets roughly how much memory the application is keeping alive, including
+ * the strings, icons and screenshots, and any pixbufs that have been loaded.
+ * The addons, related and history applications are not included as they are
+ * counted by themselves.
+ *
+ * Returns: a size in bytes
+ *
+ * Since: 3.32
+ **/
+gsize
+gs_app_get_size_retained (GsApp *app)
+{
+	GsAppPrivate *priv = gs_app_get_instance_private (app);
+	GHashTableIter iter;
+	gpointer key, value;
+	gsize sz = sizeof(GsApp) + sizeof(GsAppPrivate);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail (GS_IS_APP (app), 0);
+
+	locker = g_mutex_locker_new (&priv->mutex);
+
+	/* strings */
+	sz += gs_app_strsize (priv->id);
+	sz += gs_app_strsize (priv->unique_id);
+	sz += gs_app_strsize (priv->branch);
+	sz += gs_app_strsize (priv->name);
+	sz += gs_app_strsize (priv->name_sort_key);
+	sz += gs_app_strsize (priv->project_group);
+	sz += gs_app_strsize (priv->developer_name);
+	sz += gs_app_strsize (priv->agreement);
+	sz += gs_app_strsize (priv->version);
+	sz += gs_app_strsize (priv->version_ui);
+	sz += gs_app_strsize (priv->summary);
+	sz += gs_app_strsize (priv->summary_missing);
+	sz += gs_app_strsize (priv->description);
+	sz += gs_app_strsize (priv->license);
+	sz += gs_app_strsize (priv->origin);
+	sz += gs_app_strsize (priv->origin_appstream);
+	sz += gs_app_strsize (priv->origin_hostname);
+	sz += gs_app_strsize (priv->update_version);
+	sz += gs_app_strsize (priv->update_version_ui);
+	sz += gs_app_strsize (priv->update_details);
+	sz += gs_app_strsize (priv->management_plugin);
+	for (guint i = 0; priv->menu_path != NULL && priv->menu_path[i] != NULL; i++)
+		sz += sizeof(gpointer) + gs_app_strsize (priv->menu_path[i]);
+	sz += gs_app_strv_size (priv->sources);
+	sz += gs_app_strv_size (priv->source_ids);
+	sz += gs_app_strv_size (priv->categories);
+	sz += gs_app_str_hash_size (priv->urls);
+	sz += gs_app_str_hash_size (priv->launchables);
+	if (priv->metadata != NULL) {
+		g_hash_table_iter_init (&iter, priv->metadata);
+		while (g_hash_table_iter_next (&iter, &key, &value)) {
+			sz += 3 * sizeof(gpointer) + gs_app_strsize (key);
+			sz += g_variant_get_size (value);
+		}
+	}
+
+	/* images, which are by far the largest when loaded */
+	sz += gs_app_pixbuf_size (priv->pixbuf);
+	for (guint i = 0; priv->icons != NULL && i < priv->icons->len; i++) {
+		AsIcon *ic = g_ptr_array_index (priv->icons, i);
+		sz += sizeof(GObject) + gs_app_strsize (as_icon_get_name (ic));
+		sz += gs_app_strsize (as_icon_get_url (ic));
+		sz += gs_app_pixbuf_size (as_icon_get_pixbuf (ic));
+	}
+	for (guint i = 0; priv->screenshots != NULL && i < priv->screenshots->len; i++) {
+		AsScreenshot *ss = g_ptr_array_index (priv->screenshots, i);
+		GPtrArray *images = as_screenshot_get_images (ss);
+		sz += sizeof(GObject) + gs_app_strsize (as_screenshot_get_caption (ss, NULL));
+		for (guint j = 0; j < images->len; j++) {
+			AsImage *im = g_ptr_array_index (images, j);
+			sz += sizeof(GObject) + gs_app_strsize (as_image_get_url (im));
+			sz += gs_app_pixbuf_size (as_image_get_pixbuf (im));
+		}
+	}
+
+	/* everything else */
+	for (guint i = 0; priv->reviews != NULL && i < priv->reviews->len; i++) {
+		AsReview *review = g_ptr_array_index (priv->reviews, i);
+		sz += sizeof(GObject) + gs_app_strsize (as_review_get_summary (review));
+		sz += gs_app_strsize (as_review_get_description (review));
+	}
+	if (priv->provides != NULL)
+		sz += priv->provides->len * (sizeof(GObject) + 2 * sizeof(gpointer));
+	if (priv->key_colors != NULL)
+		sz += priv->key_colors->len * (sizeof(gpointer) + sizeof(GdkRGBA));
+	if (priv->review_ratings != NULL)
+		sz += priv->review_ratings->len * sizeof(guint32);
+	if (priv->addons != NULL)
+		sz += gs_app_list_length (priv->addons) * sizeof(gpointer);
+	if (priv->related != NULL)
+		sz += gs_app_list_length (priv->related) * sizeof(gpointer);
+	if (priv->history != NULL)
+		sz += gs_app_list_length (priv->history) * sizeof(gpointer);
+	return sz;
+}
+
+typedef struct {
+	gchar		*unique_id;
+	gsize		 size;
+} GsAppRetainer;
+
+static gint
+gs_app_retainer_sort_cb (gconstpointer a, gconstpointer b)
+{
+	const GsAppRetainer *r1 = a;
+	const GsAppRetainer *r2 = b;
+	if (r1->size > r2->size)
+		return -1;
+	if (r1->size < r2->size)
+		return 1;
+	return 0;
+}
+
+typedef struct {
+	gchar		*plugin;
+	AsAppKind	 kind;
+	guint		 n_apps;
+	guint64		 size;
+} GsAppMemoryGroup;
+
+static void
+gs_app_memory_group_free (GsAppMemoryGroup *group)
+{
+	g_free (group->plugin);
+	g_slice_free (GsAppMemoryGroup, group);
+}
+
+/**
+ * gs_app_get_memory_stats:
+ * @n_largest: how many of the largest applications to include
+ *
+ * Gets how many #GsApp objects are alive, and roughly how much memory they
+ * are keeping alive, as counted by gs_app_get_size_retained().
+ *
+ * Returns: (transfer floating): a #GVariant of type `a{sv}` with `apps` and
+ * `apps-peak` of type `u`, `size` of type `t`, `groups` of type `a(ssut)`
+ * with the management plugin, kind, number of applications and size, and
+ * `largest` of type `a(st)` with the unique ID and size
+ *
+ * Since: 3.32
+ **/
+GVariant *
+gs_app_get_memory_stats (guint n_largest)
+{
+	GHashTableIter iter;
+	GVariantBuilder builder;
+	GVariantBuilder builder_groups;
+	GVariantBuilder builder_largest;
+	GsAppMemoryGroup *group;
+	guint apps_peak;
+	guint64 size_total = 0;
+	g_autoptr(GArray) retainers = NULL;
+	g_autoptr(GHashTable) groups = NULL;
+	g_autoptr(GPtrArray) apps = g_ptr_array_new_with_free_func (g_object_unref);
+
+	/* only hold the lock long enough to keep them all alive */
+	G_LOCK (live_apps);
+	if (live_apps != NULL) {
+		gpointer key;
+		g_hash_table_iter_init (&iter, live_apps);
+		while (g_hash_table_iter_next (&iter, &key, NULL))
+			g_ptr_array_add (apps, g_object_ref (key));
+	}
+	apps_peak = live_apps_peak;
+	G_UNLOCK (live_apps);
+
+	groups = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+					(GDestroyNotify) gs_app_memory_group_free);
+	retainers = g_array_sized_new (FALSE, FALSE, sizeof(GsAppRetainer), apps->len);
+	for (guint i = 0; i < apps->len; i++) {
+		GsApp *app = g_ptr_array_index (apps, i);
+		const gchar *plugin = gs_app_get_management_plugin (app);
+		AsAppKind kind = gs_app_get_kind (app);
+		GsAppRetainer retainer;
+		g_autofree gchar *key = NULL;
+
+		retainer.size = gs_app_get_size_retained (app);
+		retainer.unique_id = g_strdup (gs_app_get_unique_id (app));
+		g_array_append_val (retainers, retainer);
+		size_total += retainer.size;
+
+		key = g_strdup_printf ("%s:%u", plugin != NULL ? plugin : "", kind);
+		group = g_hash_table_lookup (groups, key);
+		if (group == NULL) {
+			group = g_slice_new0 (GsAppMemoryGroup);
+			group->plugin = g_strdup (plugin != NULL ? plugin : "");
+			group->kind = kind;
+			g_hash_table_insert (groups, g_steal_pointer (&key), group);
+		}
+		group->n_apps++;
+		group->size += retainer.size;
+	}
+
+	g_variant_builder_init (&builder_groups, G_VARIANT_TYPE ("a(ssut)"));
+	g_hash_table_iter_init (&iter, groups);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &group)) {
+		g_variant_builder_add (&builder_groups, "(ssut)",
+				       group->plugin,
+				       as_app_kind_to_string (group->kind),
+				       group->n_apps,
+				       group->size);
+	}
+
+	g_array_sort (retainers, gs_app_retainer_sort_cb);
+	g_variant_builder_init (&builder_largest, G_VARIANT_TYPE ("a(st)"));
+	for (guint i = 0; i < retainers->len; i++) {
+		GsAppRetainer *retainer = &g_array_index (retainers, GsAppRetainer, i);
+		if (i < n_largest) {
+			g_variant_builder_add (&builder_largest, "(st)",
+					       retainer->unique_id != NULL ? retainer->unique_id : "",
+					       (guint64) retainer->size);
+		}
+		g_free (retainer->unique_id);
+	}
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add (&builder, "{sv}", "apps",
+			       g_variant_new_uint32 (apps->len));
+	g_variant_builder_add (&builder, "{sv}", "apps-peak",
+			       g_variant_new_uint32 (apps_peak));
+	g_variant_builder_add (&builder, "{sv}", "size",
+			       g_variant_new_uint64 (size_total));
+	g_variant_builder_add (&builder, "{sv}", "groups",
+			       g_variant_builder_end (&builder_groups));
+	g_variant_builder_add (&builder, "{sv}", "largest",
+			       g_variant_builder_end (&builder_largest));
+	return g_variant_builder_end (&builder);
+}
+
 static void
 gs_app_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -4142,6 +4460,14 @@ gs_app_dispose (GObject *object)
 	GsApp *app = GS_APP (object);
 	GsAppPrivate *priv = gs_app_get_instance_private (app);
 
+	/* before anything is cleared */
+	G_LOCK (live_apps);
+	g_hash_table_remove (live_apps, app);
+	G_UNLOCK (live_apps);
+
+	/* gs_app_get_memory_stats() may have taken a ref just before the app
+	 * was removed, and is reading these from another thread */
+	g_mutex_lock (&priv->mutex);
 	g_clear_object (&priv->runtime);
 
 	g_clear_pointer (&priv->addons, g_object_unref);
@@ -4152,6 +4478,7 @@ gs_app_dispose (GObject *object)
 	g_clear_pointer (&priv->reviews, g_ptr_array_unref);
 	g_clear_pointer (&priv->provides, g_ptr_array_unref);
 	g_clear_pointer (&priv->icons, g_ptr_array_unref);
+	g_mutex_unlock (&priv->mutex);
 
 	G_OBJECT_CLASS (gs_app_parent_class)->dispose (object);
 }
@@ -4167,6 +4494,7 @@ gs_app_finalize (GObject *object)
 	g_free (priv->unique_id);
 	g_free (priv->branch);
 	g_free (priv->name);
+	g_free (priv->name_sort_key);
 	g_hash_table_unref (priv->urls);
 	g_hash_table_unref (priv->launchables);
 	g_free (priv->license);
@@ -4351,6 +4679,13 @@ gs_app_init (GsApp *app)
 	                                           g_free);
 	priv->allow_cancel = TRUE;
 	g_mutex_init (&priv->mutex);
+
+	G_LOCK (live_apps);
+	if (live_apps == NULL)
+		live_apps = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_hash_table_add (live_apps, app);
+	live_apps_peak = MAX (live_apps_peak, g_hash_table_size (live_apps));
+	G_UNLOCK (live_apps);
 }
 
 /**
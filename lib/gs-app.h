@@ -179,6 +179,7 @@ const gchar	*gs_app_get_name		(GsApp		*app);
 void		 gs_app_set_name		(GsApp		*app,
 						 GsAppQuality	 quality,
 						 const gchar	*name);
+const gchar	*gs_app_get_name_sort_key	(GsApp		*app);
 const gchar	*gs_app_get_source_default	(GsApp		*app);
 void		 gs_app_add_source		(GsApp		*app,
 						 const gchar	*source);
@@ -91,6 +91,32 @@ gs_cmd_show_results_categories (GPtrArray *list)
 	}
 }
 
+static void
+gs_cmd_show_stats (GsPluginLoader *plugin_loader)
+{
+	g_autoptr(GVariant) stats = NULL;
+	GVariantIter iter;
+	const gchar *plugin_name;
+	const gchar *action;
+	guint calls, errors, timeouts, apps;
+	guint64 p50, p95, p99;
+
+	stats = g_variant_ref_sink (gs_plugin_loader_get_stats (plugin_loader));
+	g_print ("%-24s %-24s %6s %6s %8s %6s %9s %9s %9s\n",
+		 "plugin", "action", "calls", "errors", "timeouts", "apps",
+		 "p50/ms", "p95/ms", "p99/ms");
+	g_variant_iter_init (&iter, stats);
+	while (g_variant_iter_next (&iter, "(&s&suuuuttt)", &plugin_name, &action,
+				    &calls, &errors, &timeouts, &apps,
+				    &p50, &p95, &p99)) {
+		g_print ("%-24s %-24s %6u %6u %8u %6u %9.1f %9.1f %9.1f\n",
+			 plugin_name, action, calls, errors, timeouts, apps,
+			 (gdouble) p50 / 1000.f,
+			 (gdouble) p95 / 1000.f,
+			 (gdouble) p99 / 1000.f);
+	}
+}
+
 static GsPluginRefineFlags
 gs_cmd_refine_flag_from_string (const gchar *flag, GError **error)
 {
@@ -298,6 +324,7 @@ main (int argc, char **argv)
 	gboolean prefer_local = FALSE;
 	gboolean ret;
 	gboolean show_results = FALSE;
+	gboolean show_stats = FALSE;
 	gboolean verbose = FALSE;
 	gint i;
 	guint cache_age = 0;
@@ -317,6 +344,8 @@ main (int argc, char **argv)
 	const GOptionEntry options[] = {
 		{ "show-results", '\0', 0, G_OPTION_ARG_NONE, &show_results,
 		  "Show the results for the action", NULL },
+		{ "stats", '\0', 0, G_OPTION_ARG_NONE, &show_stats,
+		  "Show how long each plugin took for the action", NULL },
 		{ "refine-flags", '\0', 0, G_OPTION_ARG_STRING, &refine_flags_str,
 		  "Set any refine flags required for the action", NULL },
 		{ "repeat", '\0', 0, G_OPTION_ARG_INT, &repeat,
@@ -697,6 +726,8 @@ main (int argc, char **argv)
 				     "'action install', 'action remove', "
 				     "'sources', 'refresh', 'launch' or 'search'");
 	}
+	if (show_stats)
+		gs_cmd_show_stats (self->plugin_loader);
 	if (!ret) {
 		g_print ("Failed: %s\n", error->message);
 		return EXIT_FAILURE;
@@ -35,6 +35,7 @@
 #include <linux/unistd.h>
 #endif
 
+#include <sys/resource.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
@@ -140,6 +141,30 @@ gs_ioprio_init (void)
 	}
 }
 
+/* the default best effort class, for work that the user is waiting on; this
+ * can be set again on a thread that was put in the idle class */
+void
+gs_ioprio_set_interactive (void)
+{
+	if (set_io_priority_best_effort (4) == -1)
+		g_message ("Could not set best effort IO priority");
+}
+
+/* the CPU priority of a thread can be lowered but not raised again without
+ * privileges, so only use this on threads that are never used for anything
+ * but background work */
+void
+gs_ioprio_set_background (void)
+{
+	pid_t tid = (pid_t) syscall (SYS_gettid);
+
+	gs_ioprio_init ();
+
+	/* on Linux this only affects the calling thread */
+	if (setpriority (PRIO_PROCESS, (id_t) tid, 19) == -1)
+		g_message ("Could not lower the CPU priority: %s", g_strerror (errno));
+}
+
 #else  /* __linux__ */
 
 void
@@ -147,4 +172,14 @@ gs_ioprio_init (void)
 {
 }
 
+void
+gs_ioprio_set_interactive (void)
+{
+}
+
+void
+gs_ioprio_set_background (void)
+{
+}
+
 #endif /* __linux__ */
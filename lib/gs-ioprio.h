@@ -26,6 +26,8 @@
 G_BEGIN_DECLS
 
 void gs_ioprio_init (void);
+void gs_ioprio_set_interactive (void);
+void gs_ioprio_set_background (void);
 
 G_END_DECLS
 
@@ -39,17 +39,27 @@ void			 gs_plugin_job_add_refine_flags		(GsPluginJob	*self,
 void			 gs_plugin_job_remove_refine_flags	(GsPluginJob	*self,
 								 GsPluginRefineFlags refine_flags);
 gboolean		 gs_plugin_job_get_interactive		(GsPluginJob	*self);
+gboolean		 gs_plugin_job_get_background		(GsPluginJob	*self);
+guint			 gs_plugin_job_get_id			(GsPluginJob	*self);
+void			 gs_plugin_job_add_download_bytes	(GsPluginJob	*self,
+								 guint64	 download_bytes);
+guint64			 gs_plugin_job_get_download_bytes	(GsPluginJob	*self);
 guint			 gs_plugin_job_get_max_results		(GsPluginJob	*self);
+guint			 gs_plugin_job_get_offset		(GsPluginJob	*self);
+gboolean		 gs_plugin_job_get_paged		(GsPluginJob	*self);
 guint			 gs_plugin_job_get_timeout		(GsPluginJob	*self);
 guint64			 gs_plugin_job_get_age			(GsPluginJob	*self);
 GsAppListSortFunc	 gs_plugin_job_get_sort_func		(GsPluginJob	*self);
 gpointer		 gs_plugin_job_get_sort_func_data	(GsPluginJob	*self);
+GsPluginJobPartialFunc	 gs_plugin_job_get_partial_func		(GsPluginJob	*self);
+gpointer		 gs_plugin_job_get_partial_func_data	(GsPluginJob	*self);
 const gchar		*gs_plugin_job_get_search		(GsPluginJob	*self);
 GsAuth			*gs_plugin_job_get_auth			(GsPluginJob	*self);
 GsApp			*gs_plugin_job_get_app			(GsPluginJob	*self);
 GsAppList		*gs_plugin_job_get_list			(GsPluginJob	*self);
 GFile			*gs_plugin_job_get_file			(GsPluginJob	*self);
 GsPlugin		*gs_plugin_job_get_plugin		(GsPluginJob	*self);
+GsPlugin		*gs_plugin_job_get_plugin_only		(GsPluginJob	*self);
 GsCategory		*gs_plugin_job_get_category		(GsPluginJob	*self);
 AsReview		*gs_plugin_job_get_review		(GsPluginJob	*self);
 GsPrice			*gs_plugin_job_get_price		(GsPluginJob	*self);
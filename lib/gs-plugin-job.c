@@ -34,13 +34,20 @@ struct _GsPluginJob
 	GsPluginRefineFlags	 filter_flags;
 	GsAppListFilterFlags	 dedupe_flags;
 	gboolean		 interactive;
+	gboolean		 background;
 	guint			 max_results;
+	guint			 offset;
+	gboolean		 paged;
 	guint			 timeout;
 	guint64			 age;
+	guint64			 download_bytes;
 	GsPlugin		*plugin;
+	GsPlugin		*plugin_only;
 	GsPluginAction		 action;
 	GsAppListSortFunc	 sort_func;
 	gpointer		 sort_func_data;
+	GsPluginJobPartialFunc	 partial_func;
+	gpointer		 partial_func_data;
 	gchar			*search;
 	GsAuth			*auth;
 	GsApp			*app;
@@ -50,6 +57,7 @@ struct _GsPluginJob
 	AsReview		*review;
 	GsPrice			*price;
 	gint64			 time_created;
+	guint			 id;
 };
 
 enum {
@@ -61,6 +69,7 @@ enum {
 	PROP_FILTER_FLAGS,
 	PROP_DEDUPE_FLAGS,
 	PROP_INTERACTIVE,
+	PROP_BACKGROUND,
 	PROP_AUTH,
 	PROP_APP,
 	PROP_LIST,
@@ -68,6 +77,7 @@ enum {
 	PROP_CATEGORY,
 	PROP_REVIEW,
 	PROP_MAX_RESULTS,
+	PROP_OFFSET,
 	PROP_PRICE,
 	PROP_TIMEOUT,
 	PROP_LAST
@@ -75,6 +85,8 @@ enum {
 
 G_DEFINE_TYPE (GsPluginJob, gs_plugin_job, G_TYPE_OBJECT)
 
+static gint gs_plugin_job_last_id = 0;	/* atomic */
+
 gchar *
 gs_plugin_job_to_string (GsPluginJob *self)
 {
@@ -94,10 +106,14 @@ gs_plugin_job_to_string (GsPluginJob *self)
 	}
 	if (self->interactive)
 		g_string_append_printf (str, " with interactive=True");
+	if (self->background)
+		g_string_append_printf (str, " with background=True");
 	if (self->timeout > 0)
 		g_string_append_printf (str, " with timeout=%u", self->timeout);
 	if (self->max_results > 0)
 		g_string_append_printf (str, " with max-results=%u", self->max_results);
+	if (self->offset > 0)
+		g_string_append_printf (str, " with offset=%u", self->offset);
 	if (self->age != 0) {
 		if (self->age == G_MAXUINT) {
 			g_string_append (str, " with cache age=any");
@@ -141,6 +157,10 @@ gs_plugin_job_to_string (GsPluginJob *self)
 		g_string_append_printf (str, " on plugin=%s",
 					gs_plugin_get_name (self->plugin));
 	}
+	if (self->plugin_only != NULL) {
+		g_string_append_printf (str, " only on plugin=%s",
+					gs_plugin_get_name (self->plugin_only));
+	}
 	if (self->list != NULL && gs_app_list_length (self->list) > 0) {
 		g_autofree const gchar **unique_ids = NULL;
 		g_autofree gchar *unique_ids_str = NULL;
@@ -236,6 +256,42 @@ gs_plugin_job_get_interactive (GsPluginJob *self)
 	return self->interactive;
 }
 
+/* only called from the thread running the job */
+void
+gs_plugin_job_add_download_bytes (GsPluginJob *self, guint64 download_bytes)
+{
+	g_return_if_fail (GS_IS_PLUGIN_JOB (self));
+	self->download_bytes += download_bytes;
+}
+
+guint64
+gs_plugin_job_get_download_bytes (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), 0);
+	return self->download_bytes;
+}
+
+void
+gs_plugin_job_set_background (GsPluginJob *self, gboolean background)
+{
+	g_return_if_fail (GS_IS_PLUGIN_JOB (self));
+	self->background = background;
+}
+
+gboolean
+gs_plugin_job_get_background (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), FALSE);
+	return self->background;
+}
+
+guint
+gs_plugin_job_get_id (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), 0);
+	return self->id;
+}
+
 void
 gs_plugin_job_set_max_results (GsPluginJob *self, guint max_results)
 {
@@ -250,6 +306,28 @@ gs_plugin_job_get_max_results (GsPluginJob *self)
 	return self->max_results;
 }
 
+void
+gs_plugin_job_set_offset (GsPluginJob *self, guint offset)
+{
+	g_return_if_fail (GS_IS_PLUGIN_JOB (self));
+	self->offset = offset;
+	self->paged = TRUE;
+}
+
+guint
+gs_plugin_job_get_offset (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), 0);
+	return self->offset;
+}
+
+gboolean
+gs_plugin_job_get_paged (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), FALSE);
+	return self->paged;
+}
+
 void
 gs_plugin_job_set_timeout (GsPluginJob *self, guint timeout)
 {
@@ -320,6 +398,30 @@ gs_plugin_job_get_sort_func_data (GsPluginJob *self)
 	return self->sort_func_data;
 }
 
+void
+gs_plugin_job_set_partial_func (GsPluginJob *self,
+				GsPluginJobPartialFunc partial_func,
+				gpointer partial_func_data)
+{
+	g_return_if_fail (GS_IS_PLUGIN_JOB (self));
+	self->partial_func = partial_func;
+	self->partial_func_data = partial_func_data;
+}
+
+GsPluginJobPartialFunc
+gs_plugin_job_get_partial_func (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), NULL);
+	return self->partial_func;
+}
+
+gpointer
+gs_plugin_job_get_partial_func_data (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), NULL);
+	return self->partial_func_data;
+}
+
 void
 gs_plugin_job_set_search (GsPluginJob *self, const gchar *search)
 {
@@ -411,6 +513,20 @@ gs_plugin_job_get_plugin (GsPluginJob *self)
 	return self->plugin;
 }
 
+void
+gs_plugin_job_set_plugin_only (GsPluginJob *self, GsPlugin *plugin_only)
+{
+	g_return_if_fail (GS_IS_PLUGIN_JOB (self));
+	g_set_object (&self->plugin_only, plugin_only);
+}
+
+GsPlugin *
+gs_plugin_job_get_plugin_only (GsPluginJob *self)
+{
+	g_return_val_if_fail (GS_IS_PLUGIN_JOB (self), NULL);
+	return self->plugin_only;
+}
+
 void
 gs_plugin_job_set_category (GsPluginJob *self, GsCategory *category)
 {
@@ -477,6 +593,9 @@ gs_plugin_job_get_property (GObject *obj, guint prop_id, GValue *value, GParamSp
 	case PROP_INTERACTIVE:
 		g_value_set_boolean (value, self->interactive);
 		break;
+	case PROP_BACKGROUND:
+		g_value_set_boolean (value, self->background);
+		break;
 	case PROP_SEARCH:
 		g_value_set_string (value, self->search);
 		break;
@@ -504,6 +623,9 @@ gs_plugin_job_get_property (GObject *obj, guint prop_id, GValue *value, GParamSp
 	case PROP_MAX_RESULTS:
 		g_value_set_uint (value, self->max_results);
 		break;
+	case PROP_OFFSET:
+		g_value_set_uint (value, self->offset);
+		break;
 	case PROP_TIMEOUT:
 		g_value_set_uint (value, self->timeout);
 		break;
@@ -537,6 +659,9 @@ gs_plugin_job_set_property (GObject *obj, guint prop_id, const GValue *value, GP
 	case PROP_INTERACTIVE:
 		gs_plugin_job_set_interactive (self, g_value_get_boolean (value));
 		break;
+	case PROP_BACKGROUND:
+		gs_plugin_job_set_background (self, g_value_get_boolean (value));
+		break;
 	case PROP_SEARCH:
 		gs_plugin_job_set_search (self, g_value_get_string (value));
 		break;
@@ -561,6 +686,9 @@ gs_plugin_job_set_property (GObject *obj, guint prop_id, const GValue *value, GP
 	case PROP_MAX_RESULTS:
 		gs_plugin_job_set_max_results (self, g_value_get_uint (value));
 		break;
+	case PROP_OFFSET:
+		gs_plugin_job_set_offset (self, g_value_get_uint (value));
+		break;
 	case PROP_TIMEOUT:
 		gs_plugin_job_set_timeout (self, g_value_get_uint (value));
 		break;
@@ -583,6 +711,7 @@ gs_plugin_job_finalize (GObject *obj)
 	g_clear_object (&self->list);
 	g_clear_object (&self->file);
 	g_clear_object (&self->plugin);
+	g_clear_object (&self->plugin_only);
 	g_clear_object (&self->category);
 	g_clear_object (&self->review);
 	g_clear_object (&self->price);
@@ -631,6 +760,11 @@ gs_plugin_job_class_init (GsPluginJobClass *klass)
 
 	g_object_class_install_property (object_class, PROP_INTERACTIVE, pspec);
 
+	pspec = g_param_spec_boolean ("background", NULL, NULL,
+				      FALSE,
+				      G_PARAM_READWRITE);
+	g_object_class_install_property (object_class, PROP_BACKGROUND, pspec);
+
 	pspec = g_param_spec_string ("search", NULL, NULL,
 				     NULL,
 				     G_PARAM_READWRITE);
@@ -671,6 +805,11 @@ gs_plugin_job_class_init (GsPluginJobClass *klass)
 				   G_PARAM_READWRITE);
 	g_object_class_install_property (object_class, PROP_MAX_RESULTS, pspec);
 
+	pspec = g_param_spec_uint ("offset", NULL, NULL,
+				   0, G_MAXUINT, 0,
+				   G_PARAM_READWRITE);
+	g_object_class_install_property (object_class, PROP_OFFSET, pspec);
+
 	pspec = g_param_spec_uint ("timeout", NULL, NULL,
 				   0, G_MAXUINT, 60,
 				   G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
@@ -692,6 +831,7 @@ gs_plugin_job_init (GsPluginJob *self)
 			     GS_APP_LIST_FILTER_FLAG_KEY_VERSION;
 	self->list = gs_app_list_new ();
 	self->time_created = g_get_monotonic_time ();
+	self->id = (guint) g_atomic_int_add (&gs_plugin_job_last_id, 1) + 1;
 }
 
 /* vim: set noexpandtab: */
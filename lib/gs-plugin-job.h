@@ -36,6 +36,10 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (GsPluginJob, gs_plugin_job, GS, PLUGIN_JOB, GObject)
 
+typedef void (*GsPluginJobPartialFunc)			(GsPluginJob	*plugin_job,
+							 GsAppList	*list,
+							 gpointer	 user_data);
+
 void		 gs_plugin_job_set_refine_flags		(GsPluginJob	*self,
 							 GsPluginRefineFlags refine_flags);
 void		 gs_plugin_job_set_filter_flags		(GsPluginJob	*self,
@@ -44,8 +48,12 @@ void		 gs_plugin_job_set_dedupe_flags		(GsPluginJob	*self,
 							 GsAppListFilterFlags dedupe_flags);
 void		 gs_plugin_job_set_interactive		(GsPluginJob	*self,
 							 gboolean	 interactive);
+void		 gs_plugin_job_set_background		(GsPluginJob	*self,
+							 gboolean	 background);
 void		 gs_plugin_job_set_max_results		(GsPluginJob	*self,
 							 guint		 max_results);
+void		 gs_plugin_job_set_offset		(GsPluginJob	*self,
+							 guint		 offset);
 void		 gs_plugin_job_set_timeout		(GsPluginJob	*self,
 							 guint		 timeout);
 void		 gs_plugin_job_set_age			(GsPluginJob	*self,
@@ -54,6 +62,9 @@ void		 gs_plugin_job_set_sort_func		(GsPluginJob	*self,
 							 GsAppListSortFunc sort_func);
 void		 gs_plugin_job_set_sort_func_data	(GsPluginJob	*self,
 							 gpointer	 sort_func_data);
+void		 gs_plugin_job_set_partial_func		(GsPluginJob	*self,
+							 GsPluginJobPartialFunc partial_func,
+							 gpointer	 partial_func_data);
 void		 gs_plugin_job_set_search		(GsPluginJob	*self,
 							 const gchar	*search);
 void		 gs_plugin_job_set_auth			(GsPluginJob	*self,
@@ -66,6 +77,8 @@ void		 gs_plugin_job_set_file			(GsPluginJob	*self,
 							 GFile		*file);
 void		 gs_plugin_job_set_plugin		(GsPluginJob	*self,
 							 GsPlugin	*plugin);
+void		 gs_plugin_job_set_plugin_only		(GsPluginJob	*self,
+							 GsPlugin	*plugin_only);
 void		 gs_plugin_job_set_category		(GsPluginJob	*self,
 							 GsCategory	*category);
 void		 gs_plugin_job_set_review		(GsPluginJob	*self,
@@ -37,6 +37,7 @@
 #include "gs-plugin-event.h"
 #include "gs-plugin-job-private.h"
 #include "gs-plugin-private.h"
+#include "gs-trace.h"
 #include "gs-utils.h"
 
 #define GS_PLUGIN_LOADER_UPDATES_CHANGED_DELAY	3	/* s */
@@ -57,6 +58,19 @@ typedef struct
 	GPtrArray		*pending_apps;
 
 	GThreadPool		*queued_ops_pool;
+	GThreadPool		*background_pool;
+
+	GMutex			 governor_mutex;
+	GCond			 governor_cond;
+	guint			 governor_interactive;	/* jobs in flight */
+	guint			 governor_background;	/* jobs in flight */
+	gboolean		 governor_paused;
+	guint			 governor_background_jobs;
+	gint64			 governor_background_wait;
+	guint			 governor_interactive_jobs;
+	gint64			 governor_interactive_time;
+	guint			 governor_contended_jobs;
+	gint64			 governor_contended_time;
 
 	GSettings		*settings;
 
@@ -73,11 +87,19 @@ typedef struct
 
 	GNetworkMonitor		*network_monitor;
 	gulong			 network_changed_handler;
+
+	GPtrArray		*batch_tasks;		/* of GTask, or NULL */
+	GMainContext		*batch_context;		/* or NULL */
+	GMutex			 batch_mutex;
+
+	GHashTable		*vfuncs;		/* function name : GArray of GsPluginLoaderVfunc */
+	GArray			*refine_vfuncs;		/* of GsPluginLoaderRefineVfuncs, or NULL */
 } GsPluginLoaderPrivate;
 
 static void gs_plugin_loader_monitor_network (GsPluginLoader *plugin_loader);
 static void add_app_to_install_queue (GsPluginLoader *plugin_loader, GsApp *app);
 static void gs_plugin_loader_process_in_thread_pool_cb (gpointer data, gpointer user_data);
+static void gs_plugin_loader_process_in_background_cb (gpointer data, gpointer user_data);
 
 G_DEFINE_TYPE_WITH_PRIVATE (GsPluginLoader, gs_plugin_loader, G_TYPE_OBJECT)
 
@@ -186,6 +208,33 @@ typedef gboolean	 (*GsPluginUpdateFunc)		(GsPlugin	*plugin,
 typedef void		 (*GsPluginAdoptAppFunc)	(GsPlugin	*plugin,
 							 GsApp		*app);
 
+/* an enabled plugin that implements a vfunc, resolved once after setup */
+typedef struct {
+	GsPlugin		*plugin;
+	gpointer		 func;
+} GsPluginLoaderVfunc;
+
+/* refine is called for every app, so keep its vfuncs together */
+typedef struct {
+	GsPlugin			*plugin;
+	GsPluginRefineFunc		 refine;
+	GsPluginRefineAppFunc		 refine_app;
+	GsPluginRefineWildcardFunc	 refine_wildcard;
+} GsPluginLoaderRefineVfuncs;
+
+/* the checks done on the results of each action, cheapest first */
+typedef enum {
+	GS_PLUGIN_LOADER_FILTER_NONE		= 0,
+	GS_PLUGIN_LOADER_FILTER_NON_COMPULSORY	= 1 << 0,
+	GS_PLUGIN_LOADER_FILTER_FEATURED_DEBUG	= 1 << 1,
+	GS_PLUGIN_LOADER_FILTER_VALID		= 1 << 2,
+	GS_PLUGIN_LOADER_FILTER_INSTALLED	= 1 << 3,
+	GS_PLUGIN_LOADER_FILTER_UPDATABLE	= 1 << 4,
+	GS_PLUGIN_LOADER_FILTER_QT_FOR_GTK	= 1 << 5,
+	GS_PLUGIN_LOADER_FILTER_COMPATIBLE	= 1 << 6,
+	GS_PLUGIN_LOADER_FILTER_LAST
+} GsPluginLoaderFilter;
+
 /* async helper */
 typedef struct {
 	GsPluginLoader			*plugin_loader;
@@ -200,6 +249,11 @@ typedef struct {
 	guint				 timeout_id;
 	gboolean			 timeout_triggered;
 	gchar				**tokens;
+	GMainContext			*context;
+	guint64				 download_bytes_start;	/* of the plugin being called */
+	GsPluginLoaderFilter		 filter;
+	gint64				 governor_begin;
+	gboolean			 governor_contended;
 } GsPluginLoaderHelper;
 
 static GsPluginLoaderHelper *
@@ -213,6 +267,72 @@ gs_plugin_loader_helper_new (GsPluginLoader *plugin_loader, GsPluginJob *plugin_
 	return helper;
 }
 
+/* how long a background job waits for interactive jobs before it starts, so
+ * that it cannot be starved by a busy user */
+#define GS_PLUGIN_LOADER_GOVERNOR_MAX_WAIT	(10 * G_USEC_PER_SEC)
+
+static void
+gs_plugin_loader_governor_job_begin (GsPluginLoaderHelper *helper)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (helper->plugin_loader);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (!gs_plugin_job_get_interactive (helper->plugin_job))
+		return;
+	locker = g_mutex_locker_new (&priv->governor_mutex);
+	priv->governor_interactive++;
+	helper->governor_begin = g_get_monotonic_time ();
+	helper->governor_contended = priv->governor_background > 0;
+}
+
+static void
+gs_plugin_loader_governor_job_end (GsPluginLoaderHelper *helper)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (helper->plugin_loader);
+	gint64 duration;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (helper->governor_begin == 0)
+		return;
+	duration = g_get_monotonic_time () - helper->governor_begin;
+	locker = g_mutex_locker_new (&priv->governor_mutex);
+	priv->governor_interactive--;
+	priv->governor_interactive_jobs++;
+	priv->governor_interactive_time += duration;
+	if (helper->governor_contended) {
+		priv->governor_contended_jobs++;
+		priv->governor_contended_time += duration;
+	}
+	g_cond_broadcast (&priv->governor_cond);
+}
+
+/* called before a background job starts; once started it runs to the end so
+ * that an update is never left half done when pausing */
+static void
+gs_plugin_loader_governor_wait (GsPluginLoader *plugin_loader,
+				GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	gint64 begin_time = g_get_monotonic_time ();
+	gint64 now = begin_time;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	locker = g_mutex_locker_new (&priv->governor_mutex);
+	while (!g_cancellable_is_cancelled (cancellable)) {
+		if (!priv->governor_paused &&
+		    (priv->governor_interactive == 0 ||
+		     now - begin_time >= GS_PLUGIN_LOADER_GOVERNOR_MAX_WAIT))
+			break;
+
+		/* wake up every second to notice being cancelled */
+		g_cond_wait_until (&priv->governor_cond,
+				   &priv->governor_mutex,
+				   g_get_monotonic_time () + G_USEC_PER_SEC);
+		now = g_get_monotonic_time ();
+	}
+	priv->governor_background_wait += now - begin_time;
+}
+
 static void
 reset_app_progress (GsApp *app)
 {
@@ -263,6 +383,7 @@ gs_plugin_loader_helper_free (GsPluginLoaderHelper *helper)
 		g_cancellable_disconnect (helper->cancellable_caller,
 					  helper->cancellable_id);
 	}
+	gs_plugin_loader_governor_job_end (helper);
 	g_object_unref (helper->plugin_loader);
 	if (helper->timeout_id != 0)
 		g_source_remove (helper->timeout_id);
@@ -274,6 +395,8 @@ gs_plugin_loader_helper_free (GsPluginLoaderHelper *helper)
 		g_object_unref (helper->cancellable_caller);
 	if (helper->catlist != NULL)
 		g_ptr_array_unref (helper->catlist);
+	if (helper->context != NULL)
+		g_main_context_unref (helper->context);
 	g_strfreev (helper->tokens);
 	g_slice_free (GsPluginLoaderHelper, helper);
 }
@@ -287,17 +410,23 @@ gs_plugin_loader_job_debug (GsPluginLoaderHelper *helper)
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GsPluginLoaderHelper, gs_plugin_loader_helper_free)
 
+static gint
+gs_plugin_loader_app_sort_id_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	return g_strcmp0 (gs_app_get_unique_id (app1),
+			  gs_app_get_unique_id (app2));
+}
+
 static gint
 gs_plugin_loader_app_sort_name_cb (GsApp *app1, GsApp *app2, gpointer user_data)
 {
-	g_autofree gchar *casefolded_name1 = NULL;
-	g_autofree gchar *casefolded_name2 = NULL;
+	gint rc = g_strcmp0 (gs_app_get_name_sort_key (app1),
+			     gs_app_get_name_sort_key (app2));
 
-	if (gs_app_get_name (app1) != NULL)
-		casefolded_name1 = g_utf8_casefold (gs_app_get_name (app1), -1);
-	if (gs_app_get_name (app2) != NULL)
-		casefolded_name2 = g_utf8_casefold (gs_app_get_name (app2), -1);
-	return g_strcmp0 (casefolded_name1, casefolded_name2);
+	/* keep the order stable so that results can be paged */
+	if (rc == 0)
+		return gs_plugin_loader_app_sort_id_cb (app1, app2, user_data);
+	return rc;
 }
 
 GsPlugin *
@@ -314,6 +443,98 @@ gs_plugin_loader_find_plugin (GsPluginLoader *plugin_loader,
 	return NULL;
 }
 
+/* the enabled plugins that implement @function_name, in plugin order */
+static GArray *
+gs_plugin_loader_get_vfuncs (GsPluginLoader *plugin_loader,
+			     const gchar *function_name)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GArray *vfuncs;
+
+	/* resolved when the plugins were set up */
+	vfuncs = g_hash_table_lookup (priv->vfuncs, function_name);
+	if (vfuncs != NULL)
+		return g_array_ref (vfuncs);
+
+	/* the plugins are not set up yet */
+	vfuncs = g_array_new (FALSE, FALSE, sizeof (GsPluginLoaderVfunc));
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPluginLoaderVfunc vfunc;
+		vfunc.plugin = g_ptr_array_index (priv->plugins, i);
+		vfunc.func = gs_plugin_get_symbol (vfunc.plugin, function_name);
+		if (vfunc.func != NULL)
+			g_array_append_val (vfuncs, vfunc);
+	}
+	return vfuncs;
+}
+
+/* the plugins that implement any of the refine vfuncs, in plugin order */
+static GArray *
+gs_plugin_loader_get_refine_vfuncs (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GArray *array;
+
+	/* resolved when the plugins were set up */
+	if (priv->refine_vfuncs != NULL)
+		return g_array_ref (priv->refine_vfuncs);
+
+	/* the plugins are not set up yet */
+	array = g_array_new (FALSE, FALSE, sizeof (GsPluginLoaderRefineVfuncs));
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPluginLoaderRefineVfuncs vfuncs;
+		vfuncs.plugin = g_ptr_array_index (priv->plugins, i);
+		vfuncs.refine = gs_plugin_get_symbol (vfuncs.plugin, "gs_plugin_refine");
+		vfuncs.refine_app = gs_plugin_get_symbol (vfuncs.plugin, "gs_plugin_refine_app");
+		vfuncs.refine_wildcard = gs_plugin_get_symbol (vfuncs.plugin, "gs_plugin_refine_wildcard");
+		if (vfuncs.refine == NULL &&
+		    vfuncs.refine_app == NULL &&
+		    vfuncs.refine_wildcard == NULL)
+			continue;
+		g_array_append_val (array, vfuncs);
+	}
+	return array;
+}
+
+static void
+gs_plugin_loader_add_vfuncs (GsPluginLoader *plugin_loader,
+			     const gchar *function_name)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	if (function_name == NULL ||
+	    g_hash_table_contains (priv->vfuncs, function_name))
+		return;
+	g_hash_table_insert (priv->vfuncs,
+			     (gpointer) function_name,
+			     gs_plugin_loader_get_vfuncs (plugin_loader, function_name));
+}
+
+/* resolve every symbol once, so that running a job does not have to look
+ * up and lock each plugin in turn; must be called after the plugins have
+ * been sorted and the ones that failed to set up disabled */
+static void
+gs_plugin_loader_setup_vfuncs (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	const gchar *function_names[] = {
+		"gs_plugin_adopt_app",
+		"gs_plugin_download_app",
+		"gs_plugin_update_app",
+		NULL };
+
+	g_hash_table_remove_all (priv->vfuncs);
+	for (guint i = GS_PLUGIN_ACTION_UNKNOWN + 1; i < GS_PLUGIN_ACTION_LAST; i++)
+		gs_plugin_loader_add_vfuncs (plugin_loader, gs_plugin_action_to_function_name (i));
+	for (guint i = 0; function_names[i] != NULL; i++)
+		gs_plugin_loader_add_vfuncs (plugin_loader, function_names[i]);
+
+	/* refine has three vfuncs that are run together */
+	g_clear_pointer (&priv->refine_vfuncs, g_array_unref);
+	priv->refine_vfuncs = gs_plugin_loader_get_refine_vfuncs (plugin_loader);
+	g_debug ("%u of %u plugins can refine",
+		 priv->refine_vfuncs->len, priv->plugins->len);
+}
+
 static gboolean
 gs_plugin_loader_notify_idle_cb (gpointer user_data)
 {
@@ -452,16 +673,17 @@ gs_plugin_error_handle_failure (GsPluginLoaderHelper *helper,
 static void
 gs_plugin_loader_run_adopt (GsPluginLoader *plugin_loader, GsAppList *list)
 {
-	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GArray) vfuncs = NULL;
 	guint i;
 	guint j;
 
 	/* go through each plugin in order */
-	for (i = 0; i < priv->plugins->len; i++) {
-		GsPluginAdoptAppFunc adopt_app_func = NULL;
-		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
-		adopt_app_func = gs_plugin_get_symbol (plugin, "gs_plugin_adopt_app");
-		if (adopt_app_func == NULL)
+	vfuncs = gs_plugin_loader_get_vfuncs (plugin_loader, "gs_plugin_adopt_app");
+	for (i = 0; i < vfuncs->len; i++) {
+		GsPluginLoaderVfunc *vfunc = &g_array_index (vfuncs, GsPluginLoaderVfunc, i);
+		GsPluginAdoptAppFunc adopt_app_func = vfunc->func;
+		GsPlugin *plugin = vfunc->plugin;
+		if (!gs_plugin_get_enabled (plugin))
 			continue;
 		for (j = 0; j < gs_app_list_length (list); j++) {
 			GsApp *app = gs_app_list_index (list, j);
@@ -499,25 +721,121 @@ gs_plugin_loader_review_score_sort_cb (gconstpointer a, gconstpointer b)
 	return 0;
 }
 
+/* everything after the plugin returned, shared by all the vfuncs */
 static gboolean
-gs_plugin_loader_call_vfunc (GsPluginLoaderHelper *helper,
-			     GsPlugin *plugin,
-			     GsApp *app,
-			     GsAppList *list,
-			     GsPluginRefineFlags refine_flags,
-			     GCancellable *cancellable,
-			     GError **error)
+gs_plugin_loader_call_func_finish (GsPluginLoaderHelper *helper,
+				   GsPlugin *plugin,
+				   GsApp *app,
+				   GsAppList *list,
+				   gboolean ret,
+				   GError **error_local,
+				   gint64 begin_time,
+				   GCancellable *cancellable,
+				   GError **error)
+{
+	GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
+	GsPluginAction action_stats = action;
+	gint64 duration = g_get_monotonic_time () - begin_time;
+	gdouble elapsed;
+
+	if (gs_plugin_job_get_interactive (helper->plugin_job))
+		gs_plugin_interactive_dec (plugin);
+	gs_trace_set_context (NULL, 0);
+	gs_plugin_job_add_download_bytes (helper->plugin_job,
+					  gs_plugin_get_download_bytes (plugin) -
+					  helper->download_bytes_start);
+
+	/* plugin did not return error on cancellable abort */
+	if (ret && g_cancellable_set_error_if_cancelled (cancellable, error_local)) {
+		g_debug ("plugin %s did not return error with cancellable set",
+			 gs_plugin_get_name (plugin));
+		gs_utils_error_convert_gio (error_local);
+		ret = FALSE;
+	}
+
+	/* failed */
+	if (!ret) {
+		/* we returned cancelled, but this was because of a timeout,
+		 * so re-create error, throwing the plugin under the bus */
+		if (helper->timeout_triggered &&
+		    g_error_matches (*error_local, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
+			g_debug ("converting cancelled to timeout");
+			g_clear_error (error_local);
+			g_set_error (error_local,
+				     GS_PLUGIN_ERROR,
+				     GS_PLUGIN_ERROR_TIMED_OUT,
+				     "Timeout was reached as %s took "
+				     "too long to return results",
+				     gs_plugin_get_name (plugin));
+		}
+	}
+
+	/* the refine vfuncs are called for many actions, so count them
+	 * as the refine they are */
+	if (g_str_has_prefix (helper->function_name != NULL ? helper->function_name : "",
+			      "gs_plugin_refine"))
+		action_stats = GS_PLUGIN_ACTION_REFINE;
+	gs_plugin_add_stats (plugin, action_stats, duration,
+			     list != NULL ? gs_app_list_length (list) : app != NULL ? 1 : 0,
+			     ret ? NULL : *error_local);
+
+	if (!ret) {
+		return gs_plugin_error_handle_failure (helper,
+							plugin,
+							*error_local,
+							error);
+	}
+
+	/* add app to the pending installation queue if necessary */
+	if (action == GS_PLUGIN_ACTION_INSTALL &&
+	    app != NULL && gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL) {
+	        add_app_to_install_queue (helper->plugin_loader, app);
+	}
+
+	/* check the plugin didn't take too long */
+	elapsed = (gdouble) duration / G_USEC_PER_SEC;
+	switch (action) {
+	case GS_PLUGIN_ACTION_INITIALIZE:
+	case GS_PLUGIN_ACTION_DESTROY:
+	case GS_PLUGIN_ACTION_SETUP:
+		if (elapsed > 1.0f) {
+			g_warning ("plugin %s took %.1f seconds to do %s",
+				   gs_plugin_get_name (plugin),
+				   elapsed,
+				   gs_plugin_action_to_string (action));
+		}
+		break;
+	default:
+		if (elapsed > 1.0f) {
+			g_debug ("plugin %s took %.1f seconds to do %s",
+				 gs_plugin_get_name (plugin),
+				 elapsed,
+				 gs_plugin_action_to_string (action));
+			}
+		break;
+	}
+
+	/* success */
+	helper->anything_ran = TRUE;
+	return TRUE;
+}
+
+static gboolean
+gs_plugin_loader_call_func (GsPluginLoaderHelper *helper,
+			    GsPlugin *plugin,
+			    gpointer func,
+			    GsApp *app,
+			    GsAppList *list,
+			    GsPluginRefineFlags refine_flags,
+			    GCancellable *cancellable,
+			    GError **error)
 {
 	GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
 	gboolean ret = TRUE;
-	gpointer func = NULL;
 	g_autoptr(GError) error_local = NULL;
-	g_autoptr(GTimer) timer = g_timer_new ();
+	gint64 begin_time = g_get_monotonic_time ();
 
-	/* load the possible symbol */
-	func = gs_plugin_get_symbol (plugin, helper->function_name);
-	if (func == NULL)
-		return TRUE;
+	helper->download_bytes_start = gs_plugin_get_download_bytes (plugin);
 
 	/* fallback if unset */
 	if (app == NULL)
@@ -533,6 +851,8 @@ gs_plugin_loader_call_vfunc (GsPluginLoaderHelper *helper,
 	/* run the correct vfunc */
 	if (gs_plugin_job_get_interactive (helper->plugin_job))
 		gs_plugin_interactive_inc (plugin);
+	gs_trace_set_context (gs_plugin_get_name (plugin),
+			      gs_plugin_job_get_id (helper->plugin_job));
 	switch (action) {
 	case GS_PLUGIN_ACTION_INITIALIZE:
 	case GS_PLUGIN_ACTION_DESTROY:
@@ -723,69 +1043,70 @@ gs_plugin_loader_call_vfunc (GsPluginLoaderHelper *helper,
 		g_critical ("no handler for %s", helper->function_name);
 		break;
 	}
-	if (gs_plugin_job_get_interactive (helper->plugin_job))
-		gs_plugin_interactive_dec (plugin);
-
-	/* plugin did not return error on cancellable abort */
-	if (ret && g_cancellable_set_error_if_cancelled (cancellable, &error_local)) {
-		g_debug ("plugin %s did not return error with cancellable set",
-			 gs_plugin_get_name (plugin));
-		gs_utils_error_convert_gio (&error_local);
-		ret = FALSE;
-	}
-
-	/* failed */
-	if (!ret) {
-		/* we returned cancelled, but this was because of a timeout,
-		 * so re-create error, throwing the plugin under the bus */
-		if (helper->timeout_triggered &&
-		    g_error_matches (error_local, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
-			g_debug ("converting cancelled to timeout");
-			g_clear_error (&error_local);
-			g_set_error (&error_local,
-				     GS_PLUGIN_ERROR,
-				     GS_PLUGIN_ERROR_TIMED_OUT,
-				     "Timeout was reached as %s took "
-				     "too long to return results",
-				     gs_plugin_get_name (plugin));
-		}
-		return gs_plugin_error_handle_failure (helper,
-							plugin,
-							error_local,
-							error);
-	}
+	return gs_plugin_loader_call_func_finish (helper, plugin, app, list, ret,
+						  &error_local, begin_time,
+						  cancellable, error);
+}
 
-	/* add app to the pending installation queue if necessary */
-	if (action == GS_PLUGIN_ACTION_INSTALL &&
-	    app != NULL && gs_app_get_state (app) == AS_APP_STATE_QUEUED_FOR_INSTALL) {
-	        add_app_to_install_queue (helper->plugin_loader, app);
-	}
+static gboolean
+gs_plugin_loader_call_vfunc (GsPluginLoaderHelper *helper,
+			     GsPlugin *plugin,
+			     GsApp *app,
+			     GsAppList *list,
+			     GsPluginRefineFlags refine_flags,
+			     GCancellable *cancellable,
+			     GError **error)
+{
+	gpointer func = gs_plugin_get_symbol (plugin, helper->function_name);
+	if (func == NULL)
+		return TRUE;
+	return gs_plugin_loader_call_func (helper, plugin, func, app, list,
+					   refine_flags, cancellable, error);
+}
 
-	/* check the plugin didn't take too long */
-	switch (action) {
-	case GS_PLUGIN_ACTION_INITIALIZE:
-	case GS_PLUGIN_ACTION_DESTROY:
-	case GS_PLUGIN_ACTION_SETUP:
-		if (g_timer_elapsed (timer, NULL) > 1.0f) {
-			g_warning ("plugin %s took %.1f seconds to do %s",
-				   gs_plugin_get_name (plugin),
-				   g_timer_elapsed (timer, NULL),
-				   gs_plugin_action_to_string (action));
-		}
-		break;
-	default:
-		if (g_timer_elapsed (timer, NULL) > 1.0f) {
-			g_debug ("plugin %s took %.1f seconds to do %s",
-				 gs_plugin_get_name (plugin),
-				 g_timer_elapsed (timer, NULL),
-				 gs_plugin_action_to_string (action));
-			}
-		break;
-	}
+/* @app is %NULL to refine the whole @list */
+static gboolean
+gs_plugin_loader_call_refine (GsPluginLoaderHelper *helper,
+			      GsPluginLoaderRefineVfuncs *vfuncs,
+			      GsApp *app,
+			      GsAppList *list,
+			      GsPluginRefineFlags refine_flags,
+			      GCancellable *cancellable,
+			      GError **error)
+{
+	GsPlugin *plugin = vfuncs->plugin;
+	gboolean ret;
+	g_autoptr(GError) error_local = NULL;
+	gint64 begin_time = g_get_monotonic_time ();
 
-	/* success */
-	helper->anything_ran = TRUE;
-	return TRUE;
+	helper->download_bytes_start = gs_plugin_get_download_bytes (plugin);
+	if (refine_flags == GS_PLUGIN_REFINE_FLAGS_DEFAULT)
+		refine_flags = gs_plugin_job_get_refine_flags (helper->plugin_job);
+	gs_plugin_job_set_plugin (helper->plugin_job, plugin);
+	if (gs_plugin_job_get_interactive (helper->plugin_job))
+		gs_plugin_interactive_inc (plugin);
+	gs_trace_set_context (gs_plugin_get_name (plugin),
+			      gs_plugin_job_get_id (helper->plugin_job));
+	if (app == NULL) {
+		helper->function_name = "gs_plugin_refine";
+		ret = vfuncs->refine (plugin, list, refine_flags,
+				      cancellable, &error_local);
+	} else if (gs_app_has_quirk (app, GS_APP_QUIRK_IS_WILDCARD)) {
+		/* the new apps go in the job list, which is not @list when
+		 * refining addons or the apps left over from a batch */
+		helper->function_name = "gs_plugin_refine_wildcard";
+		ret = vfuncs->refine_wildcard (plugin, app,
+					       gs_plugin_job_get_list (helper->plugin_job),
+					       refine_flags, cancellable, &error_local);
+	} else {
+		helper->function_name = "gs_plugin_refine_app";
+		ret = vfuncs->refine_app (plugin, app, refine_flags,
+					  cancellable, &error_local);
+	}
+	return gs_plugin_loader_call_func_finish (helper, plugin, app,
+						  app == NULL ? list : NULL, ret,
+						  &error_local, begin_time,
+						  cancellable, error);
 }
 
 static gboolean
@@ -795,38 +1116,45 @@ gs_plugin_loader_run_refine_filter (GsPluginLoaderHelper *helper,
 				    GCancellable *cancellable,
 				    GError **error)
 {
-	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (helper->plugin_loader);
+	g_autoptr(GArray) array = NULL;
 
-	/* run each plugin */
-	for (guint i = 0; i < priv->plugins->len; i++) {
-		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
-		g_autoptr(GsAppList) app_list = NULL;
+	/* only the plugins that implement one of the refine vfuncs */
+	array = gs_plugin_loader_get_refine_vfuncs (helper->plugin_loader);
+	for (guint i = 0; i < array->len; i++) {
+		GsPluginLoaderRefineVfuncs *vfuncs;
+		guint len;
+
+		vfuncs = &g_array_index (array, GsPluginLoaderRefineVfuncs, i);
+		if (!gs_plugin_get_enabled (vfuncs->plugin))
+			continue;
 
 		/* run the batched plugin symbol then the per-app plugin */
-		helper->function_name = "gs_plugin_refine";
-		if (!gs_plugin_loader_call_vfunc (helper, plugin, NULL, list,
-						  refine_flags, cancellable, error)) {
+		if (vfuncs->refine != NULL &&
+		    !gs_plugin_loader_call_refine (helper, vfuncs, NULL, list,
+						   refine_flags, cancellable, error)) {
 			return FALSE;
 		}
+		if (vfuncs->refine_app == NULL && vfuncs->refine_wildcard == NULL) {
+			gs_plugin_status_update (vfuncs->plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+			continue;
+		}
 
-		/* use a copy of the list for the loop because a function called
-		 * on the plugin may affect the list which can lead to problems
-		 * (e.g. inserting an app in the list on every call results in
-		 * an infinite loop) */
-		app_list = gs_app_list_copy (list);
-		for (guint j = 0; j < gs_app_list_length (app_list); j++) {
-			GsApp *app = gs_app_list_index (app_list, j);
-			if (!gs_app_has_quirk (app, GS_APP_QUIRK_IS_WILDCARD)) {
-				helper->function_name = "gs_plugin_refine_app";
-			} else {
-				helper->function_name = "gs_plugin_refine_wildcard";
-			}
-			if (!gs_plugin_loader_call_vfunc (helper, plugin, app, NULL,
-							  refine_flags, cancellable, error)) {
+		/* the wildcard vfunc may add apps to the end of the job list,
+		 * which is often @list; don't refine those in this pass or
+		 * inserting an app on every call would never finish */
+		len = gs_app_list_length (list);
+		for (guint j = 0; j < len; j++) {
+			g_autoptr(GsApp) app = g_object_ref (gs_app_list_index (list, j));
+			if (gs_app_has_quirk (app, GS_APP_QUIRK_IS_WILDCARD) ?
+			    vfuncs->refine_wildcard == NULL :
+			    vfuncs->refine_app == NULL)
+				continue;
+			if (!gs_plugin_loader_call_refine (helper, vfuncs, app, list,
+							   refine_flags, cancellable, error)) {
 				return FALSE;
 			}
 		}
-		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+		gs_plugin_status_update (vfuncs->plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 	return TRUE;
 }
@@ -1030,6 +1358,25 @@ out:
 	return ret;
 }
 
+/* only enough to filter, dedupe and sort the whole list; the page is refined
+ * with the flags the caller asked for once it has been cut */
+static gboolean
+gs_plugin_loader_run_refine_unpaged (GsPluginLoaderHelper *helper,
+				     GsAppList *list,
+				     GCancellable *cancellable,
+				     GError **error)
+{
+	GsPluginRefineFlags refine_flags;
+	gboolean ret;
+
+	refine_flags = gs_plugin_job_get_refine_flags (helper->plugin_job);
+	gs_plugin_job_set_refine_flags (helper->plugin_job,
+					GS_PLUGIN_REFINE_FLAGS_DEFAULT);
+	ret = gs_plugin_loader_run_refine (helper, list, cancellable, error);
+	gs_plugin_job_set_refine_flags (helper->plugin_job, refine_flags);
+	return ret;
+}
+
 static void
 gs_plugin_loader_job_sorted_truncation_again (GsPluginLoaderHelper *helper)
 {
@@ -1052,6 +1399,7 @@ static void
 gs_plugin_loader_job_sorted_truncation (GsPluginLoaderHelper *helper)
 {
 	GsAppListSortFunc sort_func;
+	gpointer sort_func_data;
 	guint max_results;
 	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
 
@@ -1059,6 +1407,11 @@ gs_plugin_loader_job_sorted_truncation (GsPluginLoaderHelper *helper)
 	if (list == NULL)
 		return;
 
+	/* pages are cut once the results have been filtered and deduped,
+	 * otherwise an app could be on two pages or a page could be short */
+	if (gs_plugin_job_get_paged (helper->plugin_job))
+		return;
+
 	/* unset */
 	max_results = gs_plugin_job_get_max_results (helper->plugin_job);
 	if (max_results == 0)
@@ -1077,34 +1430,74 @@ gs_plugin_loader_job_sorted_truncation (GsPluginLoaderHelper *helper)
 		g_debug ("no ->sort_func() set for %s, using random!",
 			 gs_plugin_action_to_string (action));
 		gs_app_list_randomize (list);
+		gs_app_list_truncate (list, max_results);
 	} else {
-		gpointer sort_func_data;
+		/* only the apps that are returned need to be in order */
 		sort_func_data = gs_plugin_job_get_sort_func_data (helper->plugin_job);
-		gs_app_list_sort (list, sort_func, sort_func_data);
+		gs_app_list_sort_truncate (list, max_results,
+					   sort_func, sort_func_data);
 	}
-	gs_app_list_truncate (list, max_results);
 }
 
-static gboolean
-gs_plugin_loader_run_results (GsPluginLoaderHelper *helper,
-			      GCancellable *cancellable,
-			      GError **error)
+static void
+gs_plugin_loader_job_page (GsPluginLoaderHelper *helper)
 {
-	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (helper->plugin_loader);
+	GsAppListSortFunc sort_func;
+	guint max_results;
+	guint offset;
+	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
 
-	/* run each plugin */
-	for (guint i = 0; i < priv->plugins->len; i++) {
-		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
-		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
-			gs_utils_error_convert_gio (error);
-			return FALSE;
-		}
-		if (!gs_plugin_loader_call_vfunc (helper, plugin, NULL, NULL,
-						  GS_PLUGIN_REFINE_FLAGS_DEFAULT,
-						  cancellable, error)) {
+	/* not valid */
+	if (list == NULL || !gs_plugin_job_get_paged (helper->plugin_job))
+		return;
+
+	/* the list has already been sorted if there is a sort_func */
+	sort_func = gs_plugin_job_get_sort_func (helper->plugin_job);
+	if (sort_func == NULL) {
+		GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
+		g_debug ("no ->sort_func() set for %s, using ID for paging",
+			 gs_plugin_action_to_string (action));
+		gs_app_list_sort (list, gs_plugin_loader_app_sort_id_cb, NULL);
+	}
+
+	max_results = gs_plugin_job_get_max_results (helper->plugin_job);
+	offset = gs_plugin_job_get_offset (helper->plugin_job);
+	g_debug ("paging results to %u from %u at offset %u",
+		 max_results, gs_app_list_length (list), offset);
+	gs_app_list_skip (list, offset);
+	if (max_results > 0 && gs_app_list_length (list) > max_results)
+		gs_app_list_truncate (list, max_results);
+}
+
+static gboolean
+gs_plugin_loader_run_results (GsPluginLoaderHelper *helper,
+			      GCancellable *cancellable,
+			      GError **error)
+{
+	GsPlugin *plugin_only = gs_plugin_job_get_plugin_only (helper->plugin_job);
+	g_autoptr(GArray) vfuncs = NULL;
+
+	/* run each plugin that implements the vfunc */
+	vfuncs = gs_plugin_loader_get_vfuncs (helper->plugin_loader, helper->function_name);
+	for (guint i = 0; i < vfuncs->len; i++) {
+		GsPluginLoaderVfunc *vfunc = &g_array_index (vfuncs, GsPluginLoaderVfunc, i);
+		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+			gs_utils_error_convert_gio (error);
 			return FALSE;
 		}
-		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+
+		/* the job was restricted to just one plugin */
+		if (plugin_only != NULL && vfunc->plugin != plugin_only)
+			continue;
+		if (!gs_plugin_get_enabled (vfunc->plugin))
+			continue;
+		if (!gs_plugin_loader_call_func (helper, vfunc->plugin, vfunc->func,
+						 NULL, NULL,
+						 GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+						 cancellable, error)) {
+			return FALSE;
+		}
+		gs_plugin_status_update (vfunc->plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
 	}
 	return TRUE;
 }
@@ -1339,6 +1732,116 @@ gs_plugin_loader_get_app_is_compatible (GsApp *app, gpointer user_data)
 	return FALSE;
 }
 
+typedef struct {
+	GsPluginJob		*plugin_job;
+	GsAppList		*list;
+	GCancellable		*cancellable;
+} GsPluginLoaderPartialHelper;
+
+static void
+gs_plugin_loader_partial_helper_free (GsPluginLoaderPartialHelper *partial)
+{
+	g_object_unref (partial->plugin_job);
+	g_object_unref (partial->list);
+	g_object_unref (partial->cancellable);
+	g_slice_free (GsPluginLoaderPartialHelper, partial);
+}
+
+static gboolean
+gs_plugin_loader_emit_partial_cb (gpointer user_data)
+{
+	GsPluginLoaderPartialHelper *partial = (GsPluginLoaderPartialHelper *) user_data;
+	GsPluginJobPartialFunc partial_func = gs_plugin_job_get_partial_func (partial->plugin_job);
+
+	/* the caller has gone away */
+	if (g_cancellable_is_cancelled (partial->cancellable))
+		return G_SOURCE_REMOVE;
+	partial_func (partial->plugin_job, partial->list,
+		      gs_plugin_job_get_partial_func_data (partial->plugin_job));
+	return G_SOURCE_REMOVE;
+}
+
+static void
+gs_plugin_loader_emit_partial (GsPluginLoaderHelper *helper, GsAppList *list)
+{
+	GsPluginLoaderPartialHelper *partial = g_slice_new0 (GsPluginLoaderPartialHelper);
+	partial->plugin_job = g_object_ref (helper->plugin_job);
+	partial->list = g_object_ref (list);
+	partial->cancellable = g_object_ref (helper->cancellable);
+	g_main_context_invoke_full (helper->context,
+				    G_PRIORITY_DEFAULT,
+				    gs_plugin_loader_emit_partial_cb,
+				    partial,
+				    (GDestroyNotify) gs_plugin_loader_partial_helper_free);
+}
+
+static gboolean
+gs_plugin_loader_job_has_partial (GsPluginLoaderHelper *helper)
+{
+	if (gs_plugin_job_get_partial_func (helper->plugin_job) == NULL)
+		return FALSE;
+
+	/* only the updates list is slow enough to be worth streaming */
+	return gs_plugin_job_get_action (helper->plugin_job) == GS_PLUGIN_ACTION_GET_UPDATES;
+}
+
+static gboolean
+gs_plugin_loader_run_results_partial (GsPluginLoaderHelper *helper,
+				      GCancellable *cancellable,
+				      GError **error)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (helper->plugin_loader);
+	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
+	GsPlugin *plugin_only = gs_plugin_job_get_plugin_only (helper->plugin_job);
+	GsPluginRefineFlags refine_flags = gs_plugin_job_get_refine_flags (helper->plugin_job);
+
+	/* run each plugin, refining and showing its results before moving on */
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		g_autoptr(GsAppList) list_plugin = NULL;
+		g_autoptr(GsAppList) list_partial = NULL;
+
+		if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
+			gs_utils_error_convert_gio (error);
+			return FALSE;
+		}
+
+		/* the job was restricted to just one plugin */
+		if (plugin_only != NULL && plugin != plugin_only)
+			continue;
+		if (!gs_plugin_get_enabled (plugin))
+			continue;
+		list_plugin = gs_app_list_new ();
+		if (!gs_plugin_loader_call_vfunc (helper, plugin, NULL, list_plugin,
+						  GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+						  cancellable, error)) {
+			return FALSE;
+		}
+		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+		if (gs_app_list_length (list_plugin) == 0)
+			continue;
+
+		/* refine just the new results so they can be shown; the whole
+		 * list is refined again at the end for the refine plugins that
+		 * need to see all of it, such as the OS update proxy */
+		if (refine_flags != 0) {
+			if (!gs_plugin_loader_run_refine (helper, list_plugin,
+							  cancellable, error))
+				return FALSE;
+		}
+		gs_app_list_add_list (list, list_plugin);
+
+		/* only show what the final filter would keep */
+		list_partial = gs_app_list_copy (list_plugin);
+		gs_app_list_filter (list_partial,
+				    gs_plugin_loader_app_is_valid_updatable,
+				    helper);
+		if (gs_app_list_length (list_partial) > 0)
+			gs_plugin_loader_emit_partial (helper, list_partial);
+	}
+	return TRUE;
+}
+
 /******************************************************************************/
 
 static gboolean
@@ -1350,6 +1853,75 @@ gs_plugin_loader_featured_debug (GsApp *app, gpointer user_data)
 	return FALSE;
 }
 
+static GsPluginLoaderFilter
+gs_plugin_loader_get_filter_for_action (GsPluginAction action)
+{
+	switch (action) {
+	case GS_PLUGIN_ACTION_URL_TO_APP:
+	case GS_PLUGIN_ACTION_REFINE:
+		return GS_PLUGIN_LOADER_FILTER_VALID;
+	case GS_PLUGIN_ACTION_SEARCH:
+	case GS_PLUGIN_ACTION_SEARCH_FILES:
+	case GS_PLUGIN_ACTION_SEARCH_PROVIDES:
+	case GS_PLUGIN_ACTION_GET_ALTERNATES:
+	case GS_PLUGIN_ACTION_GET_POPULAR:
+		return GS_PLUGIN_LOADER_FILTER_VALID |
+		       GS_PLUGIN_LOADER_FILTER_QT_FOR_GTK |
+		       GS_PLUGIN_LOADER_FILTER_COMPATIBLE;
+	case GS_PLUGIN_ACTION_GET_CATEGORY_APPS:
+	case GS_PLUGIN_ACTION_GET_RECENT:
+		return GS_PLUGIN_LOADER_FILTER_NON_COMPULSORY |
+		       GS_PLUGIN_LOADER_FILTER_VALID |
+		       GS_PLUGIN_LOADER_FILTER_QT_FOR_GTK |
+		       GS_PLUGIN_LOADER_FILTER_COMPATIBLE;
+	case GS_PLUGIN_ACTION_GET_INSTALLED:
+		return GS_PLUGIN_LOADER_FILTER_VALID |
+		       GS_PLUGIN_LOADER_FILTER_INSTALLED;
+	case GS_PLUGIN_ACTION_GET_FEATURED:
+		if (g_getenv ("GNOME_SOFTWARE_FEATURED") != NULL)
+			return GS_PLUGIN_LOADER_FILTER_FEATURED_DEBUG;
+		return GS_PLUGIN_LOADER_FILTER_VALID |
+		       GS_PLUGIN_LOADER_FILTER_COMPATIBLE;
+	case GS_PLUGIN_ACTION_GET_UPDATES:
+		return GS_PLUGIN_LOADER_FILTER_VALID |
+		       GS_PLUGIN_LOADER_FILTER_UPDATABLE;
+	default:
+		return GS_PLUGIN_LOADER_FILTER_NONE;
+	}
+}
+
+/* all the checks in helper->filter in one pass, stopping at the first that
+ * fails, and then getting the priority ready for the dedupe */
+static gboolean
+gs_plugin_loader_app_is_wanted (GsApp *app, gpointer user_data)
+{
+	GsPluginLoaderHelper *helper = (GsPluginLoaderHelper *) user_data;
+	GsPluginLoaderFilter filter = helper->filter;
+
+	if ((filter & GS_PLUGIN_LOADER_FILTER_NON_COMPULSORY) > 0 &&
+	    !gs_plugin_loader_app_is_non_compulsory (app, NULL))
+		return FALSE;
+	if ((filter & GS_PLUGIN_LOADER_FILTER_FEATURED_DEBUG) > 0 &&
+	    !gs_plugin_loader_featured_debug (app, NULL))
+		return FALSE;
+	if ((filter & GS_PLUGIN_LOADER_FILTER_VALID) > 0 &&
+	    !gs_plugin_loader_app_is_valid (app, helper))
+		return FALSE;
+	if ((filter & GS_PLUGIN_LOADER_FILTER_INSTALLED) > 0 &&
+	    !gs_plugin_loader_app_is_valid_installed (app, helper))
+		return FALSE;
+	if ((filter & GS_PLUGIN_LOADER_FILTER_UPDATABLE) > 0 &&
+	    !gs_app_is_updatable (app))
+		return FALSE;
+	if ((filter & GS_PLUGIN_LOADER_FILTER_QT_FOR_GTK) > 0 &&
+	    !gs_plugin_loader_filter_qt_for_gtk (app, NULL))
+		return FALSE;
+	if ((filter & GS_PLUGIN_LOADER_FILTER_COMPATIBLE) > 0 &&
+	    !gs_plugin_loader_get_app_is_compatible (app, helper->plugin_loader))
+		return FALSE;
+	return gs_plugin_loader_app_set_prio (app, helper->plugin_loader);
+}
+
 static gint
 gs_plugin_loader_app_sort_kind_cb (GsApp *app1, GsApp *app2, gpointer user_data)
 {
@@ -1875,6 +2447,177 @@ gs_plugin_loader_get_events (GsPluginLoader *plugin_loader)
 	return events;
 }
 
+/**
+ * gs_plugin_loader_get_stats:
+ * @plugin_loader: A #GsPluginLoader
+ *
+ * Gets the latency and error statistics of every plugin vfunc that has been
+ * called by this loader. The percentiles are approximate as the latencies are
+ * only kept as a histogram.
+ *
+ * Returns: (transfer floating): a #GVariant of type `a(ssuuuuttt)` with the
+ * plugin name, the action, the number of calls, errors, timeouts and
+ * applications, and the 50th, 95th and 99th percentile in microseconds
+ *
+ * Since: 3.32
+ **/
+GVariant *
+gs_plugin_loader_get_stats (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssuuuuttt)"));
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		g_autoptr(GVariant) stats = g_variant_ref_sink (gs_plugin_get_stats (plugin));
+		GVariantIter iter;
+		const gchar *action;
+		guint calls, errors, timeouts, apps;
+		guint64 p50, p95, p99;
+
+		g_variant_iter_init (&iter, stats);
+		while (g_variant_iter_next (&iter, "(&suuuuttt)", &action,
+					    &calls, &errors, &timeouts, &apps,
+					    &p50, &p95, &p99)) {
+			g_variant_builder_add (&builder, "(ssuuuuttt)",
+					       gs_plugin_get_name (plugin),
+					       action, calls, errors, timeouts,
+					       apps, p50, p95, p99);
+		}
+	}
+	return g_variant_builder_end (&builder);
+}
+
+/**
+ * gs_plugin_loader_get_memory_stats:
+ * @plugin_loader: A #GsPluginLoader
+ *
+ * Gets how many applications are alive and roughly how much memory they use,
+ * along with the size of the cache of each plugin. This is only meant to help
+ * find leaks, and is slow for a large number of applications.
+ *
+ * Returns: (transfer floating): a #GVariant of type `a{sv}`, with the keys
+ * described in gs_app_get_memory_stats() and also `caches` of type `a(sutuuu)`
+ * with the plugin name, number of cached applications, size, hits, misses
+ * and evictions
+ *
+ * Since: 3.32
+ **/
+GVariant *
+gs_plugin_loader_get_memory_stats (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GVariantBuilder builder;
+	GVariantBuilder builder_caches;
+	GVariantIter iter;
+	const gchar *key;
+	GVariant *value;
+	g_autoptr(GVariant) stats = NULL;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	stats = g_variant_ref_sink (gs_app_get_memory_stats (10));
+	g_variant_iter_init (&iter, stats);
+	while (g_variant_iter_next (&iter, "{&sv}", &key, &value)) {
+		g_variant_builder_add (&builder, "{sv}", key, value);
+		g_variant_unref (value);
+	}
+
+	g_variant_builder_init (&builder_caches, G_VARIANT_TYPE ("a(sutuuu)"));
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		guint64 size = 0;
+		guint hits = 0;
+		guint misses = 0;
+		guint evictions = 0;
+		guint n_apps = gs_plugin_cache_get_size (plugin, &size);
+		gs_plugin_cache_get_stats (plugin, &hits, &misses, &evictions);
+		if (n_apps == 0 && hits == 0 && misses == 0)
+			continue;
+		g_variant_builder_add (&builder_caches, "(sutuuu)",
+				       gs_plugin_get_name (plugin), n_apps, size,
+				       hits, misses, evictions);
+	}
+	g_variant_builder_add (&builder, "{sv}", "caches",
+			       g_variant_builder_end (&builder_caches));
+	return g_variant_builder_end (&builder);
+}
+
+/**
+ * gs_plugin_loader_set_background_paused:
+ * @plugin_loader: A #GsPluginLoader
+ * @paused: if jobs with #GsPluginJob:background set should wait
+ *
+ * Holds back background jobs that have not started yet until unpaused or
+ * cancelled, for instance when running on battery. Jobs that are already
+ * running are not interrupted.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_loader_set_background_paused (GsPluginLoader *plugin_loader,
+					gboolean paused)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+
+	locker = g_mutex_locker_new (&priv->governor_mutex);
+	if (priv->governor_paused == paused)
+		return;
+	g_debug ("%s background jobs", paused ? "pausing" : "resuming");
+	priv->governor_paused = paused;
+	g_cond_broadcast (&priv->governor_cond);
+}
+
+/**
+ * gs_plugin_loader_get_governor_stats:
+ * @plugin_loader: A #GsPluginLoader
+ *
+ * Gets how background jobs and interactive jobs have affected each other.
+ * Comparing the mean duration of the interactive jobs that were started
+ * while background work was running against the others shows how much the
+ * background work slows down the user.
+ *
+ * Returns: (transfer floating): a #GVariant of type `a{sv}` with the keys
+ * `background-jobs`, `background-running`, `background-paused`,
+ * `background-wait` for the total microseconds spent waiting,
+ * `interactive-jobs`, `interactive-time`, `contended-jobs` and
+ * `contended-time`
+ *
+ * Since: 3.32
+ **/
+GVariant *
+gs_plugin_loader_get_governor_stats (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GVariantBuilder builder;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader), NULL);
+
+	locker = g_mutex_locker_new (&priv->governor_mutex);
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add (&builder, "{sv}", "background-jobs",
+			       g_variant_new_uint32 (priv->governor_background_jobs));
+	g_variant_builder_add (&builder, "{sv}", "background-running",
+			       g_variant_new_uint32 (priv->governor_background));
+	g_variant_builder_add (&builder, "{sv}", "background-paused",
+			       g_variant_new_boolean (priv->governor_paused));
+	g_variant_builder_add (&builder, "{sv}", "background-wait",
+			       g_variant_new_uint64 (priv->governor_background_wait));
+	g_variant_builder_add (&builder, "{sv}", "interactive-jobs",
+			       g_variant_new_uint32 (priv->governor_interactive_jobs));
+	g_variant_builder_add (&builder, "{sv}", "interactive-time",
+			       g_variant_new_uint64 (priv->governor_interactive_time));
+	g_variant_builder_add (&builder, "{sv}", "contended-jobs",
+			       g_variant_new_uint32 (priv->governor_contended_jobs));
+	g_variant_builder_add (&builder, "{sv}", "contended-time",
+			       g_variant_new_uint64 (priv->governor_contended_time));
+	return g_variant_builder_end (&builder);
+}
+
 /**
  * gs_plugin_loader_get_event_default:
  * @plugin_loader: A #GsPluginLoader
@@ -2517,18 +3260,70 @@ gs_plugin_loader_setup (GsPluginLoader *plugin_loader,
 		}
 	}
 
+	/* only the plugins that are left need to be called */
+	gs_plugin_loader_setup_vfuncs (plugin_loader);
+
 	/* now we can load the install-queue */
 	if (!load_install_queue (plugin_loader, error))
 		return FALSE;
 	return TRUE;
 }
 
+static void
+gs_plugin_loader_dump_memory (GsPluginLoader *plugin_loader)
+{
+	GVariantIter iter;
+	const gchar *name;
+	const gchar *kind;
+	guint apps;
+	guint apps_peak;
+	guint64 size;
+	guint hits;
+	guint misses;
+	guint evictions;
+	g_autoptr(GVariant) stats = NULL;
+	g_autoptr(GVariant) groups = NULL;
+	g_autoptr(GVariant) largest = NULL;
+	g_autoptr(GVariant) caches = NULL;
+
+	stats = g_variant_ref_sink (gs_plugin_loader_get_memory_stats (plugin_loader));
+	g_variant_lookup (stats, "apps", "u", &apps);
+	g_variant_lookup (stats, "apps-peak", "u", &apps_peak);
+	g_variant_lookup (stats, "size", "t", &size);
+	g_info ("live apps: %u (peak %u), %" G_GUINT64_FORMAT "kB",
+		apps, apps_peak, size / 1024);
+	groups = g_variant_lookup_value (stats, "groups", G_VARIANT_TYPE ("a(ssut)"));
+	g_variant_iter_init (&iter, groups);
+	while (g_variant_iter_next (&iter, "(&s&sut)", &name, &kind, &apps, &size)) {
+		g_info ("live apps for %s\t%s\t%u\t%" G_GUINT64_FORMAT "kB",
+			name[0] != '\0' ? name : "unmanaged", kind, apps, size / 1024);
+	}
+	caches = g_variant_lookup_value (stats, "caches", G_VARIANT_TYPE ("a(sutuuu)"));
+	g_variant_iter_init (&iter, caches);
+	while (g_variant_iter_next (&iter, "(&sutuuu)", &name, &apps, &size,
+				    &hits, &misses, &evictions)) {
+		g_info ("plugin cache for %s\t%u\t%" G_GUINT64_FORMAT "kB\t"
+			"%u hits, %u misses, %u evictions",
+			name, apps, size / 1024, hits, misses, evictions);
+	}
+	largest = g_variant_lookup_value (stats, "largest", G_VARIANT_TYPE ("a(st)"));
+	g_variant_iter_init (&iter, largest);
+	while (g_variant_iter_next (&iter, "(&st)", &name, &size))
+		g_info ("largest app %s\t%" G_GUINT64_FORMAT "kB", name, size / 1024);
+}
+
 void
 gs_plugin_loader_dump_state (GsPluginLoader *plugin_loader)
 {
 	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
 	g_autoptr(GString) str_enabled = g_string_new (NULL);
 	g_autoptr(GString) str_disabled = g_string_new (NULL);
+	g_autoptr(GVariant) stats = NULL;
+	GVariantIter iter;
+	const gchar *plugin_name;
+	const gchar *action;
+	guint calls, errors, timeouts, apps;
+	guint64 p50, p95, p99;
 
 	/* print what the priorities are if verbose */
 	for (guint i = 0; i < priv->plugins->len; i++) {
@@ -2546,6 +3341,22 @@ gs_plugin_loader_dump_state (GsPluginLoader *plugin_loader)
 		g_string_truncate (str_disabled, str_disabled->len - 2);
 	g_info ("enabled plugins: %s", str_enabled->str);
 	g_info ("disabled plugins: %s", str_disabled->str);
+
+	/* and how they have been doing so far */
+	stats = g_variant_ref_sink (gs_plugin_loader_get_stats (plugin_loader));
+	g_variant_iter_init (&iter, stats);
+	while (g_variant_iter_next (&iter, "(&s&suuuuttt)", &plugin_name, &action,
+				    &calls, &errors, &timeouts, &apps,
+				    &p50, &p95, &p99)) {
+		g_info ("%s\t%s\tcalls:%u errors:%u timeouts:%u apps:%u "
+			"p50:%" G_GUINT64_FORMAT "us p95:%" G_GUINT64_FORMAT "us "
+			"p99:%" G_GUINT64_FORMAT "us",
+			plugin_name, action, calls, errors, timeouts, apps,
+			p50, p95, p99);
+	}
+
+	/* and what is being kept alive */
+	gs_plugin_loader_dump_memory (plugin_loader);
 }
 
 static void
@@ -2594,6 +3405,8 @@ gs_plugin_loader_dispose (GObject *object)
 		plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_DESTROY, NULL);
 		helper = gs_plugin_loader_helper_new (plugin_loader, plugin_job);
 		gs_plugin_loader_run_results (helper, NULL, NULL);
+		g_hash_table_remove_all (priv->vfuncs);
+		g_clear_pointer (&priv->refine_vfuncs, g_array_unref);
 		g_clear_pointer (&priv->plugins, g_ptr_array_unref);
 	}
 	if (priv->updates_changed_id != 0) {
@@ -2611,6 +3424,15 @@ gs_plugin_loader_dispose (GObject *object)
 		g_thread_pool_free (priv->queued_ops_pool, TRUE, TRUE);
 		priv->queued_ops_pool = NULL;
 	}
+	if (priv->background_pool != NULL) {
+		gs_plugin_loader_set_background_paused (plugin_loader, FALSE);
+		g_thread_pool_free (priv->background_pool, TRUE, TRUE);
+		priv->background_pool = NULL;
+	}
+	g_mutex_lock (&priv->batch_mutex);
+	g_clear_pointer (&priv->batch_tasks, g_ptr_array_unref);
+	g_clear_pointer (&priv->batch_context, g_main_context_unref);
+	g_mutex_unlock (&priv->batch_mutex);
 	g_clear_object (&priv->network_monitor);
 	g_clear_object (&priv->soup_session);
 	g_clear_object (&priv->settings);
@@ -2633,9 +3455,14 @@ gs_plugin_loader_finalize (GObject *object)
 	g_ptr_array_unref (priv->file_monitors);
 	g_hash_table_unref (priv->events_by_id);
 	g_hash_table_unref (priv->disallow_updates);
+	g_hash_table_unref (priv->vfuncs);
+	g_clear_pointer (&priv->refine_vfuncs, g_array_unref);
 
 	g_mutex_clear (&priv->pending_apps_mutex);
+	g_mutex_clear (&priv->governor_mutex);
+	g_cond_clear (&priv->governor_cond);
 	g_mutex_clear (&priv->events_by_id_mutex);
+	g_mutex_clear (&priv->batch_mutex);
 
 	G_OBJECT_CLASS (gs_plugin_loader_parent_class)->finalize (object);
 }
@@ -2738,6 +3565,11 @@ gs_plugin_loader_init (GsPluginLoader *plugin_loader)
 						   get_max_parallel_ops (),
 						   FALSE,
 						   NULL);
+	priv->background_pool = g_thread_pool_new (gs_plugin_loader_process_in_background_cb,
+						   NULL,
+						   1,
+						   TRUE,
+						   NULL);
 	priv->auth_array = g_ptr_array_new_with_free_func ((GFreeFunc) g_object_unref);
 	priv->file_monitors = g_ptr_array_new_with_free_func ((GFreeFunc) g_object_unref);
 	priv->locations = g_ptr_array_new_with_free_func (g_free);
@@ -2771,6 +3603,8 @@ gs_plugin_loader_init (GsPluginLoader *plugin_loader)
 
 	/* the settings key sets the initial override */
 	priv->disallow_updates = g_hash_table_new (g_direct_hash, g_direct_equal);
+	priv->vfuncs = g_hash_table_new_full (g_str_hash, g_str_equal,
+					      NULL, (GDestroyNotify) g_array_unref);
 	gs_plugin_loader_allow_updates_recheck (plugin_loader);
 
 	/* get the language from the locale */
@@ -2780,7 +3614,10 @@ gs_plugin_loader_init (GsPluginLoader *plugin_loader)
 		*match = '\0';
 
 	g_mutex_init (&priv->pending_apps_mutex);
+	g_mutex_init (&priv->governor_mutex);
+	g_cond_init (&priv->governor_cond);
 	g_mutex_init (&priv->events_by_id_mutex);
+	g_mutex_init (&priv->batch_mutex);
 
 	/* monitor the network as the many UI operations need the network */
 	gs_plugin_loader_monitor_network (plugin_loader);
@@ -2996,49 +3833,32 @@ gs_plugin_loader_generic_update (GsPluginLoader *plugin_loader,
 	return TRUE;
 }
 
-static void
-gs_plugin_loader_process_thread_cb (GTask *task,
-				    gpointer object,
-				    gpointer task_data,
-				    GCancellable *cancellable)
+/* these change the pending count on the installed panel */
+static gboolean
+gs_plugin_loader_action_changes_pending (GsPluginAction action)
 {
-	GError *error = NULL;
-	GsPluginLoaderHelper *helper = (GsPluginLoaderHelper *) task_data;
-	GsAppListFilterFlags dedupe_flags;
-	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
-	GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
-	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
-	GsPluginRefineFlags filter_flags;
-	GsPluginRefineFlags refine_flags;
-	gboolean add_to_pending_array = FALSE;
-
-	/* these change the pending count on the installed panel */
 	switch (action) {
 	case GS_PLUGIN_ACTION_INSTALL:
 	case GS_PLUGIN_ACTION_REMOVE:
-		add_to_pending_array = TRUE;
-		break;
+		return TRUE;
 	default:
-		break;
+		return FALSE;
 	}
+}
 
-	/* add to pending list */
-	if (add_to_pending_array)
-		gs_plugin_loader_pending_apps_add (plugin_loader, helper);
-
-	/* run each plugin */
-	if (action != GS_PLUGIN_ACTION_REFINE) {
-		if (!gs_plugin_loader_run_results (helper, cancellable, &error)) {
-			if (add_to_pending_array) {
-				gs_app_set_state_recover (gs_plugin_job_get_app (helper->plugin_job));
-				gs_plugin_loader_pending_apps_remove (plugin_loader, helper);
-			}
-			gs_utils_error_convert_gio (&error);
-			g_task_return_error (task, error);
-			return;
-		}
-	}
+/* everything between running the plugins and refining the results;
+ * returns %FALSE if @task has already been returned */
+static gboolean
+gs_plugin_loader_process_results (GTask *task,
+				  GsPluginLoaderHelper *helper,
+				  GCancellable *cancellable)
+{
+	GError *error = NULL;
+	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
+	GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
+	GsPluginLoader *plugin_loader = helper->plugin_loader;
+	GsPluginRefineFlags filter_flags;
+	gboolean add_to_pending_array = gs_plugin_loader_action_changes_pending (action);
 
 	/* run per-app version */
 	if (action == GS_PLUGIN_ACTION_UPDATE) {
@@ -3047,7 +3867,7 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 						      cancellable, &error)) {
 			gs_utils_error_convert_gio (&error);
 			g_task_return_error (task, error);
-			return;
+			return FALSE;
 		}
 	} else if (action == GS_PLUGIN_ACTION_DOWNLOAD) {
 		helper->function_name = "gs_plugin_download_app";
@@ -3055,7 +3875,7 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 						      cancellable, &error)) {
 			gs_utils_error_convert_gio (&error);
 			g_task_return_error (task, error);
-			return;
+			return FALSE;
 		}
 	}
 
@@ -3084,7 +3904,7 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 				     "no plugin could handle %s",
 				     gs_plugin_action_to_string (action));
 			g_task_return_error (task, error);
-			return;
+			return FALSE;
 		}
 		break;
 	case GS_PLUGIN_ACTION_REFINE:
@@ -3137,7 +3957,7 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 							 cancellable, &error)) {
 			gs_utils_error_convert_gio (&error);
 			g_task_return_error (task, error);
-			return;
+			return FALSE;
 		}
 	}
 
@@ -3168,16 +3988,22 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 		break;
 	}
 
-	/* run refine() on each one if required */
-	if (gs_plugin_job_get_refine_flags (helper->plugin_job) != 0) {
-		if (!gs_plugin_loader_run_refine (helper, list, cancellable, &error)) {
-			gs_utils_error_convert_gio (&error);
-			g_task_return_error (task, error);
-			return;
-		}
-	} else {
-		g_debug ("no refine flags set for transaction");
-	}
+	return TRUE;
+}
+
+/* everything after refining the results */
+static void
+gs_plugin_loader_process_finish_results (GTask *task,
+					 GsPluginLoaderHelper *helper,
+					 GCancellable *cancellable)
+{
+	GError *error = NULL;
+	GsAppListFilterFlags dedupe_flags;
+	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
+	GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
+	GsPluginLoader *plugin_loader = helper->plugin_loader;
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginRefineFlags refine_flags;
 
 	/* check the local files have an icon set */
 	switch (action) {
@@ -3214,57 +4040,9 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 		break;
 	}
 
-	/* filter package list */
-	switch (action) {
-	case GS_PLUGIN_ACTION_URL_TO_APP:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		break;
-	case GS_PLUGIN_ACTION_SEARCH:
-	case GS_PLUGIN_ACTION_SEARCH_FILES:
-	case GS_PLUGIN_ACTION_SEARCH_PROVIDES:
-	case GS_PLUGIN_ACTION_GET_ALTERNATES:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		gs_app_list_filter (list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-		gs_app_list_filter (list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-		break;
-	case GS_PLUGIN_ACTION_GET_CATEGORY_APPS:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_non_compulsory, NULL);
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		gs_app_list_filter (list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-		gs_app_list_filter (list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-		break;
-	case GS_PLUGIN_ACTION_GET_INSTALLED:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid_installed, helper);
-		break;
-	case GS_PLUGIN_ACTION_GET_FEATURED:
-		if (g_getenv ("GNOME_SOFTWARE_FEATURED") != NULL) {
-			gs_app_list_filter (list, gs_plugin_loader_featured_debug, NULL);
-		} else {
-			gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-			gs_app_list_filter (list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-		}
-		break;
-	case GS_PLUGIN_ACTION_GET_UPDATES:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid_updatable, helper);
-		break;
-	case GS_PLUGIN_ACTION_GET_RECENT:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_non_compulsory, NULL);
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		gs_app_list_filter (list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-		gs_app_list_filter (list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-		break;
-	case GS_PLUGIN_ACTION_REFINE:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		break;
-	case GS_PLUGIN_ACTION_GET_POPULAR:
-		gs_app_list_filter (list, gs_plugin_loader_app_is_valid, helper);
-		gs_app_list_filter (list, gs_plugin_loader_filter_qt_for_gtk, NULL);
-		gs_app_list_filter (list, gs_plugin_loader_get_app_is_compatible, plugin_loader);
-		break;
-	default:
-		break;
-	}
+	/* filter package list, and set the priority for the dedupe */
+	helper->filter = gs_plugin_loader_get_filter_for_action (action);
+	gs_app_list_filter (list, gs_plugin_loader_app_is_wanted, helper);
 
 	/* only allow one result */
 	if (action == GS_PLUGIN_ACTION_URL_TO_APP ||
@@ -3290,7 +4068,6 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 
 	/* filter duplicates with priority, taking into account the source name
 	 * & version, so we combine available updates with the installed app */
-	gs_app_list_filter (list, gs_plugin_loader_app_set_prio, plugin_loader);
 	dedupe_flags = gs_plugin_job_get_dedupe_flags (helper->plugin_job);
 	if (dedupe_flags != GS_APP_LIST_FILTER_FLAG_NONE)
 		gs_app_list_filter_duplicates (list, dedupe_flags);
@@ -3298,6 +4075,19 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 	/* sort these again as the refine may have added useful metadata */
 	gs_plugin_loader_job_sorted_truncation_again (helper);
 
+	/* only return the requested page */
+	gs_plugin_loader_job_page (helper);
+
+	/* and only refine the apps on it */
+	if (gs_plugin_job_get_paged (helper->plugin_job) &&
+	    gs_plugin_job_get_refine_flags (helper->plugin_job) != 0) {
+		if (!gs_plugin_loader_run_refine (helper, list, cancellable, &error)) {
+			gs_utils_error_convert_gio (&error);
+			g_task_return_error (task, error);
+			return;
+		}
+	}
+
 	/* if the plugin used updates-changed actually schedule it now */
 	if (priv->updates_changed_cnt > 0)
 		gs_plugin_loader_updates_changed (plugin_loader);
@@ -3309,6 +4099,215 @@ gs_plugin_loader_process_thread_cb (GTask *task,
 	g_task_return_pointer (task, g_object_ref (list), (GDestroyNotify) g_object_unref);
 }
 
+static void
+gs_plugin_loader_process_thread_cb (GTask *task,
+				    gpointer object,
+				    gpointer task_data,
+				    GCancellable *cancellable)
+{
+	GError *error = NULL;
+	GsPluginLoaderHelper *helper = (GsPluginLoaderHelper *) task_data;
+	GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
+	GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	gboolean add_to_pending_array = gs_plugin_loader_action_changes_pending (action);
+
+	/* add to pending list */
+	if (add_to_pending_array)
+		gs_plugin_loader_pending_apps_add (plugin_loader, helper);
+
+	/* run each plugin */
+	if (action != GS_PLUGIN_ACTION_REFINE) {
+		gboolean ret;
+		if (gs_plugin_loader_job_has_partial (helper))
+			ret = gs_plugin_loader_run_results_partial (helper, cancellable, &error);
+		else
+			ret = gs_plugin_loader_run_results (helper, cancellable, &error);
+		if (!ret) {
+			if (add_to_pending_array) {
+				gs_app_set_state_recover (gs_plugin_job_get_app (helper->plugin_job));
+				gs_plugin_loader_pending_apps_remove (plugin_loader, helper);
+			}
+			gs_utils_error_convert_gio (&error);
+			g_task_return_error (task, error);
+			return;
+		}
+	}
+
+	if (!gs_plugin_loader_process_results (task, helper, cancellable))
+		return;
+
+	/* run refine() on each one if required */
+	if (gs_plugin_job_get_paged (helper->plugin_job)) {
+		if (!gs_plugin_loader_run_refine_unpaged (helper, list, cancellable, &error)) {
+			gs_utils_error_convert_gio (&error);
+			g_task_return_error (task, error);
+			return;
+		}
+	} else if (gs_plugin_job_get_refine_flags (helper->plugin_job) != 0) {
+		if (!gs_plugin_loader_run_refine (helper, list, cancellable, &error)) {
+			gs_utils_error_convert_gio (&error);
+			g_task_return_error (task, error);
+			return;
+		}
+	} else {
+		g_debug ("no refine flags set for transaction");
+	}
+
+	gs_plugin_loader_process_finish_results (task, helper, cancellable);
+}
+
+/* these all return lists of apps from every plugin, and the results are
+ * refined and filtered without depending on anything else in the job */
+static gboolean
+gs_plugin_loader_action_can_batch (GsPluginAction action)
+{
+	switch (action) {
+	case GS_PLUGIN_ACTION_GET_CATEGORY_APPS:
+	case GS_PLUGIN_ACTION_GET_FEATURED:
+	case GS_PLUGIN_ACTION_GET_POPULAR:
+	case GS_PLUGIN_ACTION_GET_RECENT:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static void
+gs_plugin_loader_process_batch_thread_cb (GTask *task,
+					  gpointer object,
+					  gpointer task_data,
+					  GCancellable *cancellable)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (object);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GPtrArray *tasks = (GPtrArray *) task_data;
+	GsPluginRefineFlags refine_flags = GS_PLUGIN_REFINE_FLAGS_DEFAULT;
+	g_autoptr(GError) error_union = NULL;
+	g_autoptr(GHashTable) refined = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_autoptr(GPtrArray) pending = g_ptr_array_new ();
+	g_autoptr(GsAppList) list_union = gs_app_list_new ();
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+	g_autoptr(GsPluginLoaderHelper) helper_union = NULL;
+
+	for (guint i = 0; i < tasks->len; i++)
+		g_ptr_array_add (pending, g_ptr_array_index (tasks, i));
+
+	/* one walk over the plugins for all the jobs */
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		if (!gs_plugin_get_enabled (plugin))
+			continue;
+		for (guint j = 0; j < pending->len; ) {
+			GTask *task_sub = g_ptr_array_index (pending, j);
+			GsPluginLoaderHelper *helper = g_task_get_task_data (task_sub);
+			GsPlugin *plugin_only = gs_plugin_job_get_plugin_only (helper->plugin_job);
+			GError *error = NULL;
+
+			/* the job was restricted to just one plugin */
+			if (plugin_only != NULL && plugin != plugin_only) {
+				j++;
+				continue;
+			}
+			if (g_cancellable_set_error_if_cancelled (helper->cancellable, &error) ||
+			    !gs_plugin_loader_call_vfunc (helper, plugin, NULL, NULL,
+							  GS_PLUGIN_REFINE_FLAGS_DEFAULT,
+							  helper->cancellable, &error)) {
+				gs_utils_error_convert_gio (&error);
+				g_task_return_error (task_sub, error);
+				g_ptr_array_remove_index (pending, j);
+				continue;
+			}
+			j++;
+		}
+		gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_FINISHED);
+	}
+
+	/* truncate each job to what is actually going to be shown */
+	for (guint j = 0; j < pending->len; ) {
+		GTask *task_sub = g_ptr_array_index (pending, j);
+		GsPluginLoaderHelper *helper = g_task_get_task_data (task_sub);
+		if (!gs_plugin_loader_process_results (task_sub, helper, helper->cancellable)) {
+			g_ptr_array_remove_index (pending, j);
+			continue;
+		}
+		j++;
+	}
+
+	/* refine every app just once, with everything any job needs */
+	for (guint j = 0; j < pending->len; j++) {
+		GTask *task_sub = g_ptr_array_index (pending, j);
+		GsPluginLoaderHelper *helper = g_task_get_task_data (task_sub);
+		GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
+
+		/* pages are refined on their own once they have been cut */
+		if (gs_plugin_job_get_paged (helper->plugin_job))
+			continue;
+		refine_flags |= gs_plugin_job_get_refine_flags (helper->plugin_job);
+		for (guint i = 0; i < gs_app_list_length (list); i++) {
+			GsApp *app = gs_app_list_index (list, i);
+			const gchar *unique_id = gs_app_get_unique_id (app);
+			if (g_hash_table_contains (refined, app))
+				continue;
+
+			/* a different object with the same ID is refined
+			 * separately */
+			gs_app_list_add (list_union, app);
+			if (unique_id == NULL ||
+			    gs_app_list_lookup (list_union, unique_id) == app)
+				g_hash_table_add (refined, app);
+		}
+	}
+	g_debug ("refining %u apps for %u batched jobs",
+		 gs_app_list_length (list_union), pending->len);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "list", list_union,
+					 "refine-flags", refine_flags,
+					 NULL);
+	helper_union = gs_plugin_loader_helper_new (plugin_loader, plugin_job);
+	if (refine_flags != GS_PLUGIN_REFINE_FLAGS_DEFAULT &&
+	    !gs_plugin_loader_run_refine (helper_union, list_union,
+					  cancellable, &error_union)) {
+		/* the error may only be for one of the jobs, so let each job
+		 * refine its own apps and get its own error */
+		g_debug ("failed to refine %u batched jobs together: %s",
+			 pending->len, error_union->message);
+		g_hash_table_remove_all (refined);
+	}
+
+	/* finish each job as if it was run on its own */
+	for (guint j = 0; j < pending->len; j++) {
+		GTask *task_sub = g_ptr_array_index (pending, j);
+		GsPluginLoaderHelper *helper = g_task_get_task_data (task_sub);
+		GsAppList *list = gs_plugin_job_get_list (helper->plugin_job);
+		g_autoptr(GsAppList) leftover = gs_app_list_new ();
+		g_autoptr(GError) error = NULL;
+
+		for (guint i = 0; i < gs_app_list_length (list); i++) {
+			GsApp *app = gs_app_list_index (list, i);
+			if (!g_hash_table_contains (refined, app))
+				gs_app_list_add (leftover, app);
+		}
+		if (gs_plugin_job_get_paged (helper->plugin_job)) {
+			if (!gs_plugin_loader_run_refine_unpaged (helper, list,
+								  helper->cancellable,
+								  &error)) {
+				gs_utils_error_convert_gio (&error);
+				g_task_return_error (task_sub, g_steal_pointer (&error));
+				continue;
+			}
+		} else if (gs_plugin_job_get_refine_flags (helper->plugin_job) != 0 &&
+			   !gs_plugin_loader_run_refine (helper, leftover,
+							 helper->cancellable, &error)) {
+			gs_utils_error_convert_gio (&error);
+			g_task_return_error (task_sub, g_steal_pointer (&error));
+			continue;
+		}
+		gs_plugin_loader_process_finish_results (task_sub, helper, helper->cancellable);
+	}
+	g_task_return_boolean (task, TRUE);
+}
+
 static void
 gs_plugin_loader_process_in_thread_pool_cb (gpointer data,
 					    gpointer user_data)
@@ -3317,13 +4316,47 @@ gs_plugin_loader_process_in_thread_pool_cb (gpointer data,
 	gpointer source_object = g_task_get_source_object (task);
 	gpointer task_data = g_task_get_task_data (task);
 	GCancellable *cancellable = g_task_get_cancellable (task);
+	GsPluginLoaderHelper *helper = task_data;
 
-	gs_ioprio_init ();
+	/* the user is waiting for an interactive install or update */
+	if (gs_plugin_job_get_interactive (helper->plugin_job))
+		gs_ioprio_set_interactive ();
+	else
+		gs_ioprio_init ();
 
 	gs_plugin_loader_process_thread_cb (task, source_object, task_data, cancellable);
 	g_object_unref (task);
 }
 
+static void
+gs_plugin_loader_process_in_background_cb (gpointer data,
+					   gpointer user_data)
+{
+	GTask *task = data;
+	GsPluginLoader *plugin_loader = g_task_get_source_object (task);
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	gpointer task_data = g_task_get_task_data (task);
+	GCancellable *cancellable = g_task_get_cancellable (task);
+
+	/* the pool is exclusive, so this never affects other jobs */
+	gs_ioprio_set_background ();
+
+	/* let interactive jobs go first */
+	gs_plugin_loader_governor_wait (plugin_loader, cancellable);
+
+	g_mutex_lock (&priv->governor_mutex);
+	priv->governor_background++;
+	g_mutex_unlock (&priv->governor_mutex);
+
+	gs_plugin_loader_process_thread_cb (task, plugin_loader, task_data, cancellable);
+
+	g_mutex_lock (&priv->governor_mutex);
+	priv->governor_background--;
+	priv->governor_background_jobs++;
+	g_mutex_unlock (&priv->governor_mutex);
+	g_object_unref (task);
+}
+
 static gboolean
 gs_plugin_loader_job_timeout_cb (gpointer user_data)
 {
@@ -3357,9 +4390,29 @@ gs_plugin_loader_schedule_task (GsPluginLoader *plugin_loader,
 	if (app != NULL) {
 		/* set the pending-action to the app */
 		GsPluginAction action = gs_plugin_job_get_action (helper->plugin_job);
+		gs_trace_set_context (NULL, gs_plugin_job_get_id (helper->plugin_job));
 		gs_app_set_pending_action (app, action);
+		gs_trace_set_context (NULL, 0);
 	}
-	g_thread_pool_push (priv->queued_ops_pool, g_object_ref (task), NULL);
+	if (gs_plugin_job_get_background (helper->plugin_job))
+		g_thread_pool_push (priv->background_pool, g_object_ref (task), NULL);
+	else
+		g_thread_pool_push (priv->queued_ops_pool, g_object_ref (task), NULL);
+}
+
+/* only jobs started from the context that began the batch are collected, as a
+ * job started from another thread may be waited on before the batch ends */
+static gboolean
+gs_plugin_loader_batch_add (GsPluginLoader *plugin_loader, GTask *task)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GsPluginLoaderHelper *helper = g_task_get_task_data (task);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->batch_mutex);
+
+	if (priv->batch_tasks == NULL || helper->context != priv->batch_context)
+		return FALSE;
+	g_ptr_array_add (priv->batch_tasks, g_object_ref (task));
+	return TRUE;
 }
 
 /**
@@ -3542,7 +4595,9 @@ gs_plugin_loader_job_process_async (GsPluginLoader *plugin_loader,
 
 	/* save helper */
 	helper = gs_plugin_loader_helper_new (plugin_loader, plugin_job);
+	helper->context = g_main_context_ref_thread_default ();
 	g_task_set_task_data (task, helper, (GDestroyNotify) gs_plugin_loader_helper_free);
+	gs_plugin_loader_governor_job_begin (helper);
 
 	/* let the task cancel itself */
 	g_task_set_check_cancellable (task, FALSE);
@@ -3604,10 +4659,101 @@ gs_plugin_loader_job_process_async (GsPluginLoader *plugin_loader,
 		break;
 	}
 
+	/* keep background work off the threads used for the user */
+	if (gs_plugin_job_get_background (plugin_job)) {
+		g_thread_pool_push (priv->background_pool, g_object_ref (task), NULL);
+		return;
+	}
+
+	/* run together with the other jobs in the batch */
+	if (gs_plugin_loader_action_can_batch (gs_plugin_job_get_action (plugin_job)) &&
+	    gs_plugin_loader_batch_add (plugin_loader, task))
+		return;
+
 	/* run in a thread */
 	g_task_run_in_thread (task, gs_plugin_loader_process_thread_cb);
 }
 
+/**
+ * gs_plugin_loader_batch_begin:
+ * @plugin_loader: A #GsPluginLoader
+ *
+ * Starts collecting jobs passed to gs_plugin_loader_job_process_async()
+ * rather than running each one as it is added. Only jobs that return lists
+ * of apps, such as %GS_PLUGIN_ACTION_GET_FEATURED, are collected; anything
+ * else is run straight away.
+ *
+ * The collected jobs are run when gs_plugin_loader_batch_end() is called.
+ * They share a single walk over the plugins and a single refine of all the
+ * returned apps, and each job callback is called as usual.
+ *
+ * Only jobs started from the thread-default main context of the caller are
+ * collected, and gs_plugin_loader_batch_end() has to be called from the same
+ * context.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_loader_batch_begin (GsPluginLoader *plugin_loader)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+
+	locker = g_mutex_locker_new (&priv->batch_mutex);
+	g_return_if_fail (priv->batch_tasks == NULL);
+	priv->batch_tasks = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	priv->batch_context = g_main_context_ref_thread_default ();
+}
+
+/**
+ * gs_plugin_loader_batch_end:
+ * @plugin_loader: A #GsPluginLoader
+ * @cancellable: a #GCancellable, or %NULL
+ *
+ * Runs all the jobs collected since gs_plugin_loader_batch_begin().
+ * @cancellable is used for the shared refine, and is normally the same one
+ * that was passed for each job.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_loader_batch_end (GsPluginLoader *plugin_loader,
+			    GCancellable *cancellable)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	g_autoptr(GMainContext) context = g_main_context_ref_thread_default ();
+	g_autoptr(GPtrArray) tasks = NULL;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN_LOADER (plugin_loader));
+
+	g_mutex_lock (&priv->batch_mutex);
+	if (priv->batch_tasks == NULL) {
+		g_mutex_unlock (&priv->batch_mutex);
+		g_return_if_reached ();
+	}
+	g_assert (priv->batch_context == context);
+	tasks = g_steal_pointer (&priv->batch_tasks);
+	g_clear_pointer (&priv->batch_context, g_main_context_unref);
+	g_mutex_unlock (&priv->batch_mutex);
+	if (tasks->len == 0)
+		return;
+
+	/* just one, so there is nothing to share */
+	if (tasks->len == 1) {
+		g_task_run_in_thread (g_ptr_array_index (tasks, 0),
+				      gs_plugin_loader_process_thread_cb);
+		return;
+	}
+
+	task = g_task_new (plugin_loader, cancellable, NULL, NULL);
+	g_task_set_task_data (task, g_steal_pointer (&tasks),
+			      (GDestroyNotify) g_ptr_array_unref);
+	g_task_run_in_thread (task, gs_plugin_loader_process_batch_thread_cb);
+}
+
 /******************************************************************************/
 
 /**
@@ -3630,6 +4776,31 @@ gs_plugin_loader_get_plugin_supported (GsPluginLoader *plugin_loader,
 	return FALSE;
 }
 
+/**
+ * gs_plugin_loader_get_plugins_supported:
+ * @plugin_loader: A #GsPluginLoader
+ * @function_name: a function name
+ *
+ * Gets all the enabled plugins that provide a symbol.
+ *
+ * Returns: (transfer container) (element-type GsPlugin): plugins
+ *
+ * Since: 3.32
+ */
+GPtrArray *
+gs_plugin_loader_get_plugins_supported (GsPluginLoader *plugin_loader,
+					const gchar *function_name)
+{
+	GsPluginLoaderPrivate *priv = gs_plugin_loader_get_instance_private (plugin_loader);
+	GPtrArray *plugins = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+	for (guint i = 0; i < priv->plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (priv->plugins, i);
+		if (gs_plugin_get_symbol (plugin, function_name) != NULL)
+			g_ptr_array_add (plugins, g_object_ref (plugin));
+	}
+	return plugins;
+}
+
 /**
  * gs_plugin_loader_app_create:
  * @plugin_loader: a #GsPluginLoader
@@ -58,6 +58,9 @@ void		 gs_plugin_loader_job_process_async	(GsPluginLoader	*plugin_loader,
 GsAppList	*gs_plugin_loader_job_process_finish	(GsPluginLoader	*plugin_loader,
 							 GAsyncResult	*res,
 							 GError		**error);
+void		 gs_plugin_loader_batch_begin		(GsPluginLoader	*plugin_loader);
+void		 gs_plugin_loader_batch_end		(GsPluginLoader	*plugin_loader,
+							 GCancellable	*cancellable);
 gboolean	 gs_plugin_loader_job_action_finish	(GsPluginLoader	*plugin_loader,
 							 GAsyncResult	*res,
 							 GError		**error);
@@ -91,9 +94,16 @@ gboolean	 gs_plugin_loader_get_network_available	(GsPluginLoader *plugin_loader)
 gboolean	 gs_plugin_loader_get_network_metered	(GsPluginLoader *plugin_loader);
 gboolean	 gs_plugin_loader_get_plugin_supported	(GsPluginLoader	*plugin_loader,
 							 const gchar	*function_name);
+GPtrArray	*gs_plugin_loader_get_plugins_supported	(GsPluginLoader	*plugin_loader,
+							 const gchar	*function_name);
 
 GPtrArray	*gs_plugin_loader_get_events		(GsPluginLoader	*plugin_loader);
 GsPluginEvent	*gs_plugin_loader_get_event_default	(GsPluginLoader	*plugin_loader);
+GVariant	*gs_plugin_loader_get_stats		(GsPluginLoader	*plugin_loader);
+GVariant	*gs_plugin_loader_get_memory_stats	(GsPluginLoader	*plugin_loader);
+GVariant	*gs_plugin_loader_get_governor_stats	(GsPluginLoader	*plugin_loader);
+void		 gs_plugin_loader_set_background_paused	(GsPluginLoader	*plugin_loader,
+							 gboolean	 paused);
 void		 gs_plugin_loader_remove_events		(GsPluginLoader	*plugin_loader);
 
 GsApp		*gs_plugin_loader_app_create		(GsPluginLoader	*plugin_loader,
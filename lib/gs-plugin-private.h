@@ -48,6 +48,7 @@ void		 gs_plugin_set_order			(GsPlugin	*plugin,
 guint		 gs_plugin_get_priority			(GsPlugin	*plugin);
 void		 gs_plugin_set_priority			(GsPlugin	*plugin,
 							 guint		 priority);
+guint64		 gs_plugin_get_download_bytes		(GsPlugin	*plugin);
 void		 gs_plugin_set_name			(GsPlugin	*plugin,
 							 const gchar	*name);
 void		 gs_plugin_set_locale			(GsPlugin	*plugin,
@@ -65,6 +66,18 @@ void		 gs_plugin_interactive_dec		(GsPlugin	*plugin);
 gchar		*gs_plugin_refine_flags_to_string	(GsPluginRefineFlags refine_flags);
 void		 gs_plugin_set_network_monitor		(GsPlugin		*plugin,
 							 GNetworkMonitor	*monitor);
+void		 gs_plugin_add_stats			(GsPlugin	*plugin,
+							 GsPluginAction	 action,
+							 gint64		 duration,
+							 guint		 n_apps,
+							 const GError	*error);
+GVariant	*gs_plugin_get_stats			(GsPlugin	*plugin);
+guint		 gs_plugin_cache_get_size		(GsPlugin	*plugin,
+							 guint64	*size);
+void		 gs_plugin_cache_get_stats		(GsPlugin	*plugin,
+							 guint		*hits,
+							 guint		*misses,
+							 guint		*evictions);
 
 G_END_DECLS
 
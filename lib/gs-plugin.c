@@ -53,17 +53,39 @@
 #include <valgrind.h>
 #endif
 
+#include "gs-app-private.h"
 #include "gs-app-list-private.h"
 #include "gs-os-release.h"
 #include "gs-plugin-private.h"
 #include "gs-plugin.h"
 #include "gs-utils.h"
 
+/* latency buckets, two for each power of two of microseconds */
+#define GS_PLUGIN_STATS_BUCKETS		64
+
+typedef struct {
+	gint			 calls;		/* atomic */
+	gint			 errors;	/* atomic */
+	gint			 timeouts;	/* atomic */
+	gint			 apps;		/* atomic */
+	gint			 buckets[GS_PLUGIN_STATS_BUCKETS];	/* atomic */
+} GsPluginStats;
+
+typedef struct _GsPluginCacheEntry GsPluginCacheEntry;
+
 typedef struct
 {
 	GPtrArray		*auth_array;
-	GHashTable		*cache;
-	GMutex			 cache_mutex;
+	GHashTable		*cache;		/* key:GsPluginCacheEntry */
+	GRWLock			 cache_lock;
+	guint			 cache_max_size;	/* 0 for unlimited */
+	guint			 cache_max_age;		/* seconds, 0 for unlimited */
+	guint			 cache_strong;		/* entries holding a ref */
+	gint			 cache_sweep;		/* seconds */
+	gint			 cache_tick;		/* atomic */
+	gint			 cache_hits;		/* atomic */
+	gint			 cache_misses;		/* atomic */
+	gint			 cache_evictions;	/* atomic */
 	GModule			*module;
 	GsPluginData		*data;			/* for gs-plugin-{name}.c */
 	GsPluginFlags		 flags;
@@ -83,7 +105,10 @@ typedef struct
 	guint			 priority;
 	guint			 timer_id;
 	GMutex			 timer_mutex;
+	guint64			 download_bytes;
+	GMutex			 download_bytes_mutex;
 	GNetworkMonitor		*network_monitor;
+	GsPluginStats		*stats[GS_PLUGIN_ACTION_LAST];	/* atomic, allocated on use */
 } GsPluginPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (GsPlugin, gs_plugin, G_TYPE_OBJECT)
@@ -231,9 +256,12 @@ gs_plugin_finalize (GObject *object)
 		g_object_unref (priv->network_monitor);
 	g_hash_table_unref (priv->cache);
 	g_hash_table_unref (priv->vfuncs);
-	g_mutex_clear (&priv->cache_mutex);
+	for (guint i = 0; i < GS_PLUGIN_ACTION_LAST; i++)
+		g_free (priv->stats[i]);
+	g_rw_lock_clear (&priv->cache_lock);
 	g_mutex_clear (&priv->interactive_mutex);
 	g_mutex_clear (&priv->timer_mutex);
+	g_mutex_clear (&priv->download_bytes_mutex);
 	g_mutex_clear (&priv->vfuncs_mutex);
 #ifndef RUNNING_ON_VALGRIND
 	if (priv->module != NULL)
@@ -542,6 +570,181 @@ gs_plugin_set_priority (GsPlugin *plugin, guint priority)
 	priv->priority = priority;
 }
 
+/**
+ * gs_plugin_get_download_bytes:
+ * @plugin: a #GsPlugin
+ *
+ * Gets the total number of bytes fetched by the plugin, as counted by
+ * gs_plugin_add_download_bytes().
+ *
+ * Returns: a byte count
+ *
+ * Since: 3.32
+ **/
+guint64
+gs_plugin_get_download_bytes (GsPlugin *plugin)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->download_bytes_mutex);
+	return priv->download_bytes;
+}
+
+/**
+ * gs_plugin_add_download_bytes:
+ * @plugin: a #GsPlugin
+ * @bytes: the number of bytes fetched
+ *
+ * Adds to the number of bytes the plugin has fetched from the network, so
+ * that the job that is running the plugin can be charged for them.
+ *
+ * This is done automatically for gs_plugin_download_data() and
+ * gs_plugin_download_file(), and should be called by plugins that fetch data
+ * some other way, for instance using a daemon or library. It can be called
+ * from any thread, including ones started by the plugin itself.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_add_download_bytes (GsPlugin *plugin, guint64 bytes)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail (GS_IS_PLUGIN (plugin));
+
+	locker = g_mutex_locker_new (&priv->download_bytes_mutex);
+	priv->download_bytes += bytes;
+}
+
+static guint
+gs_plugin_stats_bucket (gint64 duration)
+{
+	guint bits;
+	guint half;
+
+	if (duration < 2)
+		return 0;
+	bits = g_bit_storage ((gulong) duration);
+	half = (duration >> (bits - 2)) & 1;
+	return MIN (bits * 2 - 3 + half, GS_PLUGIN_STATS_BUCKETS - 1);
+}
+
+/* the largest duration that would be put in the bucket */
+static guint64
+gs_plugin_stats_bucket_max (guint idx)
+{
+	guint half = (idx + 1) % 2;
+	guint bits = (idx + 3 - half) / 2;
+
+	if (idx == 0)
+		return 1;
+	if (half)
+		return ((guint64) 1 << bits) - 1;
+	return ((guint64) 1 << (bits - 1)) + ((guint64) 1 << (bits - 2)) - 1;
+}
+
+static guint64
+gs_plugin_stats_percentile (const gint *buckets, guint total, guint percentile)
+{
+	guint64 cnt = 0;
+	guint64 target = ((guint64) total * percentile + 99) / 100;
+
+	for (guint i = 0; i < GS_PLUGIN_STATS_BUCKETS; i++) {
+		cnt += (guint) buckets[i];
+		if (cnt >= target)
+			return gs_plugin_stats_bucket_max (i);
+	}
+	return gs_plugin_stats_bucket_max (GS_PLUGIN_STATS_BUCKETS - 1);
+}
+
+/**
+ * gs_plugin_add_stats:
+ * @plugin: a #GsPlugin
+ * @action: a #GsPluginAction
+ * @duration: how long the vfunc took, in microseconds
+ * @n_apps: the number of applications that were processed
+ * @error: (allow-none): the error the vfunc returned
+ *
+ * Records a call of a plugin vfunc. This is cheap enough to always be done,
+ * and can be called from any thread.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_add_stats (GsPlugin *plugin,
+		     GsPluginAction action,
+		     gint64 duration,
+		     guint n_apps,
+		     const GError *error)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	GsPluginStats *stats;
+
+	g_return_if_fail (action < GS_PLUGIN_ACTION_LAST);
+
+	stats = g_atomic_pointer_get (&priv->stats[action]);
+	if (stats == NULL) {
+		GsPluginStats *stats_new = g_new0 (GsPluginStats, 1);
+		if (!g_atomic_pointer_compare_and_exchange (&priv->stats[action],
+							    NULL, stats_new))
+			g_free (stats_new);
+		stats = g_atomic_pointer_get (&priv->stats[action]);
+	}
+	g_atomic_int_inc (&stats->calls);
+	g_atomic_int_add (&stats->apps, (gint) n_apps);
+	if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_TIMED_OUT))
+		g_atomic_int_inc (&stats->timeouts);
+	else if (error != NULL &&
+		 !g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
+		g_atomic_int_inc (&stats->errors);
+	g_atomic_int_inc (&stats->buckets[gs_plugin_stats_bucket (duration)]);
+}
+
+/**
+ * gs_plugin_get_stats:
+ * @plugin: a #GsPlugin
+ *
+ * Gets what gs_plugin_add_stats() recorded for each action.
+ *
+ * Returns: (transfer floating): a #GVariant of type `a(suuuuttt)` with the
+ * action, the number of calls, errors, timeouts and applications, and the
+ * 50th, 95th and 99th percentile of the latency in microseconds
+ *
+ * Since: 3.32
+ **/
+GVariant *
+gs_plugin_get_stats (GsPlugin *plugin)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(suuuuttt)"));
+	for (guint i = 0; i < GS_PLUGIN_ACTION_LAST; i++) {
+		GsPluginStats *stats = g_atomic_pointer_get (&priv->stats[i]);
+		gint buckets[GS_PLUGIN_STATS_BUCKETS];
+		guint total = 0;
+
+		if (stats == NULL)
+			continue;
+
+		/* the percentiles are of the calls counted in the buckets */
+		for (guint j = 0; j < GS_PLUGIN_STATS_BUCKETS; j++) {
+			buckets[j] = g_atomic_int_get (&stats->buckets[j]);
+			total += (guint) buckets[j];
+		}
+		g_variant_builder_add (&builder, "(suuuuttt)",
+				       gs_plugin_action_to_string (i),
+				       (guint) g_atomic_int_get (&stats->calls),
+				       (guint) g_atomic_int_get (&stats->errors),
+				       (guint) g_atomic_int_get (&stats->timeouts),
+				       (guint) g_atomic_int_get (&stats->apps),
+				       gs_plugin_stats_percentile (buckets, total, 50),
+				       gs_plugin_stats_percentile (buckets, total, 95),
+				       gs_plugin_stats_percentile (buckets, total, 99));
+	}
+	return g_variant_builder_end (&builder);
+}
+
 /**
  * gs_plugin_get_locale:
  * @plugin: a #GsPlugin
@@ -1142,6 +1345,7 @@ gs_plugin_download_data (GsPlugin *plugin,
 			     uri, str->str);
 		return NULL;
 	}
+	gs_plugin_add_download_bytes (plugin, (guint64) msg->response_body->length);
 	return g_bytes_new (msg->response_body->data,
 			    (gsize) msg->response_body->length);
 }
@@ -1237,6 +1441,7 @@ gs_plugin_download_file (GsPlugin *plugin,
 			     uri, str->str);
 		return FALSE;
 	}
+	gs_plugin_add_download_bytes (plugin, (guint64) msg->response_body->length);
 	if (!gs_mkdir_parent (filename, error))
 		return FALSE;
 	if (!g_file_set_contents (filename,
@@ -1368,6 +1573,139 @@ gs_plugin_download_rewrite_resource (GsPlugin *plugin,
 	return g_strdup (str->str);
 }
 
+/* once there are too many apps, drop this fraction so that each add does
+ * not have to walk the cache */
+#define GS_PLUGIN_CACHE_EVICT_SLACK	8
+
+struct _GsPluginCacheEntry {
+	GsApp			*app;		/* nullable, only when in use */
+	GWeakRef		 weak;
+	gint			 tick;		/* atomic */
+	gint			 atime;		/* atomic, seconds */
+};
+
+static gint
+gs_plugin_cache_now (void)
+{
+	return (gint) (g_get_monotonic_time () / G_USEC_PER_SEC);
+}
+
+static GsPluginCacheEntry *
+gs_plugin_cache_entry_new (GsPlugin *plugin, GsApp *app)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	GsPluginCacheEntry *entry = g_slice_new0 (GsPluginCacheEntry);
+	entry->app = g_object_ref (app);
+	g_weak_ref_init (&entry->weak, app);
+	entry->tick = g_atomic_int_add (&priv->cache_tick, 1);
+	entry->atime = gs_plugin_cache_now ();
+	return entry;
+}
+
+static void
+gs_plugin_cache_entry_free (GsPluginCacheEntry *entry)
+{
+	g_weak_ref_clear (&entry->weak);
+	if (entry->app != NULL)
+		g_object_unref (entry->app);
+	g_slice_free (GsPluginCacheEntry, entry);
+}
+
+static void
+gs_plugin_cache_entry_touch (GsPlugin *plugin, GsPluginCacheEntry *entry)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	g_atomic_int_set (&entry->tick, g_atomic_int_add (&priv->cache_tick, 1));
+	g_atomic_int_set (&entry->atime, gs_plugin_cache_now ());
+}
+
+/* drops the cache reference, so the app is freed as soon as nothing else
+ * uses it but can still be found until then */
+static void
+gs_plugin_cache_entry_demote (GsPlugin *plugin, GsPluginCacheEntry *entry)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	g_clear_object (&entry->app);
+	priv->cache_strong--;
+	g_atomic_int_inc (&priv->cache_evictions);
+}
+
+static gboolean
+gs_plugin_cache_entry_is_dead (GsPluginCacheEntry *entry)
+{
+	g_autoptr(GsApp) app = NULL;
+	if (entry->app != NULL)
+		return FALSE;
+	app = g_weak_ref_get (&entry->weak);
+	return app == NULL;
+}
+
+static gint
+gs_plugin_cache_entry_sort_cb (gconstpointer a, gconstpointer b)
+{
+	GsPluginCacheEntry *entry1 = *((GsPluginCacheEntry **) a);
+	GsPluginCacheEntry *entry2 = *((GsPluginCacheEntry **) b);
+	gint tick1 = g_atomic_int_get (&entry1->tick);
+	gint tick2 = g_atomic_int_get (&entry2->tick);
+	if (tick1 < tick2)
+		return -1;
+	if (tick1 > tick2)
+		return 1;
+	return 0;
+}
+
+/* must be called with the cache write lock held */
+static void
+gs_plugin_cache_evict_unlocked (GsPlugin *plugin)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	GHashTableIter iter;
+	GsPluginCacheEntry *entry;
+	gint now;
+	g_autoptr(GPtrArray) strong = NULL;
+
+	/* unbounded */
+	if (priv->cache_max_size == 0 && priv->cache_max_age == 0)
+		return;
+
+	/* not long enough since the last sweep, and not too many apps */
+	now = gs_plugin_cache_now ();
+	if ((priv->cache_max_age == 0 ||
+	     now - priv->cache_sweep < (gint) MAX (priv->cache_max_age / 2, 1)) &&
+	    (priv->cache_max_size == 0 ||
+	     priv->cache_strong <= priv->cache_max_size))
+		return;
+	priv->cache_sweep = now;
+
+	/* forget the apps that have been freed, and stop keeping alive the
+	 * ones that have not been used for a while */
+	strong = g_ptr_array_new ();
+	g_hash_table_iter_init (&iter, priv->cache);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+		if (gs_plugin_cache_entry_is_dead (entry)) {
+			g_hash_table_iter_remove (&iter);
+			continue;
+		}
+		if (entry->app == NULL)
+			continue;
+		if (priv->cache_max_age > 0 &&
+		    now - g_atomic_int_get (&entry->atime) > (gint) priv->cache_max_age) {
+			gs_plugin_cache_entry_demote (plugin, entry);
+			continue;
+		}
+		g_ptr_array_add (strong, entry);
+	}
+
+	/* too many, so drop the least recently used */
+	if (priv->cache_max_size > 0 && priv->cache_strong > priv->cache_max_size) {
+		guint target = priv->cache_max_size -
+			       priv->cache_max_size / GS_PLUGIN_CACHE_EVICT_SLACK;
+		g_ptr_array_sort (strong, gs_plugin_cache_entry_sort_cb);
+		for (guint i = 0; i < strong->len && priv->cache_strong > target; i++)
+			gs_plugin_cache_entry_demote (plugin, g_ptr_array_index (strong, i));
+	}
+}
+
 /**
  * gs_plugin_cache_lookup:
  * @plugin: a #GsPlugin
@@ -1383,17 +1721,46 @@ GsApp *
 gs_plugin_cache_lookup (GsPlugin *plugin, const gchar *key)
 {
 	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
-	GsApp *app;
-	g_autoptr(GMutexLocker) locker = NULL;
+	GsPluginCacheEntry *entry;
+	GsApp *app = NULL;
+	gboolean promote = FALSE;
 
 	g_return_val_if_fail (GS_IS_PLUGIN (plugin), NULL);
 	g_return_val_if_fail (key != NULL, NULL);
 
-	locker = g_mutex_locker_new (&priv->cache_mutex);
-	app = g_hash_table_lookup (priv->cache, key);
-	if (app == NULL)
+	/* lookups vastly outnumber adds, so only take the read lock */
+	g_rw_lock_reader_lock (&priv->cache_lock);
+	entry = g_hash_table_lookup (priv->cache, key);
+	if (entry != NULL) {
+		if (entry->app != NULL) {
+			app = g_object_ref (entry->app);
+		} else {
+			app = g_weak_ref_get (&entry->weak);
+			promote = app != NULL;
+		}
+		if (app != NULL)
+			gs_plugin_cache_entry_touch (plugin, entry);
+	}
+	g_rw_lock_reader_unlock (&priv->cache_lock);
+	if (app == NULL) {
+		g_atomic_int_inc (&priv->cache_misses);
 		return NULL;
-	return g_object_ref (app);
+	}
+	g_atomic_int_inc (&priv->cache_hits);
+
+	/* in use again, so keep it alive */
+	if (promote) {
+		g_rw_lock_writer_lock (&priv->cache_lock);
+		entry = g_hash_table_lookup (priv->cache, key);
+		if (entry != NULL && entry->app == NULL &&
+		    !gs_plugin_cache_entry_is_dead (entry)) {
+			entry->app = g_object_ref (app);
+			priv->cache_strong++;
+			gs_plugin_cache_evict_unlocked (plugin);
+		}
+		g_rw_lock_writer_unlock (&priv->cache_lock);
+	}
+	return app;
 }
 
 /**
@@ -1409,13 +1776,19 @@ void
 gs_plugin_cache_remove (GsPlugin *plugin, const gchar *key)
 {
 	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
-	g_autoptr(GMutexLocker) locker = NULL;
+	GsPluginCacheEntry *entry;
 
 	g_return_if_fail (GS_IS_PLUGIN (plugin));
 	g_return_if_fail (key != NULL);
 
-	locker = g_mutex_locker_new (&priv->cache_mutex);
-	g_hash_table_remove (priv->cache, key);
+	g_rw_lock_writer_lock (&priv->cache_lock);
+	entry = g_hash_table_lookup (priv->cache, key);
+	if (entry != NULL) {
+		if (entry->app != NULL)
+			priv->cache_strong--;
+		g_hash_table_remove (priv->cache, key);
+	}
+	g_rw_lock_writer_unlock (&priv->cache_lock);
 }
 
 /**
@@ -1427,28 +1800,41 @@ gs_plugin_cache_remove (GsPlugin *plugin, const gchar *key)
  * Adds an application to the per-plugin cache. This is optional,
  * and the plugin can use the cache however it likes.
  *
+ * If gs_plugin_cache_set_max_size() or gs_plugin_cache_set_max_age() have
+ * been used, adding an application may cause the cache to stop keeping the
+ * least recently used ones alive.
+ *
  * Since: 3.22
  **/
 void
 gs_plugin_cache_add (GsPlugin *plugin, const gchar *key, GsApp *app)
 {
 	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
-	g_autoptr(GMutexLocker) locker = NULL;
+	GsPluginCacheEntry *entry;
 
 	g_return_if_fail (GS_IS_PLUGIN (plugin));
 	g_return_if_fail (GS_IS_APP (app));
 
-	locker = g_mutex_locker_new (&priv->cache_mutex);
-
 	/* default */
 	if (key == NULL)
 		key = gs_app_get_unique_id (app);
 
 	g_return_if_fail (key != NULL);
 
-	if (g_hash_table_lookup (priv->cache, key) == app)
+	g_rw_lock_writer_lock (&priv->cache_lock);
+	entry = g_hash_table_lookup (priv->cache, key);
+	if (entry != NULL && entry->app == app) {
+		gs_plugin_cache_entry_touch (plugin, entry);
+		g_rw_lock_writer_unlock (&priv->cache_lock);
 		return;
-	g_hash_table_insert (priv->cache, g_strdup (key), g_object_ref (app));
+	}
+	if (entry != NULL && entry->app != NULL)
+		priv->cache_strong--;
+	g_hash_table_insert (priv->cache, g_strdup (key),
+			     gs_plugin_cache_entry_new (plugin, app));
+	priv->cache_strong++;
+	gs_plugin_cache_evict_unlocked (plugin);
+	g_rw_lock_writer_unlock (&priv->cache_lock);
 }
 
 /**
@@ -1469,12 +1855,130 @@ void
 gs_plugin_cache_invalidate (GsPlugin *plugin)
 {
 	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
-	g_autoptr(GMutexLocker) locker = NULL;
 
 	g_return_if_fail (GS_IS_PLUGIN (plugin));
 
-	locker = g_mutex_locker_new (&priv->cache_mutex);
+	g_rw_lock_writer_lock (&priv->cache_lock);
 	g_hash_table_remove_all (priv->cache);
+	priv->cache_strong = 0;
+	g_rw_lock_writer_unlock (&priv->cache_lock);
+}
+
+/**
+ * gs_plugin_cache_set_max_size:
+ * @plugin: a #GsPlugin
+ * @max_size: the number of applications, or 0 for no limit
+ *
+ * Sets how many applications the per-plugin cache keeps alive. When there
+ * are more, the least recently used are only kept as long as something
+ * else holds a reference to them, so lookups still return the same object
+ * for as long as it exists.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_cache_set_max_size (GsPlugin *plugin, guint max_size)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+
+	g_return_if_fail (GS_IS_PLUGIN (plugin));
+
+	g_rw_lock_writer_lock (&priv->cache_lock);
+	priv->cache_max_size = max_size;
+	gs_plugin_cache_evict_unlocked (plugin);
+	g_rw_lock_writer_unlock (&priv->cache_lock);
+}
+
+/**
+ * gs_plugin_cache_set_max_age:
+ * @plugin: a #GsPlugin
+ * @max_age: the number of seconds, or 0 for no limit
+ *
+ * Sets how long the per-plugin cache keeps alive an application that has
+ * not been looked up. Like gs_plugin_cache_set_max_size(), the application
+ * can still be found for as long as something else holds a reference to it.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_cache_set_max_age (GsPlugin *plugin, guint max_age)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+
+	g_return_if_fail (GS_IS_PLUGIN (plugin));
+
+	g_rw_lock_writer_lock (&priv->cache_lock);
+	priv->cache_max_age = max_age;
+	priv->cache_sweep = 0;
+	gs_plugin_cache_evict_unlocked (plugin);
+	g_rw_lock_writer_unlock (&priv->cache_lock);
+}
+
+/**
+ * gs_plugin_cache_get_size:
+ * @plugin: a #GsPlugin
+ * @size: (out) (allow-none): roughly how much memory the cached apps use
+ *
+ * Gets how many applications the per-plugin cache is keeping alive.
+ *
+ * Returns: the number of cached applications
+ *
+ * Since: 3.32
+ **/
+guint
+gs_plugin_cache_get_size (GsPlugin *plugin, guint64 *size)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+	GHashTableIter iter;
+	GsPluginCacheEntry *entry;
+	g_autoptr(GPtrArray) apps = g_ptr_array_new_with_free_func (g_object_unref);
+
+	g_return_val_if_fail (GS_IS_PLUGIN (plugin), 0);
+
+	/* do not hold the lock while looking at the apps */
+	g_rw_lock_reader_lock (&priv->cache_lock);
+	g_hash_table_iter_init (&iter, priv->cache);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+		if (entry->app != NULL)
+			g_ptr_array_add (apps, g_object_ref (entry->app));
+	}
+	g_rw_lock_reader_unlock (&priv->cache_lock);
+
+	if (size != NULL) {
+		*size = 0;
+		for (guint i = 0; i < apps->len; i++)
+			*size += gs_app_get_size_retained (g_ptr_array_index (apps, i));
+	}
+	return apps->len;
+}
+
+/**
+ * gs_plugin_cache_get_stats:
+ * @plugin: a #GsPlugin
+ * @hits: (out) (allow-none): lookups that found an application
+ * @misses: (out) (allow-none): lookups that found nothing
+ * @evictions: (out) (allow-none): applications no longer kept alive
+ *
+ * Gets how well the per-plugin cache is working.
+ *
+ * Since: 3.32
+ **/
+void
+gs_plugin_cache_get_stats (GsPlugin *plugin,
+			   guint *hits,
+			   guint *misses,
+			   guint *evictions)
+{
+	GsPluginPrivate *priv = gs_plugin_get_instance_private (plugin);
+
+	g_return_if_fail (GS_IS_PLUGIN (plugin));
+
+	if (hits != NULL)
+		*hits = (guint) g_atomic_int_get (&priv->cache_hits);
+	if (misses != NULL)
+		*misses = (guint) g_atomic_int_get (&priv->cache_misses);
+	if (evictions != NULL)
+		*evictions = (guint) g_atomic_int_get (&priv->cache_evictions);
 }
 
 /**
@@ -2059,12 +2563,13 @@ gs_plugin_init (GsPlugin *plugin)
 	priv->cache = g_hash_table_new_full ((GHashFunc) as_utils_unique_id_hash,
 					     (GEqualFunc) as_utils_unique_id_equal,
 					     g_free,
-					     (GDestroyNotify) g_object_unref);
+					     (GDestroyNotify) gs_plugin_cache_entry_free);
 	priv->vfuncs = g_hash_table_new_full (g_str_hash, g_str_equal,
 					      g_free, NULL);
-	g_mutex_init (&priv->cache_mutex);
+	g_rw_lock_init (&priv->cache_lock);
 	g_mutex_init (&priv->interactive_mutex);
 	g_mutex_init (&priv->timer_mutex);
+	g_mutex_init (&priv->download_bytes_mutex);
 	g_mutex_init (&priv->vfuncs_mutex);
 }
 
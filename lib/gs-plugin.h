@@ -106,6 +106,8 @@ gboolean	 gs_plugin_download_file		(GsPlugin	*plugin,
 							 const gchar	*filename,
 							 GCancellable	*cancellable,
 							 GError		**error);
+void		 gs_plugin_add_download_bytes		(GsPlugin	*plugin,
+							 guint64	 bytes);
 gchar		*gs_plugin_download_rewrite_resource	(GsPlugin	*plugin,
 							 GsApp		*app,
 							 const gchar	*resource,
@@ -122,6 +124,10 @@ void		 gs_plugin_cache_add			(GsPlugin	*plugin,
 void		 gs_plugin_cache_remove			(GsPlugin	*plugin,
 							 const gchar	*key);
 void		 gs_plugin_cache_invalidate		(GsPlugin	*plugin);
+void		 gs_plugin_cache_set_max_size		(GsPlugin	*plugin,
+							 guint		 max_size);
+void		 gs_plugin_cache_set_max_age		(GsPlugin	*plugin,
+							 guint		 max_age);
 void		 gs_plugin_status_update		(GsPlugin	*plugin,
 							 GsApp		*app,
 							 GsPluginStatus	 status);
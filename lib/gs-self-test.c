@@ -22,9 +22,12 @@
 
 #include "config.h"
 
+#include <json-glib/json-glib.h>
+
 #include "gnome-software-private.h"
 
 #include "gs-test.h"
+#include "gs-trace.h"
 
 static gboolean
 gs_app_list_filter_cb (GsApp *app, gpointer user_data)
@@ -264,6 +267,141 @@ gs_plugin_download_rewrite_func (void)
 	g_assert (css != NULL);
 }
 
+static void
+gs_plugin_stats_func (void)
+{
+	const gchar *action = NULL;
+	guint calls, errors, timeouts, apps;
+	guint64 p50, p95, p99;
+	g_autoptr(GError) error_failed = NULL;
+	g_autoptr(GError) error_timeout = NULL;
+	g_autoptr(GsPlugin) plugin = gs_plugin_new ();
+	g_autoptr(GVariant) stats = NULL;
+
+	/* nothing called yet */
+	stats = g_variant_ref_sink (gs_plugin_get_stats (plugin));
+	g_assert_cmpint (g_variant_n_children (stats), ==, 0);
+	g_clear_pointer (&stats, g_variant_unref);
+
+	/* mostly fast, with a slow tail */
+	g_set_error_literal (&error_failed, GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_FAILED, "failed");
+	g_set_error_literal (&error_timeout, GS_PLUGIN_ERROR,
+			     GS_PLUGIN_ERROR_TIMED_OUT, "timeout");
+	for (guint i = 0; i < 90; i++)
+		gs_plugin_add_stats (plugin, GS_PLUGIN_ACTION_SEARCH, 100, 2, NULL);
+	for (guint i = 0; i < 8; i++)
+		gs_plugin_add_stats (plugin, GS_PLUGIN_ACTION_SEARCH, 10000, 2, NULL);
+	gs_plugin_add_stats (plugin, GS_PLUGIN_ACTION_SEARCH, 10000, 0, error_failed);
+	gs_plugin_add_stats (plugin, GS_PLUGIN_ACTION_SEARCH, 10000, 0, error_timeout);
+
+	/* the percentiles are the upper bound of the bucket */
+	stats = g_variant_ref_sink (gs_plugin_get_stats (plugin));
+	g_assert_cmpint (g_variant_n_children (stats), ==, 1);
+	g_variant_get_child (stats, 0, "(&suuuuttt)", &action,
+			     &calls, &errors, &timeouts, &apps,
+			     &p50, &p95, &p99);
+	g_assert_cmpstr (action, ==, "search");
+	g_assert_cmpint (calls, ==, 100);
+	g_assert_cmpint (errors, ==, 1);
+	g_assert_cmpint (timeouts, ==, 1);
+	g_assert_cmpint (apps, ==, 196);
+	g_assert_cmpint (p50, ==, 127);
+	g_assert_cmpint (p95, ==, 12287);
+	g_assert_cmpint (p99, ==, 12287);
+}
+
+static void
+gs_trace_func (void)
+{
+	JsonArray *json_events;
+	g_autofree gchar *json = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) states = g_ptr_array_new ();
+	g_autoptr(GsApp) app = gs_app_new ("trace.desktop");
+	g_autoptr(JsonParser) parser = json_parser_new ();
+
+	/* go through an install, as the loader would */
+	gs_app_set_state (app, AS_APP_STATE_AVAILABLE);
+	gs_trace_set_context ("dummy", 42);
+	gs_app_set_pending_action (app, GS_PLUGIN_ACTION_INSTALL);
+	gs_app_set_state (app, AS_APP_STATE_INSTALLING);
+	gs_app_set_progress (app, 50);
+	gs_app_set_state (app, AS_APP_STATE_INSTALLED);
+	gs_trace_set_context (NULL, 0);
+
+	/* each state is a span on the track of the app */
+	json = gs_trace_to_json ();
+	g_assert (json_parser_load_from_data (parser, json, -1, &error));
+	g_assert_no_error (error);
+	json_events = json_object_get_array_member (json_node_get_object (json_parser_get_root (parser)),
+						    "traceEvents");
+	for (guint i = 0; i < json_array_get_length (json_events); i++) {
+		JsonObject *obj = json_array_get_object_element (json_events, i);
+		JsonObject *args = json_object_get_object_member (obj, "args");
+		if (g_strcmp0 (json_object_get_string_member (obj, "cat"), "state") != 0)
+			continue;
+		if (g_strcmp0 (json_object_get_string_member (obj, "ph"), "b") != 0)
+			continue;
+		if (g_strcmp0 (json_object_get_string_member (args, "app"),
+			       "*/*/*/*/trace.desktop/*") != 0)
+			continue;
+		g_ptr_array_add (states, (gpointer) json_object_get_string_member (obj, "name"));
+		if (g_strcmp0 (json_object_get_string_member (obj, "name"), "installing") == 0) {
+			g_assert_cmpstr (json_object_get_string_member (args, "plugin"), ==, "dummy");
+			g_assert_cmpint (json_object_get_int_member (args, "job"), ==, 42);
+		}
+	}
+	g_assert_cmpint (states->len, ==, 3);
+	g_assert_cmpstr (g_ptr_array_index (states, 0), ==, "available");
+	g_assert_cmpstr (g_ptr_array_index (states, 1), ==, "installing");
+	g_assert_cmpstr (g_ptr_array_index (states, 2), ==, "installed");
+}
+
+static void
+gs_plugin_cache_func (void)
+{
+	guint hits, misses, evictions;
+	g_autoptr(GsApp) app_a = gs_app_new ("a.desktop");
+	g_autoptr(GsApp) app_tmp = NULL;
+	g_autoptr(GsPlugin) plugin = gs_plugin_new ();
+
+	/* only keep two apps alive */
+	gs_plugin_cache_set_max_size (plugin, 2);
+	gs_plugin_cache_add (plugin, NULL, app_a);
+	app_tmp = gs_app_new ("b.desktop");
+	gs_plugin_cache_add (plugin, NULL, app_tmp);
+	g_clear_object (&app_tmp);
+	app_tmp = gs_app_new ("c.desktop");
+	gs_plugin_cache_add (plugin, NULL, app_tmp);
+	g_clear_object (&app_tmp);
+	g_assert_cmpint (gs_plugin_cache_get_size (plugin, NULL), ==, 2);
+
+	/* the oldest is still in use elsewhere, so can be found, and as it is
+	 * now the most recently used the next oldest gets freed */
+	app_tmp = gs_plugin_cache_lookup (plugin, "*/*/*/*/a.desktop/*");
+	g_assert (app_tmp == app_a);
+	g_clear_object (&app_tmp);
+	app_tmp = gs_plugin_cache_lookup (plugin, "*/*/*/*/b.desktop/*");
+	g_assert (app_tmp == NULL);
+	app_tmp = gs_plugin_cache_lookup (plugin, "*/*/*/*/c.desktop/*");
+	g_assert (app_tmp != NULL);
+	g_clear_object (&app_tmp);
+	g_assert_cmpint (gs_plugin_cache_get_size (plugin, NULL), ==, 2);
+
+	gs_plugin_cache_get_stats (plugin, &hits, &misses, &evictions);
+	g_assert_cmpint (hits, ==, 2);
+	g_assert_cmpint (misses, ==, 1);
+	g_assert_cmpint (evictions, ==, 2);
+
+	/* unbounded again */
+	gs_plugin_cache_set_max_size (plugin, 0);
+	app_tmp = gs_app_new ("d.desktop");
+	gs_plugin_cache_add (plugin, NULL, app_tmp);
+	g_clear_object (&app_tmp);
+	g_assert_cmpint (gs_plugin_cache_get_size (plugin, NULL), ==, 3);
+}
+
 static void
 gs_plugin_func (void)
 {
@@ -567,6 +705,128 @@ gs_plugin_func (void)
 	g_assert_cmpint (gs_app_list_length (list), ==, 0);
 	g_assert_cmpint (gs_app_list_get_size_peak (list), ==, 3);
 	g_object_unref (list);
+
+	/* skip the start of the list */
+	list = gs_app_list_new ();
+	app = gs_app_new ("a");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_app_new ("b");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_app_new ("c");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	gs_app_list_skip (list, 0);
+	g_assert_cmpint (gs_app_list_length (list), ==, 3);
+	gs_app_list_skip (list, 2);
+	g_assert_cmpint (gs_app_list_length (list), ==, 1);
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list, 0)), ==, "c");
+	g_assert (!gs_app_list_has_flag (list, GS_APP_LIST_FLAG_IS_TRUNCATED));
+	app = gs_app_new ("a");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	g_assert_cmpint (gs_app_list_length (list), ==, 2);
+	gs_app_list_skip (list, 10);
+	g_assert_cmpint (gs_app_list_length (list), ==, 0);
+	g_object_unref (list);
+}
+
+static gint
+gs_app_list_sort_rating_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	return gs_app_get_rating (app2) - gs_app_get_rating (app1);
+}
+
+static void
+gs_app_list_sort_truncate_func (void)
+{
+	g_autoptr(GsAppList) list1 = gs_app_list_new ();
+	g_autoptr(GsAppList) list2 = gs_app_list_new ();
+
+	/* lots of ties, so the order has to match a stable sort */
+	for (guint i = 0; i < 100; i++) {
+		g_autofree gchar *id = g_strdup_printf ("app%03u", i);
+		g_autoptr(GsApp) app = gs_app_new (id);
+		gs_app_set_rating (app, (gint) ((i * 37) % 10));
+		gs_app_list_add (list1, app);
+		gs_app_list_add (list2, app);
+	}
+	gs_app_list_sort_truncate (list1, 7, gs_app_list_sort_rating_cb, NULL);
+	gs_app_list_sort (list2, gs_app_list_sort_rating_cb, NULL);
+	gs_app_list_truncate (list2, 7);
+	g_assert_cmpint (gs_app_list_length (list1), ==, 7);
+	g_assert (gs_app_list_has_flag (list1, GS_APP_LIST_FLAG_IS_TRUNCATED));
+	for (guint i = 0; i < 7; i++) {
+		g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list1, i)), ==,
+				 gs_app_get_id (gs_app_list_index (list2, i)));
+	}
+	g_assert (gs_app_list_lookup (list1, "*/*/*/*/app000/*") == NULL);
+
+	/* nothing to remove */
+	gs_app_list_sort_truncate (list2, 10, gs_app_list_sort_rating_cb, NULL);
+	g_assert_cmpint (gs_app_list_length (list2), ==, 7);
+}
+
+static void
+gs_app_memory_func (void)
+{
+	guint apps_before = 0;
+	guint apps_after = 0;
+	guint64 size = 0;
+	const gchar *unique_id = NULL;
+	g_autofree gchar *description = g_strnfill (1024 * 1024, 'x');
+	g_autoptr(GsApp) app = gs_app_new ("memory.desktop");
+	g_autoptr(GVariant) stats = NULL;
+	g_autoptr(GVariant) largest = NULL;
+
+	/* the long description makes this the largest */
+	stats = g_variant_ref_sink (gs_app_get_memory_stats (1));
+	g_assert (g_variant_lookup (stats, "apps", "u", &apps_before));
+	g_clear_pointer (&stats, g_variant_unref);
+	gs_app_set_description (app, GS_APP_QUALITY_NORMAL, description);
+	g_assert_cmpint (gs_app_get_size_retained (app), >, 1024 * 1024);
+	stats = g_variant_ref_sink (gs_app_get_memory_stats (1));
+	largest = g_variant_lookup_value (stats, "largest", G_VARIANT_TYPE ("a(st)"));
+	g_assert_cmpint (g_variant_n_children (largest), ==, 1);
+	g_variant_get_child (largest, 0, "(&st)", &unique_id, &size);
+	g_assert_cmpstr (unique_id, ==, "*/*/*/*/memory.desktop/*");
+	g_assert_cmpint (size, ==, gs_app_get_size_retained (app));
+	g_clear_pointer (&largest, g_variant_unref);
+	g_clear_pointer (&stats, g_variant_unref);
+
+	/* no longer counted */
+	g_clear_object (&app);
+	stats = g_variant_ref_sink (gs_app_get_memory_stats (1));
+	g_assert (g_variant_lookup (stats, "apps", "u", &apps_after));
+	g_assert_cmpint (apps_after, ==, apps_before - 1);
+}
+
+static gpointer
+gs_plugin_download_bytes_thread_cb (gpointer data)
+{
+	GsPlugin *plugin = GS_PLUGIN (data);
+	for (guint i = 0; i < 1000; i++)
+		gs_plugin_add_download_bytes (plugin, 3);
+	return NULL;
+}
+
+static void
+gs_plugin_download_bytes_func (void)
+{
+	GThread *threads[4];
+	g_autoptr(GsPlugin) plugin = gs_plugin_new ();
+
+	/* bytes fetched by threads the plugin started are counted too */
+	g_assert_cmpint (gs_plugin_get_download_bytes (plugin), ==, 0);
+	for (guint i = 0; i < G_N_ELEMENTS (threads); i++) {
+		threads[i] = g_thread_new ("download-bytes",
+					   gs_plugin_download_bytes_thread_cb,
+					   plugin);
+	}
+	for (guint i = 0; i < G_N_ELEMENTS (threads); i++)
+		g_thread_join (threads[i]);
+	g_assert_cmpint (gs_plugin_get_download_bytes (plugin), ==, 12000);
 }
 
 static gpointer
@@ -615,6 +875,30 @@ gs_app_unique_id_func (void)
 	g_assert_cmpstr (gs_app_get_branch (app), ==, "master");
 }
 
+static void
+gs_app_name_sort_key_func (void)
+{
+	g_autoptr(GsApp) app1 = gs_app_new (NULL);
+	g_autoptr(GsApp) app2 = gs_app_new (NULL);
+	g_autofree gchar *key = NULL;
+
+	/* unset */
+	g_assert_null (gs_app_get_name_sort_key (app1));
+
+	/* case-insensitive */
+	gs_app_set_name (app1, GS_APP_QUALITY_NORMAL, "apple");
+	gs_app_set_name (app2, GS_APP_QUALITY_NORMAL, "Banana");
+	g_assert_cmpint (g_strcmp0 (gs_app_get_name_sort_key (app1),
+				    gs_app_get_name_sort_key (app2)), <, 0);
+
+	/* invalidated when the name changes */
+	key = g_strdup (gs_app_get_name_sort_key (app1));
+	gs_app_set_name (app1, GS_APP_QUALITY_HIGHEST, "Cherry");
+	g_assert_cmpstr (gs_app_get_name_sort_key (app1), !=, key);
+	g_assert_cmpint (g_strcmp0 (gs_app_get_name_sort_key (app1),
+				    gs_app_get_name_sort_key (app2)), >, 0);
+}
+
 static void
 gs_app_addons_func (void)
 {
@@ -770,6 +1054,68 @@ gs_app_list_func (void)
 	g_assert_cmpint (gs_app_list_get_state (list), ==, AS_APP_STATE_UNKNOWN);
 }
 
+static void
+gs_app_list_progress_size_func (void)
+{
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+	g_autoptr(GsApp) app1 = gs_app_new ("app1");
+	g_autoptr(GsApp) app2 = gs_app_new ("app2");
+	g_autoptr(GsApp) app3 = gs_app_new ("app3");
+
+	/* larger downloads count for more */
+	gs_app_list_add_flag (list, GS_APP_LIST_FLAG_WATCH_APPS);
+	gs_app_set_size_download (app1, 3000);
+	gs_app_set_size_download (app2, 1000);
+	gs_app_list_add (list, app1);
+	gs_app_list_add (list, app2);
+	gs_app_set_progress (app1, 100);
+	gs_test_flush_main_context ();
+	g_assert_cmpint (gs_app_list_get_progress (list), ==, 75);
+
+	/* unknown sizes are treated as the average known size */
+	gs_app_list_add (list, app3);
+	gs_app_set_progress (app3, 100);
+	gs_test_flush_main_context ();
+	g_assert_cmpint (gs_app_list_get_progress (list), ==, 83);
+}
+
+static void
+gs_app_list_notify_progress_cb (GsAppList *list, GParamSpec *pspec, gpointer user_data)
+{
+	guint *cnt = (guint *) user_data;
+	(*cnt)++;
+}
+
+static gboolean
+gs_app_list_notify_quit_cb (gpointer user_data)
+{
+	g_main_loop_quit ((GMainLoop *) user_data);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+gs_app_list_notify_func (void)
+{
+	guint cnt = 0;
+	g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+	g_autoptr(GsApp) app = gs_app_new ("app");
+
+	gs_app_list_add_flag (list, GS_APP_LIST_FLAG_WATCH_APPS);
+	gs_app_list_add (list, app);
+	g_signal_connect (list, "notify::progress",
+			  G_CALLBACK (gs_app_list_notify_progress_cb), &cnt);
+
+	/* several changes in one frame are only notified once */
+	gs_app_set_progress (app, 10);
+	gs_app_set_progress (app, 20);
+	gs_app_set_progress (app, 30);
+	g_timeout_add (200, gs_app_list_notify_quit_cb, loop);
+	g_main_loop_run (loop);
+	g_assert_cmpint (cnt, ==, 1);
+	g_assert_cmpint (gs_app_list_get_progress (list), ==, 30);
+}
+
 static void
 gs_app_list_related_func (void)
 {
@@ -810,10 +1156,19 @@ main (int argc, char **argv)
 	g_test_add_func ("/gnome-software/lib/app", gs_app_func);
 	g_test_add_func ("/gnome-software/lib/app{addons}", gs_app_addons_func);
 	g_test_add_func ("/gnome-software/lib/app{unique-id}", gs_app_unique_id_func);
+	g_test_add_func ("/gnome-software/lib/app{name-sort-key}", gs_app_name_sort_key_func);
 	g_test_add_func ("/gnome-software/lib/app{thread}", gs_app_thread_func);
+	g_test_add_func ("/gnome-software/lib/app{memory}", gs_app_memory_func);
 	g_test_add_func ("/gnome-software/lib/app{list}", gs_app_list_func);
+	g_test_add_func ("/gnome-software/lib/app{list-progress-size}", gs_app_list_progress_size_func);
+	g_test_add_func ("/gnome-software/lib/app{list-notify}", gs_app_list_notify_func);
 	g_test_add_func ("/gnome-software/lib/app{list-related}", gs_app_list_related_func);
+	g_test_add_func ("/gnome-software/lib/app{list-sort-truncate}", gs_app_list_sort_truncate_func);
 	g_test_add_func ("/gnome-software/lib/plugin", gs_plugin_func);
+	g_test_add_func ("/gnome-software/lib/plugin{download-bytes}", gs_plugin_download_bytes_func);
+	g_test_add_func ("/gnome-software/lib/plugin{stats}", gs_plugin_stats_func);
+	g_test_add_func ("/gnome-software/lib/plugin{cache}", gs_plugin_cache_func);
+	g_test_add_func ("/gnome-software/lib/trace", gs_trace_func);
 	g_test_add_func ("/gnome-software/lib/plugin{download-rewrite}", gs_plugin_download_rewrite_func);
 	g_test_add_func ("/gnome-software/lib/auth{secret}", gs_auth_secret_func);
 
@@ -0,0 +1,333 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "config.h"
+
+#include <json-glib/json-glib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <appstream-glib.h>
+
+#include "gs-plugin-private.h"
+#include "gs-trace.h"
+
+/* how many events are kept; a power of two */
+#define GS_TRACE_RING_SIZE		2048
+
+typedef struct {
+	gint			 seq;		/* atomic, 0 if unused, -1 while being written */
+	GsTraceKind		 kind;
+	guint			 value;
+	guint			 job_id;
+	guint			 tid;
+	gint64			 time;
+	gchar			 id[80];
+	gchar			 plugin[24];
+} GsTraceEvent;
+
+typedef struct {
+	const gchar		*plugin_name;	/* not owned */
+	guint			 job_id;
+	guint			 tid;
+} GsTraceContext;
+
+static GsTraceEvent gs_trace_ring[GS_TRACE_RING_SIZE];
+static gint gs_trace_head = 0;		/* atomic */
+static GPrivate gs_trace_context = G_PRIVATE_INIT (g_free);
+
+static GsTraceContext *
+gs_trace_get_context (void)
+{
+	GsTraceContext *ctx = g_private_get (&gs_trace_context);
+	if (ctx == NULL) {
+		ctx = g_new0 (GsTraceContext, 1);
+#ifdef __linux__
+		ctx->tid = (guint) syscall (SYS_gettid);
+#else
+		ctx->tid = GPOINTER_TO_UINT (g_thread_self ());
+#endif
+		g_private_set (&gs_trace_context, ctx);
+	}
+	return ctx;
+}
+
+/**
+ * gs_trace_set_context:
+ * @plugin_name: (nullable): the plugin now running on this thread
+ * @job_id: the #GsPluginJob ID, or 0
+ *
+ * Sets what the events recorded on the calling thread are attributed to,
+ * until this is called again. @plugin_name has to stay valid until then.
+ */
+void
+gs_trace_set_context (const gchar *plugin_name, guint job_id)
+{
+	GsTraceContext *ctx = gs_trace_get_context ();
+	ctx->plugin_name = plugin_name;
+	ctx->job_id = job_id;
+}
+
+/* if @seq1 was written after @seq2, allowing for the wrap at G_MAXINT */
+static gboolean
+gs_trace_seq_is_newer (gint seq1, gint seq2)
+{
+	guint diff = ((guint) seq1 - (guint) seq2) & G_MAXINT;
+	return diff != 0 && diff < G_MAXINT / 2;
+}
+
+/**
+ * gs_trace_record:
+ * @kind: a #GsTraceKind
+ * @id: (nullable): the application unique ID
+ * @value: the new #AsAppState, percentage or #GsPluginAction
+ *
+ * Records an event in the ring buffer. This never takes a lock, so it can be
+ * left on all the time; only the most recent events are kept. If the ring has
+ * wrapped around to a slot that another thread is still writing, the event is
+ * dropped.
+ */
+void
+gs_trace_record (GsTraceKind kind, const gchar *id, guint value)
+{
+	GsTraceContext *ctx = gs_trace_get_context ();
+	guint idx = (guint) g_atomic_int_add (&gs_trace_head, 1);
+	GsTraceEvent *ev = &gs_trace_ring[idx % GS_TRACE_RING_SIZE];
+	gint seq = (gint) ((idx + 1) & G_MAXINT);
+	gint seq_old;
+
+	if (seq == 0)
+		seq = 1;
+
+	/* take the slot, unless another writer still has it or has already
+	 * put a newer event in it; readers skip the slot until it is complete */
+	do {
+		seq_old = g_atomic_int_get (&ev->seq);
+		if (seq_old == -1)
+			return;
+		if (seq_old > 0 && gs_trace_seq_is_newer (seq_old, seq))
+			return;
+	} while (!g_atomic_int_compare_and_exchange (&ev->seq, seq_old, -1));
+	__atomic_thread_fence (__ATOMIC_RELEASE);
+	ev->kind = kind;
+	ev->value = value;
+	ev->job_id = ctx->job_id;
+	ev->tid = ctx->tid;
+	ev->time = g_get_monotonic_time ();
+	g_strlcpy (ev->id, id != NULL ? id : "", sizeof(ev->id));
+	g_strlcpy (ev->plugin, ctx->plugin_name != NULL ? ctx->plugin_name : "",
+		   sizeof(ev->plugin));
+	g_atomic_int_set (&ev->seq, seq);
+}
+
+/* copies out the complete events, oldest first */
+static GArray *
+gs_trace_snapshot (void)
+{
+	GArray *events = g_array_new (FALSE, FALSE, sizeof(GsTraceEvent));
+	guint head = (guint) g_atomic_int_get (&gs_trace_head);
+	guint start = head > GS_TRACE_RING_SIZE ? head - GS_TRACE_RING_SIZE : 0;
+
+	for (guint i = start; i < head; i++) {
+		GsTraceEvent *ev = &gs_trace_ring[i % GS_TRACE_RING_SIZE];
+		GsTraceEvent tmp;
+		gint seq = (gint) ((i + 1) & G_MAXINT);
+		if (seq == 0)
+			seq = 1;
+		if (g_atomic_int_get (&ev->seq) != seq)
+			continue;
+		memcpy (&tmp, ev, sizeof(tmp));
+		__atomic_thread_fence (__ATOMIC_ACQUIRE);
+
+		/* overwritten while copying */
+		if (g_atomic_int_get (&ev->seq) != seq)
+			continue;
+		g_array_append_val (events, tmp);
+	}
+	return events;
+}
+
+static void
+gs_trace_add_json_event (JsonBuilder *builder,
+			 GsTraceEvent *ev,
+			 const gchar *ph,
+			 const gchar *cat,
+			 const gchar *name,
+			 gint64 time)
+{
+	json_builder_begin_object (builder);
+	json_builder_set_member_name (builder, "ph");
+	json_builder_add_string_value (builder, ph);
+	json_builder_set_member_name (builder, "cat");
+	json_builder_add_string_value (builder, cat);
+	json_builder_set_member_name (builder, "name");
+	json_builder_add_string_value (builder, name);
+	json_builder_set_member_name (builder, "pid");
+	json_builder_add_int_value (builder, getpid ());
+	json_builder_set_member_name (builder, "tid");
+	json_builder_add_int_value (builder, ev->tid);
+	json_builder_set_member_name (builder, "ts");
+	json_builder_add_int_value (builder, time);
+	if (g_strcmp0 (ph, "C") != 0) {
+		json_builder_set_member_name (builder, "id");
+		json_builder_add_string_value (builder, ev->id);
+	}
+	json_builder_set_member_name (builder, "args");
+	json_builder_begin_object (builder);
+	if (g_strcmp0 (ph, "C") == 0) {
+		json_builder_set_member_name (builder, "percentage");
+		json_builder_add_int_value (builder, ev->value);
+	} else {
+		json_builder_set_member_name (builder, "app");
+		json_builder_add_string_value (builder, ev->id);
+	}
+	if (ev->plugin[0] != '\0') {
+		json_builder_set_member_name (builder, "plugin");
+		json_builder_add_string_value (builder, ev->plugin);
+	}
+	if (ev->job_id != 0) {
+		json_builder_set_member_name (builder, "job");
+		json_builder_add_int_value (builder, ev->job_id);
+	}
+	json_builder_end_object (builder);
+	json_builder_end_object (builder);
+}
+
+/* each application gets one async track for its state and one for its
+ * pending action, so every stage shows up as a span */
+static void
+gs_trace_add_json_span (JsonBuilder *builder,
+			GHashTable *open,
+			GsTraceEvent *ev,
+			const gchar *cat,
+			const gchar *name)
+{
+	g_autofree gchar *key = g_strdup_printf ("%s\n%s", cat, ev->id);
+	GsTraceEvent *ev_open = g_hash_table_lookup (open, key);
+
+	if (ev_open != NULL) {
+		const gchar *name_open = ev_open->kind == GS_TRACE_KIND_STATE ?
+			as_app_state_to_string (ev_open->value) :
+			gs_plugin_action_to_string (ev_open->value);
+		gs_trace_add_json_event (builder, ev_open, "e", cat,
+					 name_open, ev->time);
+	}
+	if (name == NULL) {
+		g_hash_table_remove (open, key);
+		return;
+	}
+	gs_trace_add_json_event (builder, ev, "b", cat, name, ev->time);
+	g_hash_table_insert (open, g_steal_pointer (&key), ev);
+}
+
+/**
+ * gs_trace_to_json:
+ *
+ * Exports the recorded events in the Chrome trace event format, which can
+ * be loaded into Perfetto or chrome://tracing. Timestamps are microseconds
+ * of the monotonic clock.
+ *
+ * Returns: a JSON string
+ */
+gchar *
+gs_trace_to_json (void)
+{
+	GHashTableIter iter;
+	GsTraceEvent *ev_open;
+	gint64 time_last = 0;
+	g_autoptr(GArray) events = gs_trace_snapshot ();
+	g_autoptr(GHashTable) open = NULL;
+	g_autoptr(JsonBuilder) builder = json_builder_new ();
+	g_autoptr(JsonGenerator) generator = json_generator_new ();
+	g_autoptr(JsonNode) root = NULL;
+
+	open = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	json_builder_begin_object (builder);
+	json_builder_set_member_name (builder, "displayTimeUnit");
+	json_builder_add_string_value (builder, "ms");
+	json_builder_set_member_name (builder, "traceEvents");
+	json_builder_begin_array (builder);
+	for (guint i = 0; i < events->len; i++) {
+		GsTraceEvent *ev = &g_array_index (events, GsTraceEvent, i);
+		switch (ev->kind) {
+		case GS_TRACE_KIND_STATE:
+			gs_trace_add_json_span (builder, open, ev, "state",
+						as_app_state_to_string (ev->value));
+			break;
+		case GS_TRACE_KIND_PENDING_ACTION:
+			gs_trace_add_json_span (builder, open, ev, "pending-action",
+						ev->value != GS_PLUGIN_ACTION_UNKNOWN ?
+						gs_plugin_action_to_string (ev->value) : NULL);
+			break;
+		case GS_TRACE_KIND_PROGRESS:
+			{
+				g_autofree gchar *name = g_strdup_printf ("progress %s", ev->id);
+				gs_trace_add_json_event (builder, ev, "C", "progress",
+							 name, ev->time);
+			}
+			break;
+		default:
+			break;
+		}
+		time_last = ev->time;
+	}
+
+	/* close what is still in progress */
+	g_hash_table_iter_init (&iter, open);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &ev_open)) {
+		const gchar *name = ev_open->kind == GS_TRACE_KIND_STATE ?
+			as_app_state_to_string (ev_open->value) :
+			gs_plugin_action_to_string (ev_open->value);
+		gs_trace_add_json_event (builder, ev_open, "e",
+					 ev_open->kind == GS_TRACE_KIND_STATE ?
+					 "state" : "pending-action",
+					 name, time_last);
+	}
+	json_builder_end_array (builder);
+	json_builder_end_object (builder);
+
+	root = json_builder_get_root (builder);
+	json_generator_set_root (generator, root);
+	return json_generator_to_data (generator, NULL);
+}
+
+/**
+ * gs_trace_save:
+ * @filename: a filename
+ * @error: a #GError, or %NULL
+ *
+ * Saves the output of gs_trace_to_json() to a file.
+ *
+ * Returns: %TRUE for success
+ */
+gboolean
+gs_trace_save (const gchar *filename, GError **error)
+{
+	g_autofree gchar *json = gs_trace_to_json ();
+	return g_file_set_contents (filename, json, -1, error);
+}
+
+/* vim: set noexpandtab: */
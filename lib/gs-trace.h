@@ -0,0 +1,50 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef __GS_TRACE_H
+#define __GS_TRACE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+	GS_TRACE_KIND_STATE,
+	GS_TRACE_KIND_PROGRESS,
+	GS_TRACE_KIND_PENDING_ACTION,
+	GS_TRACE_KIND_LAST
+} GsTraceKind;
+
+void		 gs_trace_record		(GsTraceKind	 kind,
+						 const gchar	*id,
+						 guint		 value);
+void		 gs_trace_set_context		(const gchar	*plugin_name,
+						 guint		 job_id);
+gchar		*gs_trace_to_json		(void);
+gboolean	 gs_trace_save			(const gchar	*filename,
+						 GError		**error);
+
+G_END_DECLS
+
+#endif /* __GS_TRACE_H */
+
+/* vim: set noexpandtab: */
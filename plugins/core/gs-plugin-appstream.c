@@ -54,6 +54,11 @@ gs_plugin_initialize (GsPlugin *plugin)
 
 	/* require settings */
 	priv->settings = g_settings_new ("org.gnome.software");
+
+	/* searching puts most of the catalog in the cache, but the apps are
+	 * cheap to create again from the silo */
+	gs_plugin_cache_set_max_size (plugin, 1000);
+	gs_plugin_cache_set_max_age (plugin, 60 * 60);
 }
 
 void
@@ -190,6 +190,41 @@ gs_plugins_core_generic_updates_func (GsPluginLoader *plugin_loader)
 	}
 }
 
+/* only run with -m perf */
+static void
+gs_plugins_core_refine_perf_func (GsPluginLoader *plugin_loader)
+{
+	gboolean ret;
+	gdouble elapsed;
+	const guint n_apps = 5000;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	for (guint i = 0; i < n_apps; i++) {
+		g_autofree gchar *id = g_strdup_printf ("org.example.Test%u.desktop", i);
+		g_autoptr(GsApp) app = gs_app_new (id);
+		gs_app_set_kind (app, AS_APP_KIND_DESKTOP);
+		gs_app_list_add (list, app);
+	}
+	g_assert_cmpint (gs_app_list_length (list), ==, n_apps);
+
+	/* refine every app with every core plugin */
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "list", list,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN,
+					 NULL);
+	g_test_timer_start ();
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	elapsed = g_test_timer_elapsed ();
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_test_minimized_result (elapsed, "refined %u apps in %.3fs", n_apps, elapsed);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -269,6 +304,11 @@ main (int argc, char **argv)
 	g_test_add_data_func ("/gnome-software/plugins/core/generic-updates",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_core_generic_updates_func);
+	if (g_test_perf ()) {
+		g_test_add_data_func ("/gnome-software/plugins/core/refine-perf",
+				      plugin_loader,
+				      (GTestDataFunc) gs_plugins_core_refine_perf_func);
+	}
 	return g_test_run ();
 }
 
@@ -0,0 +1,398 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <json-glib/json-glib.h>
+#include <stdlib.h>
+#ifdef HAVE_MALLINFO2
+#include <malloc.h>
+#endif
+
+#include "gnome-software-private.h"
+
+typedef struct {
+	GsPluginLoader		*plugin_loader;
+	JsonBuilder		*builder;
+	guint			 size;
+	guint			 iterations;
+	gint64			 begin_time;
+	gsize			 begin_heap;
+} GsBenchmark;
+
+typedef GsAppList	*(*GsBenchmarkFunc)	(GsBenchmark		*self,
+						 gconstpointer		 user_data,
+						 GError			**error);
+
+/* bytes of the heap in use, or zero if this libc cannot tell */
+static gsize
+gs_benchmark_get_heap (void)
+{
+#ifdef HAVE_MALLINFO2
+	struct mallinfo2 mi = mallinfo2 ();
+	return mi.uordblks + mi.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+/* so that preparing the input is not part of the measurement */
+static void
+gs_benchmark_reset_clock (GsBenchmark *self)
+{
+	self->begin_heap = gs_benchmark_get_heap ();
+	self->begin_time = g_get_monotonic_time ();
+}
+
+static gchar *
+gs_benchmark_create_xml (guint size)
+{
+	const gchar *categories[] = { "AudioVideo", "Development", "Education",
+				      "Game", "Graphics", "Network", "Office",
+				      "Science", "System", "Utility", NULL };
+	GString *xml = g_string_new ("<?xml version=\"1.0\"?>\n"
+				     "<components version=\"0.9\">\n");
+
+	/* the IDs match what the dummy plugin adds for the catalog */
+	for (guint i = 0; i < size; i++) {
+		g_string_append_printf (xml,
+			"  <component type=\"desktop\">\n"
+			"    <id>bench%05u.desktop</id>\n"
+			"    <name>Bench App %u</name>\n"
+			"    <summary>A benchmark application for %s</summary>\n"
+			"    <description><p>Number %u of %u.</p></description>\n"
+			"    <pkgname>bench%05u</pkgname>\n"
+			"    <icon type=\"stock\">drive-harddisk</icon>\n"
+			"    <categories>\n"
+			"      <category>%s</category>\n"
+			"    </categories>\n"
+			"    <keywords>\n"
+			"      <keyword>bench</keyword>\n"
+			"      <keyword>app%u</keyword>\n"
+			"    </keywords>\n"
+			"    <project_license>GPL-2.0+</project_license>\n"
+			"    <url type=\"homepage\">https://www.example.com/%u</url>\n"
+			"    <releases>\n"
+			"      <release version=\"1.%u\" timestamp=\"1500000000\"/>\n"
+			"    </releases>\n"
+			"  </component>\n",
+			i, i, categories[i % 10], i, size, i,
+			categories[i % 10], i % 100, i, i % 10);
+	}
+	g_string_append (xml, "</components>\n");
+	return g_string_free (xml, FALSE);
+}
+
+static GsAppList *
+gs_benchmark_search (GsBenchmark *self, gconstpointer user_data, GError **error)
+{
+	const gchar *search = user_data;
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_SEARCH,
+					 "search", search,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					 NULL);
+	return gs_plugin_loader_job_process (self->plugin_loader, plugin_job,
+					     NULL, error);
+}
+
+static GsAppList *
+gs_benchmark_get_installed (GsBenchmark *self, gconstpointer user_data, GError **error)
+{
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_INSTALLED,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_SIZE,
+					 NULL);
+	return gs_plugin_loader_job_process (self->plugin_loader, plugin_job,
+					     NULL, error);
+}
+
+static GsAppList *
+gs_benchmark_get_updates (GsBenchmark *self, gconstpointer user_data, GError **error)
+{
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS,
+					 NULL);
+	return gs_plugin_loader_job_process (self->plugin_loader, plugin_job,
+					     NULL, error);
+}
+
+static GsAppList *
+gs_benchmark_refine (GsBenchmark *self, gconstpointer user_data, GError **error)
+{
+	GsPluginRefineFlags refine_flags = GPOINTER_TO_UINT (user_data);
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	/* new apps every time, else there is nothing left to refine */
+	for (guint i = 0; i < self->size; i++) {
+		g_autofree gchar *id = g_strdup_printf ("bench%05u.desktop", i);
+		g_autoptr(GsApp) app = gs_app_new (id);
+		gs_app_list_add (list, app);
+	}
+	gs_benchmark_reset_clock (self);
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "list", list,
+					 "refine-flags", refine_flags,
+					 NULL);
+	if (!gs_plugin_loader_job_action (self->plugin_loader, plugin_job,
+					  NULL, error))
+		return NULL;
+	return g_steal_pointer (&list);
+}
+
+static GsAppList *
+gs_benchmark_dedupe (GsBenchmark *self, gconstpointer user_data, GError **error)
+{
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+
+	/* every app twice, as if from two different sources */
+	for (guint i = 0; i < self->size * 2; i++) {
+		g_autofree gchar *id = g_strdup_printf ("bench%05u.desktop", i / 2);
+		g_autoptr(GsApp) app = gs_app_new (id);
+		gs_app_set_bundle_kind (app, i % 2 ? AS_BUNDLE_KIND_FLATPAK :
+						     AS_BUNDLE_KIND_PACKAGE);
+		gs_app_set_state (app, i % 4 == 0 ? AS_APP_STATE_INSTALLED :
+						    AS_APP_STATE_AVAILABLE);
+		gs_app_list_add (list, app);
+	}
+	gs_benchmark_reset_clock (self);
+
+	gs_app_list_filter_duplicates (list, GS_APP_LIST_FILTER_FLAG_KEY_ID |
+					     GS_APP_LIST_FILTER_FLAG_PREFER_INSTALLED);
+	return g_steal_pointer (&list);
+}
+
+static gint
+gs_benchmark_sort_cb (gconstpointer a, gconstpointer b)
+{
+	gint64 ia = *((const gint64 *) a);
+	gint64 ib = *((const gint64 *) b);
+	if (ia < ib)
+		return -1;
+	if (ia > ib)
+		return 1;
+	return 0;
+}
+
+static gboolean
+gs_benchmark_run (GsBenchmark *self,
+		  const gchar *name,
+		  GsBenchmarkFunc func,
+		  gconstpointer user_data,
+		  GError **error)
+{
+	g_autofree gint64 *elapsed = g_new0 (gint64, self->iterations);
+	gint64 total = 0;
+	gsize heap = 0;
+	guint n_apps = 0;
+
+	for (guint i = 0; i < self->iterations; i++) {
+		g_autoptr(GsAppList) list = NULL;
+		gsize heap_now;
+
+		gs_benchmark_reset_clock (self);
+		list = func (self, user_data, error);
+		if (list == NULL) {
+			g_prefix_error (error, "%s failed: ", name);
+			return FALSE;
+		}
+		elapsed[i] = g_get_monotonic_time () - self->begin_time;
+		total += elapsed[i];
+
+		/* what is still alive with the results */
+		heap_now = gs_benchmark_get_heap ();
+		if (heap_now > self->begin_heap)
+			heap = MAX (heap, heap_now - self->begin_heap);
+		n_apps = gs_app_list_length (list);
+	}
+	qsort (elapsed, self->iterations, sizeof(gint64), gs_benchmark_sort_cb);
+
+	json_builder_begin_object (self->builder);
+	json_builder_set_member_name (self->builder, "name");
+	json_builder_add_string_value (self->builder, name);
+	json_builder_set_member_name (self->builder, "apps");
+	json_builder_add_int_value (self->builder, n_apps);
+	json_builder_set_member_name (self->builder, "min_us");
+	json_builder_add_int_value (self->builder, elapsed[0]);
+	json_builder_set_member_name (self->builder, "median_us");
+	json_builder_add_int_value (self->builder, elapsed[self->iterations / 2]);
+	json_builder_set_member_name (self->builder, "mean_us");
+	json_builder_add_int_value (self->builder, total / self->iterations);
+	json_builder_set_member_name (self->builder, "max_us");
+	json_builder_add_int_value (self->builder, elapsed[self->iterations - 1]);
+	json_builder_set_member_name (self->builder, "heap_bytes");
+	json_builder_add_int_value (self->builder, (gint64) heap);
+	json_builder_end_object (self->builder);
+	return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+	const gchar *tmp_root = "/var/tmp/self-test";
+	gboolean ret;
+	gint size = 5000;
+	gint iterations = 5;
+	g_autofree gchar *output = NULL;
+	g_autofree gchar *xml = NULL;
+	g_autofree gchar *size_str = NULL;
+	g_autofree gchar *json = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GsPluginLoader) plugin_loader = NULL;
+	g_autoptr(JsonBuilder) builder = json_builder_new ();
+	g_autoptr(JsonGenerator) generator = NULL;
+	g_autoptr(JsonNode) root = NULL;
+	g_autoptr(GVariant) stats = NULL;
+	GsBenchmark self = { 0 };
+	const gchar *whitelist[] = {
+		"appstream",
+		"dummy",
+		"desktop-categories",
+		"hardcoded-blacklist",
+		"provenance",
+		NULL
+	};
+	const GOptionEntry options[] = {
+		{ "size", '\0', 0, G_OPTION_ARG_INT, &size,
+		  "Number of applications in the catalog", NULL },
+		{ "iterations", '\0', 0, G_OPTION_ARG_INT, &iterations,
+		  "Number of times to run each benchmark", NULL },
+		{ "output", '\0', 0, G_OPTION_ARG_FILENAME, &output,
+		  "Write the results to a file rather than stdout", NULL },
+		{ NULL}
+	};
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, "GNOME Software Benchmark");
+	g_option_context_add_main_entries (context, options, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_printerr ("Failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	if (size <= 0 || iterations <= 0) {
+		g_printerr ("The size and iterations must be positive\n");
+		return EXIT_FAILURE;
+	}
+
+	/* set all the things required as a dummy test harness */
+	size_str = g_strdup_printf ("%i", size);
+	xml = gs_benchmark_create_xml ((guint) size);
+	g_setenv ("GS_SELF_TEST_LOCALE", "en_GB", TRUE);
+	g_setenv ("GS_SELF_TEST_DUMMY_ENABLE", "1", TRUE);
+	g_setenv ("GS_SELF_TEST_DUMMY_CATALOG_SIZE", size_str, TRUE);
+	g_setenv ("GS_SELF_TEST_PROVENANCE_SOURCES", "london*,boston", TRUE);
+	g_setenv ("GS_SELF_TEST_CACHEDIR", tmp_root, TRUE);
+	g_setenv ("GS_SELF_TEST_APPSTREAM_XML", xml, TRUE);
+	g_setenv ("GNOME_SOFTWARE_POPULAR", "", TRUE);
+
+	/* only critical and error are fatal */
+	g_log_set_fatal_mask (NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
+
+	plugin_loader = gs_plugin_loader_new ();
+	gs_plugin_loader_add_location (plugin_loader, LOCALPLUGINDIR);
+	gs_plugin_loader_add_location (plugin_loader, LOCALPLUGINDIR_CORE);
+	ret = gs_plugin_loader_setup (plugin_loader,
+				      (gchar**) whitelist,
+				      NULL,
+				      NULL,
+				      &error);
+	if (!ret) {
+		g_printerr ("Failed to setup plugins: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+
+	self.plugin_loader = plugin_loader;
+	self.builder = builder;
+	self.size = (guint) size;
+	self.iterations = (guint) iterations;
+
+	json_builder_begin_object (builder);
+	json_builder_set_member_name (builder, "size");
+	json_builder_add_int_value (builder, size);
+	json_builder_set_member_name (builder, "iterations");
+	json_builder_add_int_value (builder, iterations);
+	json_builder_set_member_name (builder, "benchmarks");
+	json_builder_begin_array (builder);
+	ret = gs_benchmark_run (&self, "search{all}",
+				gs_benchmark_search, "bench", &error) &&
+	      gs_benchmark_run (&self, "search{some}",
+				gs_benchmark_search, "app42", &error) &&
+	      gs_benchmark_run (&self, "get-installed",
+				gs_benchmark_get_installed, NULL, &error) &&
+	      gs_benchmark_run (&self, "get-updates",
+				gs_benchmark_get_updates, NULL, &error) &&
+	      gs_benchmark_run (&self, "refine{id}",
+				gs_benchmark_refine,
+				GUINT_TO_POINTER (GS_PLUGIN_REFINE_FLAGS_DEFAULT),
+				&error) &&
+	      gs_benchmark_run (&self, "refine{icon}",
+				gs_benchmark_refine,
+				GUINT_TO_POINTER (GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON),
+				&error) &&
+	      gs_benchmark_run (&self, "refine{details}",
+				gs_benchmark_refine,
+				GUINT_TO_POINTER (GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+						  GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE |
+						  GS_PLUGIN_REFINE_FLAGS_REQUIRE_URL |
+						  GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION |
+						  GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION |
+						  GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN |
+						  GS_PLUGIN_REFINE_FLAGS_REQUIRE_SIZE),
+				&error) &&
+	      gs_benchmark_run (&self, "dedupe",
+				gs_benchmark_dedupe, NULL, &error);
+	if (!ret) {
+		g_printerr ("Failed to run benchmark: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	json_builder_end_array (builder);
+
+	/* where the time went */
+	stats = g_variant_ref_sink (gs_plugin_loader_get_stats (plugin_loader));
+	json_builder_set_member_name (builder, "plugins");
+	json_builder_add_value (builder, json_gvariant_serialize (stats));
+	json_builder_end_object (builder);
+
+	root = json_builder_get_root (builder);
+	generator = json_generator_new ();
+	json_generator_set_pretty (generator, TRUE);
+	json_generator_set_root (generator, root);
+	json = json_generator_to_data (generator, NULL);
+	if (output != NULL) {
+		if (!g_file_set_contents (output, json, -1, &error)) {
+			g_printerr ("Failed to save results: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+	} else {
+		g_print ("%s\n", json);
+	}
+	return EXIT_SUCCESS;
+}
+
+/* vim: set noexpandtab: */
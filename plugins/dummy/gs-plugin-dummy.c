@@ -38,6 +38,7 @@ struct GsPluginData {
 	GsApp			*cached_origin;
 	GHashTable		*installed_apps;	/* id:1 */
 	GHashTable		*available_apps;	/* id:1 */
+	guint			 catalog_size;
 };
 
 /* just flip-flop this every few seconds */
@@ -62,6 +63,12 @@ gs_plugin_initialize (GsPlugin *plugin)
 		return;
 	}
 
+	/* pretend to manage a large catalog, for benchmarking */
+	if (g_getenv ("GS_SELF_TEST_DUMMY_CATALOG_SIZE") != NULL) {
+		priv->catalog_size = (guint) g_ascii_strtoull (g_getenv ("GS_SELF_TEST_DUMMY_CATALOG_SIZE"),
+							       NULL, 10);
+	}
+
 	/* toggle this */
 	if (g_getenv ("GS_SELF_TEST_TOGGLE_ALLOW_UPDATES") != NULL) {
 		priv->allow_updates_id = g_timeout_add_seconds (10,
@@ -356,16 +363,45 @@ gs_plugin_add_search (GsPlugin *plugin,
 	return TRUE;
 }
 
+/* every 4th app of the synthetic catalog is installed, and every 10th of
+ * those is updatable; the IDs match what gs-benchmark puts in the AppStream */
+static void
+gs_plugin_dummy_add_catalog (GsPlugin *plugin,
+			     GsAppList *list,
+			     guint divisor,
+			     AsAppState state)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	for (guint i = 0; i < priv->catalog_size; i += divisor) {
+		g_autofree gchar *id = g_strdup_printf ("bench%05u.desktop", i);
+		g_autofree gchar *pkgname = g_strdup_printf ("bench%05u", i);
+		g_autoptr(GsApp) app = gs_app_new (id);
+		gs_app_add_source (app, pkgname);
+		gs_app_set_kind (app, AS_APP_KIND_DESKTOP);
+		gs_app_set_state (app, state);
+		gs_app_set_management_plugin (app, gs_plugin_get_name (plugin));
+		gs_app_list_add (list, app);
+	}
+}
+
 gboolean
 gs_plugin_add_updates (GsPlugin *plugin,
 		       GsAppList *list,
 		       GCancellable *cancellable,
 		       GError **error)
 {
+	GsPluginData *priv = gs_plugin_get_data (plugin);
 	GsApp *app;
 	GsApp *proxy;
 	g_autoptr(AsIcon) ic = NULL;
 
+	/* no need to spin */
+	if (priv->catalog_size > 0) {
+		gs_plugin_dummy_add_catalog (plugin, list, 40,
+					     AS_APP_STATE_UPDATABLE_LIVE);
+		return TRUE;
+	}
+
 	/* update UI as this might take some time */
 	gs_plugin_status_update (plugin, NULL, GS_PLUGIN_STATUS_WAITING);
 
@@ -466,10 +502,18 @@ gs_plugin_add_installed (GsPlugin *plugin,
 			 GCancellable *cancellable,
 			 GError **error)
 {
+	GsPluginData *priv = gs_plugin_get_data (plugin);
 	const gchar *packages[] = { "zeus", "zeus-common", NULL };
 	const gchar *app_ids[] = { "Uninstall Zeus.desktop", NULL };
 	guint i;
 
+	/* the synthetic catalog instead */
+	if (priv->catalog_size > 0) {
+		gs_plugin_dummy_add_catalog (plugin, list, 4,
+					     AS_APP_STATE_INSTALLED);
+		return TRUE;
+	}
+
 	/* add all packages */
 	for (i = 0; packages[i] != NULL; i++) {
 		g_autoptr(GsApp) app = gs_app_new (NULL);
@@ -691,6 +735,10 @@ gs_plugin_refine_app (GsPlugin *plugin,
 			gs_app_set_description (app, GS_APP_QUALITY_NORMAL,
 						"long description!");
 		}
+		if (g_strcmp0 (gs_app_get_summary (app), "Paged") == 0) {
+			gs_app_set_description (app, GS_APP_QUALITY_NORMAL,
+						"Paged description");
+		}
 	}
 
 	/* add fake review */
@@ -747,7 +795,37 @@ gs_plugin_add_category_apps (GsPlugin *plugin,
 			     GCancellable *cancellable,
 			     GError **error)
 {
-	g_autoptr(GsApp) app = gs_app_new ("chiron.desktop");
+	g_autoptr(GsApp) app = NULL;
+
+	/* enough apps for two pages, with one of them from two origins */
+	if (g_strcmp0 (gs_category_get_id (category), "paged") == 0) {
+		const gchar *ids[] = { "a", "b", "b", "c", "d", NULL };
+		for (guint i = 0; ids[i] != NULL; i++) {
+			const gchar *origin = i == 2 ? "dummy-extra" : "dummy";
+			g_autoptr(GsApp) app_tmp = NULL;
+			g_autofree gchar *id = g_strdup_printf ("paged-%s.desktop", ids[i]);
+			g_autofree gchar *key = g_strdup_printf ("%s/%s", origin, id);
+
+			/* use the same objects so the tests can see what was refined */
+			app_tmp = gs_plugin_cache_lookup (plugin, key);
+			if (app_tmp != NULL) {
+				gs_app_list_add (list, app_tmp);
+				continue;
+			}
+			app_tmp = gs_app_new (id);
+			gs_app_set_name (app_tmp, GS_APP_QUALITY_NORMAL, ids[i]);
+			gs_app_set_summary (app_tmp, GS_APP_QUALITY_NORMAL, "Paged");
+			gs_app_set_kind (app_tmp, AS_APP_KIND_DESKTOP);
+			gs_app_set_state (app_tmp, AS_APP_STATE_AVAILABLE);
+			gs_app_set_origin (app_tmp, origin);
+			gs_app_set_management_plugin (app_tmp, gs_plugin_get_name (plugin));
+			gs_plugin_cache_add (plugin, key, app_tmp);
+			gs_app_list_add (list, app_tmp);
+		}
+		return TRUE;
+	}
+
+	app = gs_app_new ("chiron.desktop");
 	gs_app_set_name (app, GS_APP_QUALITY_NORMAL, "Chiron");
 	gs_app_set_summary (app, GS_APP_QUALITY_NORMAL, "View and use virtual machines");
 	gs_app_set_url (app, AS_URL_KIND_HOMEPAGE, "http://www.box.org");
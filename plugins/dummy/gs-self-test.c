@@ -165,6 +165,174 @@ gs_plugins_dummy_refine_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpstr (gs_app_get_url (app, AS_URL_KIND_HOMEPAGE), ==, "http://www.test.org/");
 }
 
+/* the counters are only updated once the thread is done */
+static GVariant *
+gs_plugins_dummy_get_governor_stats (GsPluginLoader *plugin_loader)
+{
+	for (guint i = 0; i < 5000; i++) {
+		guint running = 0;
+		g_autoptr(GVariant) stats = NULL;
+		stats = g_variant_ref_sink (gs_plugin_loader_get_governor_stats (plugin_loader));
+		g_assert (g_variant_lookup (stats, "background-running", "u", &running));
+		if (running == 0)
+			return g_steal_pointer (&stats);
+		g_usleep (1000);
+	}
+	g_assert_not_reached ();
+	return NULL;
+}
+
+static guint
+gs_plugins_dummy_get_background_jobs (GsPluginLoader *plugin_loader)
+{
+	guint background_jobs = 0;
+	g_autoptr(GVariant) stats = gs_plugins_dummy_get_governor_stats (plugin_loader);
+	g_assert (g_variant_lookup (stats, "background-jobs", "u", &background_jobs));
+	return background_jobs;
+}
+
+static guint _governor_finished = 0;
+
+typedef struct {
+	guint		 order;		/* when it finished, from 1 */
+} GsDummyGovernorHelper;
+
+static void
+gs_plugins_dummy_governor_cb (GObject *source,
+			      GAsyncResult *res,
+			      gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
+	GsDummyGovernorHelper *helper = (GsDummyGovernorHelper *) user_data;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	helper->order = ++_governor_finished;
+}
+
+/* runs the main context until the job is done or @timeout_ms has passed */
+static void
+gs_plugins_dummy_governor_wait (GsDummyGovernorHelper *helper, guint timeout_ms)
+{
+	gint64 end = g_get_monotonic_time () + (gint64) timeout_ms * 1000;
+	while (helper->order == 0 && g_get_monotonic_time () < end) {
+		while (g_main_context_iteration (NULL, FALSE));
+		g_usleep (1000);
+	}
+}
+
+static void
+gs_plugins_dummy_background_func (GsPluginLoader *plugin_loader)
+{
+	gboolean ret;
+	gboolean paused = TRUE;
+	guint background_jobs;
+	g_autoptr(GsApp) app = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+	g_autoptr(GVariant) stats = NULL;
+
+	background_jobs = gs_plugins_dummy_get_background_jobs (plugin_loader);
+
+	/* runs in the background pool just the same */
+	app = gs_app_new ("chiron.desktop");
+	gs_app_set_management_plugin (app, "dummy");
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "app", app,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE,
+					 "background", TRUE,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpstr (gs_app_get_license (app), ==, "GPL-2.0+");
+
+	/* the job was counted once */
+	stats = gs_plugins_dummy_get_governor_stats (plugin_loader);
+	g_assert (g_variant_lookup (stats, "background-paused", "b", &paused));
+	g_assert (!paused);
+	g_assert_cmpint (gs_plugins_dummy_get_background_jobs (plugin_loader), ==, background_jobs + 1);
+}
+
+static void
+gs_plugins_dummy_background_paused_func (GsPluginLoader *plugin_loader)
+{
+	gboolean paused = FALSE;
+	guint background_jobs;
+	GsDummyGovernorHelper helper = { 0 };
+	g_autoptr(GsApp) app = NULL;
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+	g_autoptr(GVariant) stats = NULL;
+
+	/* does not start while paused */
+	background_jobs = gs_plugins_dummy_get_background_jobs (plugin_loader);
+	gs_plugin_loader_set_background_paused (plugin_loader, TRUE);
+	app = gs_app_new ("chiron.desktop");
+	gs_app_set_management_plugin (app, "dummy");
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "app", app,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE,
+					 "background", TRUE,
+					 NULL);
+	gs_plugin_loader_job_process_async (plugin_loader, plugin_job, NULL,
+					    gs_plugins_dummy_governor_cb, &helper);
+	gs_plugins_dummy_governor_wait (&helper, 500);
+	g_assert_cmpint (helper.order, ==, 0);
+	stats = g_variant_ref_sink (gs_plugin_loader_get_governor_stats (plugin_loader));
+	g_assert (g_variant_lookup (stats, "background-paused", "b", &paused));
+	g_assert (paused);
+
+	/* runs as soon as it is resumed */
+	gs_plugin_loader_set_background_paused (plugin_loader, FALSE);
+	gs_plugins_dummy_governor_wait (&helper, 5000);
+	g_assert_cmpint (helper.order, !=, 0);
+	g_assert_cmpstr (gs_app_get_license (app), ==, "GPL-2.0+");
+	gs_test_flush_main_context ();
+	g_assert_cmpint (gs_plugins_dummy_get_background_jobs (plugin_loader), ==, background_jobs + 1);
+}
+
+static void
+gs_plugins_dummy_background_interactive_func (GsPluginLoader *plugin_loader)
+{
+	GsDummyGovernorHelper helper1 = { 0 };
+	GsDummyGovernorHelper helper2 = { 0 };
+	g_autoptr(GsApp) app = NULL;
+	g_autoptr(GsPluginJob) plugin_job1 = NULL;
+	g_autoptr(GsPluginJob) plugin_job2 = NULL;
+
+	/* the dummy plugin takes two seconds to get the updates */
+	plugin_job1 = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES,
+					  "interactive", TRUE,
+					  NULL);
+	gs_plugin_loader_job_process_async (plugin_loader, plugin_job1, NULL,
+					    gs_plugins_dummy_governor_cb, &helper1);
+
+	/* a background job waits for it to finish */
+	app = gs_app_new ("chiron.desktop");
+	gs_app_set_management_plugin (app, "dummy");
+	plugin_job2 = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					  "app", app,
+					  "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE,
+					  "background", TRUE,
+					  NULL);
+	gs_plugin_loader_job_process_async (plugin_loader, plugin_job2, NULL,
+					    gs_plugins_dummy_governor_cb, &helper2);
+	gs_plugins_dummy_governor_wait (&helper2, 500);
+	g_assert_cmpint (helper2.order, ==, 0);
+
+	/* and then runs */
+	gs_plugins_dummy_governor_wait (&helper1, 10000);
+	gs_plugins_dummy_governor_wait (&helper2, 10000);
+	g_assert_cmpint (helper1.order, !=, 0);
+	g_assert_cmpint (helper2.order, >, helper1.order);
+	g_assert_cmpstr (gs_app_get_license (app), ==, "GPL-2.0+");
+	gs_test_flush_main_context ();
+}
+
 static void
 gs_plugins_dummy_metadata_quirks (GsPluginLoader *plugin_loader)
 {
@@ -302,6 +470,65 @@ gs_plugins_dummy_updates_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpint (gs_app_list_length (gs_app_get_related (app)), ==, 2);
 }
 
+static void
+gs_plugins_dummy_updates_partial_cb (GsPluginJob *plugin_job,
+				     GsAppList *list,
+				     gpointer user_data)
+{
+	guint *cnt = (guint *) user_data;
+	g_assert_cmpint (gs_app_list_length (list), >, 0);
+	(*cnt)++;
+}
+
+static void
+gs_plugins_dummy_updates_partial_func (GsPluginLoader *plugin_loader)
+{
+	GsApp *app;
+	guint cnt = 0;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	/* only the dummy plugin returns updates, so there is one batch */
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS,
+					 NULL);
+	gs_plugin_job_set_partial_func (plugin_job,
+					gs_plugins_dummy_updates_partial_cb,
+					&cnt);
+	list = gs_plugin_loader_job_process (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	g_assert_cmpint (cnt, ==, 1);
+	g_assert_cmpint (gs_app_list_length (list), ==, 3);
+
+	/* the OS update proxy was made from the whole list */
+	app = gs_app_list_lookup (list, "*/*/*/*/org.gnome.Software.OsUpdate/*");
+	g_assert (app != NULL);
+	g_assert_cmpint (gs_app_list_length (gs_app_get_related (app)), ==, 2);
+	g_clear_object (&list);
+	g_clear_object (&plugin_job);
+
+	/* restricted to a plugin that has no updates */
+	cnt = 0;
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS,
+					 NULL);
+	gs_plugin_job_set_plugin_only (plugin_job,
+				       gs_plugin_loader_find_plugin (plugin_loader, "appstream"));
+	gs_plugin_job_set_partial_func (plugin_job,
+					gs_plugins_dummy_updates_partial_cb,
+					&cnt);
+	list = gs_plugin_loader_job_process (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	g_assert_cmpint (cnt, ==, 0);
+	g_assert_cmpint (gs_app_list_length (list), ==, 0);
+}
+
 static void
 gs_plugins_dummy_distro_upgrades_func (GsPluginLoader *plugin_loader)
 {
@@ -351,6 +578,59 @@ gs_plugins_dummy_distro_upgrades_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpint (gs_app_get_state (app), ==, AS_APP_STATE_UPDATABLE);
 }
 
+static GsAppList *
+gs_plugins_dummy_get_category_page (GsPluginLoader *plugin_loader,
+				    guint offset,
+				    GsPluginRefineFlags refine_flags)
+{
+	GsAppList *list;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsCategory) category = gs_category_new ("paged");
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_CATEGORY_APPS,
+					 "category", category,
+					 "dedupe-flags", GS_APP_LIST_FILTER_FLAG_KEY_ID,
+					 "refine-flags", refine_flags,
+					 "offset", offset,
+					 "max-results", 2,
+					 NULL);
+	list = gs_plugin_loader_job_process (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	return list;
+}
+
+static void
+gs_plugins_dummy_category_paged_func (GsPluginLoader *plugin_loader)
+{
+	g_autoptr(GsAppList) list1 = NULL;
+	g_autoptr(GsAppList) list2 = NULL;
+
+	/* the duplicate of the second app would start the second page if the
+	 * results were paged before they were deduped */
+	list1 = gs_plugins_dummy_get_category_page (plugin_loader, 0,
+						    GS_PLUGIN_REFINE_FLAGS_REQUIRE_DESCRIPTION);
+	g_assert_cmpint (gs_app_list_length (list1), ==, 2);
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list1, 0)), ==, "paged-a.desktop");
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list1, 1)), ==, "paged-b.desktop");
+	g_assert_cmpstr (gs_app_get_description (gs_app_list_index (list1, 0)), ==, "Paged description");
+	g_assert_cmpstr (gs_app_get_description (gs_app_list_index (list1, 1)), ==, "Paged description");
+	g_assert (gs_app_list_has_flag (list1, GS_APP_LIST_FLAG_IS_TRUNCATED));
+
+	/* the last page is full and nothing is left, and the apps on it were
+	 * not refined when the first page was loaded */
+	list2 = gs_plugins_dummy_get_category_page (plugin_loader, 2,
+						    GS_PLUGIN_REFINE_FLAGS_DEFAULT);
+	g_assert_cmpint (gs_app_list_length (list2), ==, 2);
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list2, 0)), ==, "paged-c.desktop");
+	g_assert_cmpstr (gs_app_get_id (gs_app_list_index (list2, 1)), ==, "paged-d.desktop");
+	g_assert_cmpstr (gs_app_get_description (gs_app_list_index (list2, 0)), ==, NULL);
+	g_assert_cmpstr (gs_app_get_description (gs_app_list_index (list2, 1)), ==, NULL);
+	g_assert (!gs_app_list_has_flag (list2, GS_APP_LIST_FLAG_IS_TRUNCATED));
+}
+
 static void
 gs_plugins_dummy_installed_func (GsPluginLoader *plugin_loader)
 {
@@ -686,6 +966,64 @@ gs_plugins_dummy_wildcard_func (GsPluginLoader *plugin_loader)
 	}
 }
 
+typedef struct {
+	GMainLoop	*loop;
+	guint		 pending;
+	guint		 n_apps;
+} GsDummyBatchHelper;
+
+static void
+plugin_job_batch_cb (GObject *source,
+		     GAsyncResult *res,
+		     gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
+	GsDummyBatchHelper *helper = (GsDummyBatchHelper *) user_data;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	helper->n_apps += gs_app_list_length (list);
+	if (--helper->pending == 0)
+		g_main_loop_quit (helper->loop);
+}
+
+static void
+gs_plugins_dummy_batch_func (GsPluginLoader *plugin_loader)
+{
+	GsDummyBatchHelper helper = { NULL, 0, 0 };
+	g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+	g_autoptr(GsPluginJob) plugin_job1 = NULL;
+	g_autoptr(GsPluginJob) plugin_job2 = NULL;
+
+	/* both jobs are run together, with different refine flags */
+	helper.loop = loop;
+	gs_plugin_loader_batch_begin (plugin_loader);
+	plugin_job1 = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_RECENT,
+					  "age", (guint64) 60,
+					  "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON,
+					  NULL);
+	gs_plugin_loader_job_process_async (plugin_loader, plugin_job1, NULL,
+					    plugin_job_batch_cb, &helper);
+	helper.pending++;
+	plugin_job2 = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_RECENT,
+					  "age", (guint64) 60,
+					  "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+					  NULL);
+	gs_plugin_loader_job_process_async (plugin_loader, plugin_job2, NULL,
+					    plugin_job_batch_cb, &helper);
+	helper.pending++;
+	gs_plugin_loader_batch_end (plugin_loader, NULL);
+
+	/* each job gets its own results */
+	g_main_loop_run (loop);
+	gs_test_flush_main_context ();
+	g_assert_cmpint (helper.pending, ==, 0);
+	g_assert_cmpint (helper.n_apps, ==, 2);
+}
+
 static void
 gs_plugins_dummy_purchase_func (GsPluginLoader *plugin_loader)
 {
@@ -970,15 +1308,33 @@ main (int argc, char **argv)
 	g_test_add_data_func ("/gnome-software/plugins/dummy/installed",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_dummy_installed_func);
+	g_test_add_data_func ("/gnome-software/plugins/dummy/category{paged}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_dummy_category_paged_func);
 	g_test_add_data_func ("/gnome-software/plugins/dummy/refine",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_dummy_refine_func);
+	g_test_add_data_func ("/gnome-software/plugins/dummy/background",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_dummy_background_func);
+	g_test_add_data_func ("/gnome-software/plugins/dummy/background{paused}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_dummy_background_paused_func);
+	g_test_add_data_func ("/gnome-software/plugins/dummy/background{interactive}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_dummy_background_interactive_func);
 	g_test_add_data_func ("/gnome-software/plugins/dummy/updates",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_dummy_updates_func);
+	g_test_add_data_func ("/gnome-software/plugins/dummy/updates{partial}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_dummy_updates_partial_func);
 	g_test_add_data_func ("/gnome-software/plugins/dummy/distro-upgrades",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_dummy_distro_upgrades_func);
+	g_test_add_data_func ("/gnome-software/plugins/dummy/batch",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_dummy_batch_func);
 	g_test_add_data_func ("/gnome-software/plugins/dummy/purchase",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_dummy_purchase_func);
@@ -30,6 +30,8 @@ struct _GsFlatpakTransaction {
 	FlatpakInstallation	*installation;
 	GHashTable		*refhash;	/* ref:GsApp */
 	GError			*first_operation_error;
+	gboolean		 no_deploy;
+	guint64			 download_bytes;
 };
 
 enum {
@@ -86,6 +88,21 @@ gs_flatpak_transaction_add_app (FlatpakTransaction *transaction, GsApp *app)
 		gs_flatpak_transaction_add_app_internal (self, gs_app_get_runtime (app));
 }
 
+guint64
+gs_flatpak_transaction_get_download_bytes (FlatpakTransaction *transaction)
+{
+	GsFlatpakTransaction *self = GS_FLATPAK_TRANSACTION (transaction);
+	return self->download_bytes;
+}
+
+void
+gs_flatpak_transaction_set_no_deploy (FlatpakTransaction *transaction, gboolean no_deploy)
+{
+	GsFlatpakTransaction *self = GS_FLATPAK_TRANSACTION (transaction);
+	self->no_deploy = no_deploy;
+	flatpak_transaction_set_no_deploy (transaction, no_deploy);
+}
+
 static GsApp *
 _ref_to_app (GsFlatpakTransaction *self, const gchar *ref)
 {
@@ -120,7 +137,9 @@ gs_flatpak_transaction_run (FlatpakTransaction *transaction,
 
 	if (!flatpak_transaction_run (transaction, cancellable, &error_local)) {
 		/* whole transaction failed; restore the state for all the apps involved */
-		g_autolist(GObject) ops = flatpak_transaction_get_operations (transaction);
+		g_autolist(GObject) ops = NULL;
+		if (!self->no_deploy)
+			ops = flatpak_transaction_get_operations (transaction);
 		for (GList *l = ops; l != NULL; l = l->next) {
 			FlatpakTransactionOperation *op = l->data;
 			const gchar *ref = flatpak_transaction_operation_get_ref (op);
@@ -162,7 +181,8 @@ _transaction_ready (FlatpakTransaction *transaction)
 			_transaction_operation_set_app (op, app);
 			/* if we're updating a component, then mark all the apps
 			 * involved to ensure updating the button state */
-			if (flatpak_transaction_operation_get_operation_type (op) ==
+			if (!self->no_deploy &&
+			    flatpak_transaction_operation_get_operation_type (op) ==
 					FLATPAK_TRANSACTION_OPERATION_UPDATE)
 				gs_app_set_state (app, AS_APP_STATE_INSTALLING);
 		}
@@ -181,6 +201,27 @@ _transaction_progress_changed_cb (FlatpakTransactionProgress *progress,
 	gs_app_set_progress (app, percent);
 }
 
+#if FLATPAK_CHECK_VERSION(1,1,2)
+static void
+_transaction_progress_bytes_cb (FlatpakTransactionProgress *progress,
+				gpointer user_data)
+{
+	GsFlatpakTransaction *self = GS_FLATPAK_TRANSACTION (user_data);
+	guint64 bytes = flatpak_transaction_progress_get_bytes_transferred (progress);
+	guint64 *bytes_old = g_object_get_data (G_OBJECT (progress), "GsFlatpakTransaction::bytes");
+
+	/* only count what was fetched since the last time */
+	if (bytes_old == NULL) {
+		bytes_old = g_new0 (guint64, 1);
+		g_object_set_data_full (G_OBJECT (progress), "GsFlatpakTransaction::bytes",
+					bytes_old, g_free);
+	}
+	if (bytes > *bytes_old)
+		self->download_bytes += bytes - *bytes_old;
+	*bytes_old = bytes;
+}
+#endif
+
 static const gchar *
 _flatpak_transaction_operation_type_to_string (FlatpakTransactionOperationType ot)
 {
@@ -200,8 +241,16 @@ _transaction_new_operation (FlatpakTransaction *transaction,
 			    FlatpakTransactionOperation *operation,
 			    FlatpakTransactionProgress *progress)
 {
+	GsFlatpakTransaction *self = GS_FLATPAK_TRANSACTION (transaction);
 	GsApp *app;
 
+	/* count what is fetched, even for refs without an app */
+#if FLATPAK_CHECK_VERSION(1,1,2)
+	g_signal_connect_object (progress, "changed",
+				 G_CALLBACK (_transaction_progress_bytes_cb),
+				 self, 0);
+#endif
+
 	/* find app */
 	app = _transaction_operation_get_app (operation);
 	if (app == NULL) {
@@ -219,6 +268,10 @@ _transaction_new_operation (FlatpakTransaction *transaction,
 				 app, 0);
 	flatpak_transaction_progress_set_update_frequency (progress, 100); /* FIXME? */
 
+	/* only pulling, so the app is not changing */
+	if (self->no_deploy)
+		return;
+
 	/* set app status */
 	switch (flatpak_transaction_operation_get_operation_type (operation)) {
 	case FLATPAK_TRANSACTION_OPERATION_INSTALL:
@@ -252,6 +305,8 @@ _transaction_operation_done (FlatpakTransaction *transaction,
 #endif
 			     FlatpakTransactionResult details)
 {
+	GsFlatpakTransaction *self = GS_FLATPAK_TRANSACTION (transaction);
+
 	/* invalidate */
 	GsApp *app = _transaction_operation_get_app (operation);
 	if (app == NULL) {
@@ -259,6 +314,11 @@ _transaction_operation_done (FlatpakTransaction *transaction,
 			   flatpak_transaction_operation_get_ref (operation));
 		return;
 	}
+
+	/* nothing was deployed */
+	if (self->no_deploy)
+		return;
+
 	switch (flatpak_transaction_operation_get_operation_type (operation)) {
 	case FLATPAK_TRANSACTION_OPERATION_INSTALL:
 	case FLATPAK_TRANSACTION_OPERATION_INSTALL_BUNDLE:
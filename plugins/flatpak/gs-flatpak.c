@@ -48,6 +48,9 @@ struct _GsFlatpak {
 	XbSilo			*silo;
 	gchar			*id;
 	guint			 changed_id;
+	GHashTable		*installed_refs;	/* ref:GsApp */
+	gboolean		 installed_refs_dirty;
+	GMutex			 installed_refs_mutex;
 };
 
 G_DEFINE_TYPE (GsFlatpak, gs_flatpak, G_TYPE_OBJECT)
@@ -195,6 +198,11 @@ gs_plugin_flatpak_changed_cb (GFileMonitor *monitor,
 {
 	g_autoptr(GError) error = NULL;
 
+	/* the installed refs get diffed the next time they are needed */
+	g_mutex_lock (&self->installed_refs_mutex);
+	self->installed_refs_dirty = TRUE;
+	g_mutex_unlock (&self->installed_refs_mutex);
+
 	/* manually drop the cache */
 	if (!flatpak_installation_drop_caches (self->installation,
 					       NULL, &error)) {
@@ -892,11 +900,44 @@ gs_flatpak_create_installed (GsFlatpak *self,
 	return g_steal_pointer (&app);
 }
 
-gboolean
-gs_flatpak_add_installed (GsFlatpak *self, GsAppList *list,
-			  GCancellable *cancellable,
-			  GError **error)
+static gboolean
+gs_flatpak_installed_ref_is_unchanged (GsApp *app, FlatpakInstalledRef *xref)
+{
+	if (g_strcmp0 (gs_flatpak_app_get_commit (app),
+		       flatpak_ref_get_commit (FLATPAK_REF (xref))) != 0)
+		return FALSE;
+
+	/* the current branch of an app can be switched without a new commit */
+	if (flatpak_ref_get_kind (FLATPAK_REF (xref)) == FLATPAK_REF_KIND_APP &&
+	    !flatpak_installed_ref_get_is_current (xref))
+		return FALSE;
+	return TRUE;
+}
+
+/* an app we removed ourselves goes to AVAILABLE before the monitor fires */
+static gboolean
+gs_flatpak_installed_state_is_valid (GsApp *app)
 {
+	switch (gs_app_get_state (app)) {
+	case AS_APP_STATE_AVAILABLE:
+	case AS_APP_STATE_AVAILABLE_LOCAL:
+	case AS_APP_STATE_QUEUED_FOR_INSTALL:
+		return FALSE;
+	default:
+		return TRUE;
+	}
+}
+
+/* must be called with installed_refs_mutex held */
+static gboolean
+gs_flatpak_probe_installed_refs (GsFlatpak *self,
+				 GCancellable *cancellable,
+				 GError **error)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	guint unchanged = 0;
+	g_autoptr(GHashTable) installed_refs = NULL;
 	g_autoptr(GPtrArray) xrefs = NULL;
 
 	/* get apps and runtimes */
@@ -906,14 +947,95 @@ gs_flatpak_add_installed (GsFlatpak *self, GsAppList *list,
 		gs_flatpak_error_convert (error);
 		return FALSE;
 	}
+	installed_refs = g_hash_table_new_full (g_str_hash, g_str_equal,
+						g_free, (GDestroyNotify) g_object_unref);
 	for (guint i = 0; i < xrefs->len; i++) {
 		FlatpakInstalledRef *xref = g_ptr_array_index (xrefs, i);
+		GsApp *app_old;
+		g_autofree gchar *ref = flatpak_ref_format_ref (FLATPAK_REF (xref));
 		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GsApp) app = gs_flatpak_create_installed (self, xref, &error_local);
+		g_autoptr(GsApp) app = NULL;
+
+		/* only look at the deploy dir of refs that have changed */
+		app_old = g_hash_table_lookup (self->installed_refs, ref);
+		if (app_old != NULL && gs_flatpak_installed_ref_is_unchanged (app_old, xref)) {
+			if (!gs_flatpak_installed_state_is_valid (app_old))
+				gs_app_set_state (app_old, AS_APP_STATE_INSTALLED);
+			g_hash_table_insert (installed_refs,
+					     g_steal_pointer (&ref),
+					     g_object_ref (app_old));
+			unchanged++;
+			continue;
+		}
+		app = gs_flatpak_create_installed (self, xref, &error_local);
 		if (app == NULL) {
 			g_warning ("failed to add flatpak: %s", error_local->message);
 			continue;
 		}
+
+		/* installed outside of gnome-software */
+		if (gs_app_get_state (app) == AS_APP_STATE_AVAILABLE)
+			gs_app_set_state (app, AS_APP_STATE_UNKNOWN);
+		if (gs_app_get_state (app) == AS_APP_STATE_UNKNOWN)
+			gs_app_set_state (app, AS_APP_STATE_INSTALLED);
+		g_hash_table_insert (installed_refs,
+				     g_steal_pointer (&ref),
+				     g_steal_pointer (&app));
+	}
+
+	/* removed outside of gnome-software */
+	g_hash_table_iter_init (&iter, self->installed_refs);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		GsApp *app = GS_APP (value);
+		if (g_hash_table_contains (installed_refs, key))
+			continue;
+		switch (gs_app_get_state (app)) {
+		case AS_APP_STATE_INSTALLED:
+		case AS_APP_STATE_UPDATABLE:
+		case AS_APP_STATE_UPDATABLE_LIVE:
+			g_debug ("%s is no longer installed", (const gchar *) key);
+			gs_app_set_state (app, AS_APP_STATE_UNKNOWN);
+			break;
+		default:
+			break;
+		}
+	}
+
+	g_debug ("probed %u installed refs, %u unchanged", xrefs->len, unchanged);
+	g_hash_table_unref (self->installed_refs);
+	self->installed_refs = g_steal_pointer (&installed_refs);
+	self->installed_refs_dirty = FALSE;
+	return TRUE;
+}
+
+gboolean
+gs_flatpak_add_installed (GsFlatpak *self, GsAppList *list,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	GHashTableIter iter;
+	gpointer value;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->installed_refs_mutex);
+
+	/* the cache is also stale if an app in it is no longer installed */
+	if (!self->installed_refs_dirty) {
+		g_hash_table_iter_init (&iter, self->installed_refs);
+		while (g_hash_table_iter_next (&iter, NULL, &value)) {
+			if (!gs_flatpak_installed_state_is_valid (GS_APP (value))) {
+				self->installed_refs_dirty = TRUE;
+				break;
+			}
+		}
+	}
+
+	/* only list the installation again if something changed */
+	if (self->installed_refs_dirty) {
+		if (!gs_flatpak_probe_installed_refs (self, cancellable, error))
+			return FALSE;
+	}
+	g_hash_table_iter_init (&iter, self->installed_refs);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		GsApp *app = GS_APP (value);
 		if (gs_app_get_state (app) == AS_APP_STATE_UNKNOWN)
 			gs_app_set_state (app, AS_APP_STATE_INSTALLED);
 		gs_app_list_add (list, app);
@@ -1321,6 +1443,14 @@ gs_flatpak_add_updates (GsFlatpak *self, GsAppList *list,
 	return TRUE;
 }
 
+void
+gs_flatpak_invalidate_installed_refs (GsFlatpak *self)
+{
+	g_mutex_lock (&self->installed_refs_mutex);
+	self->installed_refs_dirty = TRUE;
+	g_mutex_unlock (&self->installed_refs_mutex);
+}
+
 gboolean
 gs_flatpak_refresh (GsFlatpak *self,
 		    guint cache_age,
@@ -1330,6 +1460,9 @@ gs_flatpak_refresh (GsFlatpak *self,
 	/* give all the repos a second chance */
 	g_hash_table_remove_all (self->broken_remotes);
 
+	/* do not trust any installed refs we have seen before */
+	gs_flatpak_invalidate_installed_refs (self);
+
 	/* manually drop the cache */
 	if (!flatpak_installation_drop_caches (self->installation,
 					       cancellable,
@@ -2701,6 +2834,8 @@ gs_flatpak_finalize (GObject *object)
 	g_object_unref (self->installation);
 	g_object_unref (self->plugin);
 	g_hash_table_unref (self->broken_remotes);
+	g_hash_table_unref (self->installed_refs);
+	g_mutex_clear (&self->installed_refs_mutex);
 
 	G_OBJECT_CLASS (gs_flatpak_parent_class)->finalize (object);
 }
@@ -2717,6 +2852,10 @@ gs_flatpak_init (GsFlatpak *self)
 {
 	self->broken_remotes = g_hash_table_new_full (g_str_hash, g_str_equal,
 						      g_free, NULL);
+	self->installed_refs = g_hash_table_new_full (g_str_hash, g_str_equal,
+						      g_free, (GDestroyNotify) g_object_unref);
+	self->installed_refs_dirty = TRUE;
+	g_mutex_init (&self->installed_refs_mutex);
 }
 
 GsFlatpak *
@@ -63,6 +63,7 @@ gboolean	gs_flatpak_add_updates		(GsFlatpak		*self,
 						 GsAppList		*list,
 						 GCancellable		*cancellable,
 						 GError			**error);
+void		gs_flatpak_invalidate_installed_refs (GsFlatpak		*self);
 gboolean	gs_flatpak_refresh		(GsFlatpak		*self,
 						 guint			 cache_age,
 						 GCancellable		*cancellable,
@@ -188,19 +188,167 @@ gs_plugin_setup (GsPlugin *plugin, GCancellable *cancellable, GError **error)
 	return TRUE;
 }
 
+/* runs one operation on a single GsFlatpak, adding any results to @list */
+typedef gboolean (*GsPluginFlatpakFunc)	(GsFlatpak	*flatpak,
+					 GsAppList	*list,
+					 gpointer	 user_data,
+					 GCancellable	*cancellable,
+					 GError		**error);
+
+typedef struct {
+	GsFlatpak		*flatpak;
+	GsPluginFlatpakFunc	 func;
+	gpointer		 user_data;
+	GsAppList		*list;		/* results private to this worker */
+	GCancellable		*cancellable;
+	GError			*error;
+	gboolean		 ret;
+} GsPluginFlatpakWorker;
+
+static gpointer
+gs_plugin_flatpak_worker_thread_cb (gpointer data)
+{
+	GsPluginFlatpakWorker *worker = (GsPluginFlatpakWorker *) data;
+	worker->ret = worker->func (worker->flatpak, worker->list,
+				    worker->user_data, worker->cancellable,
+				    &worker->error);
+
+	/* no point letting the other installations carry on */
+	if (!worker->ret)
+		g_cancellable_cancel (worker->cancellable);
+	return NULL;
+}
+
+static void
+gs_plugin_flatpak_cancelled_cb (GCancellable *cancellable, gpointer user_data)
+{
+	GCancellable *cancellable_workers = G_CANCELLABLE (user_data);
+	g_cancellable_cancel (cancellable_workers);
+}
+
+static gboolean
+gs_plugin_flatpak_worker_error_is_cancelled (GsPluginFlatpakWorker *worker)
+{
+	return g_error_matches (worker->error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED) ||
+	       g_error_matches (worker->error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+}
+
+/* run @func on every installation concurrently, so that the total time is
+ * that of the slowest installation rather than the sum of all of them; the
+ * results are merged into @list in installation order once all are done */
+static gboolean
+gs_plugin_flatpak_run_parallel (GsPlugin *plugin,
+				GsPluginFlatpakFunc func,
+				gpointer user_data,
+				GsAppList *list,
+				GCancellable *cancellable,
+				GError **error)
+{
+	GsPluginData *priv = gs_plugin_get_data (plugin);
+	GsPluginFlatpakWorker *worker_failed = NULL;
+	gulong cancellable_id = 0;
+	g_autoptr(GArray) workers = NULL;
+	g_autoptr(GCancellable) cancellable_workers = NULL;
+	g_autoptr(GPtrArray) threads = NULL;
+
+	/* nothing to parallelize */
+	if (priv->flatpaks->len == 1) {
+		GsFlatpak *flatpak = g_ptr_array_index (priv->flatpaks, 0);
+		return func (flatpak, list, user_data, cancellable, error);
+	}
+
+	/* a failure in one worker cancels the others, but not the caller */
+	cancellable_workers = g_cancellable_new ();
+	if (cancellable != NULL) {
+		cancellable_id = g_cancellable_connect (cancellable,
+							G_CALLBACK (gs_plugin_flatpak_cancelled_cb),
+							cancellable_workers,
+							NULL);
+	}
+
+	/* start a thread for each installation */
+	workers = g_array_sized_new (FALSE, TRUE, sizeof (GsPluginFlatpakWorker),
+				     priv->flatpaks->len);
+	g_array_set_size (workers, priv->flatpaks->len);
+	threads = g_ptr_array_new ();
+	for (guint i = 0; i < priv->flatpaks->len; i++) {
+		GsPluginFlatpakWorker *worker = &g_array_index (workers, GsPluginFlatpakWorker, i);
+		GThread *thread;
+		g_autoptr(GError) error_local = NULL;
+
+		worker->flatpak = g_ptr_array_index (priv->flatpaks, i);
+		worker->func = func;
+		worker->user_data = user_data;
+		worker->list = gs_app_list_new ();
+		worker->cancellable = cancellable_workers;
+		thread = g_thread_try_new ("gs-plugin-flatpak",
+					   gs_plugin_flatpak_worker_thread_cb,
+					   worker, &error_local);
+		if (thread == NULL) {
+			g_debug ("failed to create thread, running %s inline: %s",
+				 gs_flatpak_get_id (worker->flatpak),
+				 error_local->message);
+			gs_plugin_flatpak_worker_thread_cb (worker);
+			continue;
+		}
+		g_ptr_array_add (threads, thread);
+	}
+
+	/* wait for all of them to finish */
+	for (guint i = 0; i < threads->len; i++)
+		g_thread_join (g_ptr_array_index (threads, i));
+	if (cancellable_id != 0)
+		g_cancellable_disconnect (cancellable, cancellable_id);
+
+	/* merge the results in a predictable order, preferring the error that
+	 * caused the other workers to be cancelled */
+	for (guint i = 0; i < workers->len; i++) {
+		GsPluginFlatpakWorker *worker = &g_array_index (workers, GsPluginFlatpakWorker, i);
+		if (worker->ret) {
+			gs_app_list_add_list (list, worker->list);
+			continue;
+		}
+		if (worker_failed == NULL ||
+		    (gs_plugin_flatpak_worker_error_is_cancelled (worker_failed) &&
+		     !gs_plugin_flatpak_worker_error_is_cancelled (worker)))
+			worker_failed = worker;
+	}
+	if (worker_failed != NULL) {
+		if (worker_failed->error != NULL) {
+			g_propagate_error (error, g_steal_pointer (&worker_failed->error));
+		} else {
+			g_set_error (error,
+				     GS_PLUGIN_ERROR,
+				     GS_PLUGIN_ERROR_FAILED,
+				     "%s failed without setting an error",
+				     gs_flatpak_get_id (worker_failed->flatpak));
+		}
+	}
+	for (guint i = 0; i < workers->len; i++) {
+		GsPluginFlatpakWorker *worker = &g_array_index (workers, GsPluginFlatpakWorker, i);
+		g_clear_error (&worker->error);
+		g_object_unref (worker->list);
+	}
+	return worker_failed == NULL;
+}
+
+static gboolean
+gs_plugin_flatpak_add_installed_cb (GsFlatpak *flatpak, GsAppList *list,
+				    gpointer user_data,
+				    GCancellable *cancellable, GError **error)
+{
+	return gs_flatpak_add_installed (flatpak, list, cancellable, error);
+}
+
 gboolean
 gs_plugin_add_installed (GsPlugin *plugin,
 			 GsAppList *list,
 			 GCancellable *cancellable,
 			 GError **error)
 {
-	GsPluginData *priv = gs_plugin_get_data (plugin);
-	for (guint i = 0; i < priv->flatpaks->len; i++) {
-		GsFlatpak *flatpak = g_ptr_array_index (priv->flatpaks, i);
-		if (!gs_flatpak_add_installed (flatpak, list, cancellable, error))
-			return FALSE;
-	}
-	return TRUE;
+	return gs_plugin_flatpak_run_parallel (plugin,
+					       gs_plugin_flatpak_add_installed_cb,
+					       NULL, list, cancellable, error);
 }
 
 gboolean
@@ -218,19 +366,32 @@ gs_plugin_add_sources (GsPlugin *plugin,
 	return TRUE;
 }
 
+static gboolean
+gs_plugin_flatpak_add_updates_cb (GsFlatpak *flatpak, GsAppList *list,
+				  gpointer user_data,
+				  GCancellable *cancellable, GError **error)
+{
+	return gs_flatpak_add_updates (flatpak, list, cancellable, error);
+}
+
 gboolean
 gs_plugin_add_updates (GsPlugin *plugin,
 		       GsAppList *list,
 		       GCancellable *cancellable,
 		       GError **error)
 {
-	GsPluginData *priv = gs_plugin_get_data (plugin);
-	for (guint i = 0; i < priv->flatpaks->len; i++) {
-		GsFlatpak *flatpak = g_ptr_array_index (priv->flatpaks, i);
-		if (!gs_flatpak_add_updates (flatpak, list, cancellable, error))
-			return FALSE;
-	}
-	return TRUE;
+	return gs_plugin_flatpak_run_parallel (plugin,
+					       gs_plugin_flatpak_add_updates_cb,
+					       NULL, list, cancellable, error);
+}
+
+static gboolean
+gs_plugin_flatpak_refresh_cb (GsFlatpak *flatpak, GsAppList *list,
+			      gpointer user_data,
+			      GCancellable *cancellable, GError **error)
+{
+	guint cache_age = GPOINTER_TO_UINT (user_data);
+	return gs_flatpak_refresh (flatpak, cache_age, cancellable, error);
 }
 
 gboolean
@@ -239,13 +400,11 @@ gs_plugin_refresh (GsPlugin *plugin,
 		   GCancellable *cancellable,
 		   GError **error)
 {
-	GsPluginData *priv = gs_plugin_get_data (plugin);
-	for (guint i = 0; i < priv->flatpaks->len; i++) {
-		GsFlatpak *flatpak = g_ptr_array_index (priv->flatpaks, i);
-		if (!gs_flatpak_refresh (flatpak, cache_age, cancellable, error))
-			return FALSE;
-	}
-	return TRUE;
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+	return gs_plugin_flatpak_run_parallel (plugin,
+					       gs_plugin_flatpak_refresh_cb,
+					       GUINT_TO_POINTER (cache_age),
+					       list, cancellable, error);
 }
 
 static GsFlatpak *
@@ -448,49 +607,242 @@ _build_transaction (GsPlugin *plugin, GsFlatpak *flatpak,
 	return g_steal_pointer (&transaction);
 }
 
-gboolean
-gs_plugin_download (GsPlugin *plugin, GsAppList *list,
-		    GCancellable *cancellable, GError **error)
+/* what was pulled is counted even if the transaction failed part way */
+static gboolean
+_run_transaction (GsPlugin *plugin, FlatpakTransaction *transaction,
+		  GCancellable *cancellable, GError **error)
 {
-	GsFlatpak *flatpak = NULL;
-	g_autoptr(FlatpakTransaction) transaction = NULL;
-	g_autoptr(GsAppList) list_tmp = gs_app_list_new ();
+	gboolean ret = gs_flatpak_transaction_run (transaction, cancellable, error);
+	gs_plugin_add_download_bytes (plugin, gs_flatpak_transaction_get_download_bytes (transaction));
+	return ret;
+}
 
-	/* not supported */
-	for (guint i = 0; i < gs_app_list_length (list); i++) {
-		GsApp *app = gs_app_list_index (list, i);
-		flatpak = gs_plugin_flatpak_get_handler (plugin, app);
-		if (flatpak != NULL)
-			gs_app_list_add (list_tmp, app);
+typedef struct {
+	GsFlatpak	*flatpak;
+	gchar		*ref;
+	GsApp		*app;		/* nullable, only used for progress */
+} GsPluginFlatpakDownload;
+
+static void
+gs_plugin_flatpak_download_free (GsPluginFlatpakDownload *download)
+{
+	g_free (download->ref);
+	g_clear_object (&download->app);
+	g_free (download);
+}
+
+static void
+gs_plugin_flatpak_download_add (GHashTable *seen,
+				GPtrArray *downloads,
+				GsFlatpak *flatpak,
+				const gchar *ref,
+				GsApp *app)
+{
+	GsPluginFlatpakDownload *download;
+	gchar *key = g_strdup_printf ("%s:%s", gs_flatpak_get_id (flatpak), ref);
+
+	/* shared runtimes and extensions are only pulled once */
+	if (!g_hash_table_add (seen, key))
+		return;
+	download = g_new0 (GsPluginFlatpakDownload, 1);
+	download->flatpak = flatpak;
+	download->ref = g_strdup (ref);
+	download->app = app != NULL ? g_object_ref (app) : NULL;
+	g_ptr_array_add (downloads, download);
+}
+
+static void
+gs_plugin_flatpak_download_resolve (GsPlugin *plugin,
+				    GsApp *app,
+				    GHashTable *seen,
+				    GPtrArray *downloads,
+				    GCancellable *cancellable)
+{
+	GsFlatpak *flatpak = gs_plugin_flatpak_get_handler (plugin, app);
+	g_autofree gchar *ref = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) xrefs = NULL;
+
+	if (flatpak == NULL || gs_flatpak_app_get_ref_name (app) == NULL)
+		return;
+	ref = gs_flatpak_app_get_ref_display (app);
+	gs_plugin_flatpak_download_add (seen, downloads, flatpak, ref, app);
+
+	/* locales and other extensions are separate refs */
+	xrefs = flatpak_installation_list_installed_related_refs_sync (gs_flatpak_get_installation (flatpak),
+								       gs_app_get_origin (app),
+								       ref,
+								       cancellable,
+								       &error_local);
+	if (xrefs == NULL) {
+		g_debug ("failed to get related refs of %s: %s",
+			 ref, error_local->message);
+		return;
 	}
-	if (flatpak == NULL)
-		return TRUE;
+	for (guint i = 0; i < xrefs->len; i++) {
+		FlatpakRelatedRef *xref = g_ptr_array_index (xrefs, i);
+		g_autofree gchar *ref_related = NULL;
+		if (!flatpak_related_ref_should_download (xref))
+			continue;
+		ref_related = flatpak_ref_format_ref (FLATPAK_REF (xref));
+		gs_plugin_flatpak_download_add (seen, downloads, flatpak,
+						ref_related, NULL);
+	}
+}
+
+static gboolean
+gs_plugin_flatpak_download_ref (GsPlugin *plugin,
+				GsPluginFlatpakDownload *download,
+				GCancellable *cancellable,
+				GError **error)
+{
+	g_autoptr(FlatpakTransaction) transaction = NULL;
 
 	/* build and run non-deployed transaction */
-	transaction = _build_transaction (plugin, flatpak, cancellable, error);
+	transaction = _build_transaction (plugin, download->flatpak, cancellable, error);
 	if (transaction == NULL) {
 		gs_flatpak_error_convert (error);
 		return FALSE;
 	}
-	flatpak_transaction_set_no_deploy (transaction, TRUE);
-	for (guint i = 0; i < gs_app_list_length (list_tmp); i++) {
-		GsApp *app = gs_app_list_index (list_tmp, i);
-		g_autofree gchar *ref = NULL;
-
-		ref = gs_flatpak_app_get_ref_display (app);
-		if (!flatpak_transaction_add_update (transaction, ref, NULL, NULL, error)) {
-			g_prefix_error (error, "failed to add update ref %s: ", ref);
-			gs_flatpak_error_convert (error);
-			return FALSE;
+	gs_flatpak_transaction_set_no_deploy (transaction, TRUE);
+
+	/* the runtime and related refs were resolved up front */
+	flatpak_transaction_set_disable_dependencies (transaction, TRUE);
+	flatpak_transaction_set_disable_related (transaction, TRUE);
+	if (download->app != NULL)
+		gs_flatpak_transaction_add_app (transaction, download->app);
+	if (!flatpak_transaction_add_update (transaction, download->ref,
+					     NULL, NULL, error)) {
+		g_prefix_error (error, "failed to add update ref %s: ", download->ref);
+		gs_flatpak_error_convert (error);
+		return FALSE;
+	}
+	if (!_run_transaction (plugin, transaction, cancellable, error)) {
+		g_prefix_error (error, "failed to download %s: ", download->ref);
+		gs_flatpak_error_convert (error);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+typedef struct {
+	GsPlugin	*plugin;
+	GPtrArray	*downloads;
+	guint		 idx;
+	GMutex		 mutex;
+	GCancellable	*cancellable;
+} GsPluginFlatpakDownloadHelper;
+
+static gpointer
+gs_plugin_flatpak_download_thread_cb (gpointer user_data)
+{
+	GsPluginFlatpakDownloadHelper *helper = (GsPluginFlatpakDownloadHelper *) user_data;
+
+	/* pull the next ref until there are none left; a failed pull does
+	 * not stop the others, only cancelling does, and the app is pulled
+	 * again with its own error when it is updated */
+	while (!g_cancellable_is_cancelled (helper->cancellable)) {
+		GsPluginFlatpakDownload *download;
+		g_autoptr(GError) error_local = NULL;
+
+		g_mutex_lock (&helper->mutex);
+		if (helper->idx >= helper->downloads->len) {
+			g_mutex_unlock (&helper->mutex);
+			break;
+		}
+		download = g_ptr_array_index (helper->downloads, helper->idx++);
+		g_mutex_unlock (&helper->mutex);
+
+		if (!gs_plugin_flatpak_download_ref (helper->plugin, download,
+						     helper->cancellable,
+						     &error_local)) {
+			g_debug ("failed to pre-stage %s: %s",
+				 download->ref, error_local->message);
+		}
+	}
+	return NULL;
+}
+
+gboolean
+gs_plugin_download (GsPlugin *plugin, GsAppList *list,
+		    GCancellable *cancellable, GError **error)
+{
+	GsPluginFlatpakDownloadHelper helper = { 0 };
+	guint n_threads;
+	g_autoptr(GHashTable) seen = NULL;
+	g_autoptr(GPtrArray) downloads = NULL;
+	g_autoptr(GPtrArray) threads = g_ptr_array_new ();
+	g_autoptr(GSettings) settings = NULL;
+
+	/* resolve every ref to pull, runtimes first as they are shared */
+	seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	downloads = g_ptr_array_new_with_free_func ((GDestroyNotify) gs_plugin_flatpak_download_free);
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GsApp *runtime = gs_app_get_runtime (app);
+		if (gs_plugin_flatpak_get_handler (plugin, app) == NULL)
+			continue;
+		if (runtime != NULL && gs_app_is_installed (runtime)) {
+			gs_plugin_flatpak_download_resolve (plugin, runtime, seen,
+							    downloads, cancellable);
+		}
+	}
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		gs_plugin_flatpak_download_resolve (plugin, app, seen,
+						    downloads, cancellable);
+	}
+	if (downloads->len == 0)
+		return TRUE;
+
+	/* the pulls are independent, so do a few at once; deploying is
+	 * still done one app at a time in gs_plugin_update_app() */
+	settings = g_settings_new ("org.gnome.software");
+	n_threads = g_settings_get_uint (settings, "flatpak-max-parallel-downloads");
+	n_threads = CLAMP (n_threads, 1, downloads->len);
+	helper.plugin = plugin;
+	helper.downloads = downloads;
+	helper.cancellable = cancellable;
+	g_mutex_init (&helper.mutex);
+	for (guint i = 1; i < n_threads; i++) {
+		GThread *thread;
+		g_autoptr(GError) error_local = NULL;
+		thread = g_thread_try_new ("gs-flatpak-download",
+					   gs_plugin_flatpak_download_thread_cb,
+					   &helper, &error_local);
+		if (thread == NULL) {
+			g_warning ("failed to create download thread: %s",
+				   error_local->message);
+			break;
 		}
+		g_ptr_array_add (threads, thread);
 	}
-	if (!gs_flatpak_transaction_run (transaction, cancellable, error)) {
+	g_debug ("downloading %u flatpak refs using %u threads",
+		 downloads->len, threads->len + 1);
+
+	/* this thread helps too */
+	gs_plugin_flatpak_download_thread_cb (&helper);
+	for (guint i = 0; i < threads->len; i++)
+		g_thread_join (g_ptr_array_index (threads, i));
+	g_mutex_clear (&helper.mutex);
+
+	/* this is best effort; one bad remote must not stop the other
+	 * plugins from updating their apps */
+	if (g_cancellable_set_error_if_cancelled (cancellable, error)) {
 		gs_flatpak_error_convert (error);
 		return FALSE;
 	}
 	return TRUE;
 }
 
+gboolean
+gs_plugin_update (GsPlugin *plugin, GsAppList *list,
+		  GCancellable *cancellable, GError **error)
+{
+	/* pre-stage all the downloads before deploying each app */
+	return gs_plugin_download (plugin, list, cancellable, error);
+}
+
 gboolean
 gs_plugin_app_remove (GsPlugin *plugin,
 		      GsApp *app,
@@ -498,6 +850,7 @@ gs_plugin_app_remove (GsPlugin *plugin,
 		      GError **error)
 {
 	GsFlatpak *flatpak;
+	gboolean ret;
 	g_autoptr(FlatpakTransaction) transaction = NULL;
 	g_autofree gchar *ref = NULL;
 
@@ -525,7 +878,9 @@ gs_plugin_app_remove (GsPlugin *plugin,
 
 	/* run transaction */
 	gs_app_set_state (app, AS_APP_STATE_REMOVING);
-	if (!gs_flatpak_transaction_run (transaction, cancellable, error)) {
+	ret = gs_flatpak_transaction_run (transaction, cancellable, error);
+	gs_flatpak_invalidate_installed_refs (flatpak);
+	if (!ret) {
 		g_prefix_error (error, "failed to run transaction for %s: ", ref);
 		gs_flatpak_error_convert (error);
 		gs_app_set_state_recover (app);
@@ -562,6 +917,7 @@ gs_plugin_app_install (GsPlugin *plugin,
 {
 	GsPluginData *priv = gs_plugin_get_data (plugin);
 	GsFlatpak *flatpak;
+	gboolean ret;
 	g_autoptr(FlatpakTransaction) transaction = NULL;
 
 	/* queue for install if installation needs the network */
@@ -663,7 +1019,9 @@ gs_plugin_app_install (GsPlugin *plugin,
 
 	/* run transaction */
 	gs_app_set_state (app, AS_APP_STATE_INSTALLING);
-	if (!gs_flatpak_transaction_run (transaction, cancellable, error)) {
+	ret = _run_transaction (plugin, transaction, cancellable, error);
+	gs_flatpak_invalidate_installed_refs (flatpak);
+	if (!ret) {
 		g_prefix_error (error, "failed to run transaction for %s: ",
 				gs_app_get_unique_id (app));
 		gs_flatpak_error_convert (error);
@@ -694,6 +1052,7 @@ gs_plugin_update_app (GsPlugin *plugin,
 		      GError **error)
 {
 	GsFlatpak *flatpak;
+	gboolean ret;
 	g_autoptr(FlatpakTransaction) transaction = NULL;
 	g_autofree gchar *ref = NULL;
 
@@ -717,7 +1076,9 @@ gs_plugin_update_app (GsPlugin *plugin,
 
 	/* run transaction */
 	gs_app_set_state (app, AS_APP_STATE_INSTALLING);
-	if (!gs_flatpak_transaction_run (transaction, cancellable, error)) {
+	ret = _run_transaction (plugin, transaction, cancellable, error);
+	gs_flatpak_invalidate_installed_refs (flatpak);
+	if (!ret) {
 		g_prefix_error (error, "failed to run transaction for %s: ", ref);
 		gs_flatpak_error_convert (error);
 		gs_app_set_state_recover (app);
@@ -933,6 +1294,15 @@ gs_plugin_file_to_app (GsPlugin *plugin,
 	return TRUE;
 }
 
+static gboolean
+gs_plugin_flatpak_search_cb (GsFlatpak *flatpak, GsAppList *list,
+			     gpointer user_data,
+			     GCancellable *cancellable, GError **error)
+{
+	gchar **values = (gchar **) user_data;
+	return gs_flatpak_search (flatpak, values, list, cancellable, error);
+}
+
 gboolean
 gs_plugin_add_search (GsPlugin *plugin,
 		      gchar **values,
@@ -940,15 +1310,9 @@ gs_plugin_add_search (GsPlugin *plugin,
 		      GCancellable *cancellable,
 		      GError **error)
 {
-	GsPluginData *priv = gs_plugin_get_data (plugin);
-	for (guint i = 0; i < priv->flatpaks->len; i++) {
-		GsFlatpak *flatpak = g_ptr_array_index (priv->flatpaks, i);
-		if (!gs_flatpak_search (flatpak, values, list,
-					cancellable, error)) {
-			return FALSE;
-		}
-	}
-	return TRUE;
+	return gs_plugin_flatpak_run_parallel (plugin,
+					       gs_plugin_flatpak_search_cb,
+					       values, list, cancellable, error);
 }
 
 gboolean
@@ -67,6 +67,25 @@ gs_flatpak_test_write_ref_file (const gchar *filename, const gchar *url, const g
 	return g_file_set_contents (filename, str->str, -1, error);
 }
 
+static gboolean
+gs_flatpak_test_get_installed_contains (GsPluginLoader *plugin_loader, const gchar *id)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_INSTALLED, NULL);
+	list = gs_plugin_loader_job_process (plugin_loader, plugin_job, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		if (g_strcmp0 (gs_app_get_id (app), id) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 /* create duplicate file as if downloaded in firefox */
 static void
 gs_plugins_flatpak_repo_non_ascii_func (GsPluginLoader *plugin_loader)
@@ -372,6 +391,7 @@ gs_plugins_flatpak_app_with_runtime_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpstr (gs_app_get_version (app), ==, "1.2.3");
 	g_assert_cmpint (gs_app_get_progress (app), ==, 0);
 	g_assert_cmpint (gs_app_get_state (runtime), ==, AS_APP_STATE_INSTALLED);
+	g_assert (gs_flatpak_test_get_installed_contains (plugin_loader, "org.test.Chiron"));
 
 	/* check the application exists in the right places */
 	metadata_fn = g_build_filename (root,
@@ -424,6 +444,9 @@ gs_plugins_flatpak_app_with_runtime_func (GsPluginLoader *plugin_loader)
 	g_assert (!g_file_test (metadata_fn, G_FILE_TEST_IS_REGULAR));
 	g_assert (!g_file_test (desktop_fn, G_FILE_TEST_IS_REGULAR));
 
+	/* the installed list must not wait for the file monitor */
+	g_assert (!gs_flatpak_test_get_installed_contains (plugin_loader, "org.test.Chiron"));
+
 	/* install again, to check whether the progress gets initialized */
 	g_object_unref (plugin_job);
 	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_INSTALL,
@@ -1478,6 +1501,180 @@ gs_plugins_flatpak_app_update_func (GsPluginLoader *plugin_loader)
 	g_assert_cmpint (gs_app_get_state (app_source), ==, AS_APP_STATE_AVAILABLE);
 }
 
+static void
+gs_plugins_flatpak_app_update_failed_ref_func (GsPluginLoader *plugin_loader)
+{
+	GsApp *app;
+	GsApp *old_runtime;
+	GsApp *runtime;
+	gboolean ret;
+	g_autofree gchar *repodir1_fn = NULL;
+	g_autofree gchar *repodir2_fn = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsApp) app_missing = NULL;
+	g_autoptr(GsApp) app_source = NULL;
+	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GsAppList) list_update = gs_app_list_new ();
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	/* drop all caches */
+	g_unlink ("/var/tmp/self-test/flatpak-user/components.xmlb");
+	g_unlink ("/var/tmp/self-test/appstream/components.xmlb");
+	gs_plugin_loader_setup_again (plugin_loader);
+
+	/* no flatpak, abort */
+	if (!gs_plugin_loader_get_enabled (plugin_loader, "flatpak"))
+		return;
+
+	/* no files to use */
+	repodir1_fn = gs_test_get_filename (TESTDATADIR, "app-with-runtime/repo");
+	repodir2_fn = gs_test_get_filename (TESTDATADIR, "app-update/repo");
+	if (repodir1_fn == NULL || repodir2_fn == NULL ||
+	    !g_file_test (repodir1_fn, G_FILE_TEST_EXISTS) ||
+	    !g_file_test (repodir2_fn, G_FILE_TEST_EXISTS)) {
+		g_test_skip ("no flatpak test repo");
+		return;
+	}
+	unlink ("/var/tmp/self-test/repo");
+	g_assert (symlink (repodir1_fn, "/var/tmp/self-test/repo") == 0);
+
+	/* add a remote */
+	app_source = gs_flatpak_app_new ("test");
+	gs_app_set_kind (app_source, AS_APP_KIND_SOURCE);
+	gs_app_set_management_plugin (app_source, "flatpak");
+	gs_app_set_state (app_source, AS_APP_STATE_AVAILABLE);
+	gs_flatpak_app_set_repo_url (app_source, "file:///var/tmp/self-test/repo");
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_INSTALL,
+					 "app", app_source,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* refresh the appstream metadata */
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFRESH,
+					 "age", (guint64) G_MAXUINT,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	/* install the old version */
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_SEARCH,
+					 "search", "Bingo",
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_RUNTIME,
+					 NULL);
+	list = gs_plugin_loader_job_process (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	g_assert_cmpint (gs_app_list_length (list), ==, 1);
+	app = gs_app_list_index (list, 0);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_INSTALL,
+					 "app", app,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_assert_cmpstr (gs_app_get_version (app), ==, "1.2.3");
+	old_runtime = gs_app_get_runtime (app);
+	g_assert (old_runtime != NULL);
+	g_object_ref (old_runtime);
+
+	/* switch to the new repo and find the update */
+	g_assert (unlink ("/var/tmp/self-test/repo") == 0);
+	g_assert (symlink (repodir2_fn, "/var/tmp/self-test/repo") == 0);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFRESH,
+					 "age", (guint64) 0,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS,
+					 NULL);
+	g_object_unref (list);
+	list = gs_plugin_loader_job_process (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (list != NULL);
+	g_assert_cmpint (gs_app_get_state (app), ==, AS_APP_STATE_UPDATABLE_LIVE);
+
+	/* an update for a ref that is in no remote fails to pull */
+	app_missing = gs_flatpak_app_new ("org.test.Missing");
+	gs_app_set_kind (app_missing, AS_APP_KIND_DESKTOP);
+	gs_app_set_scope (app_missing, AS_APP_SCOPE_USER);
+	gs_app_set_origin (app_missing, "test");
+	gs_app_set_management_plugin (app_missing, "flatpak");
+	gs_app_set_state (app_missing, AS_APP_STATE_UPDATABLE_LIVE);
+	gs_flatpak_app_set_ref_kind (app_missing, FLATPAK_REF_KIND_APP);
+	gs_flatpak_app_set_ref_name (app_missing, "org.test.Missing");
+	gs_flatpak_app_set_ref_arch (app_missing, flatpak_get_default_arch ());
+	gs_flatpak_app_set_ref_branch (app_missing, "master");
+
+	/* the good app is still updated, and only the missing one fails */
+	gs_app_list_add (list_update, app);
+	gs_app_list_add (list_update, app_missing);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_UPDATE,
+					 "list", list_update,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert (error != NULL);
+	g_assert (!ret);
+	g_clear_error (&error);
+	g_assert_cmpint (gs_app_get_state (app), ==, AS_APP_STATE_INSTALLED);
+	g_assert_cmpstr (gs_app_get_version (app), ==, "1.2.4");
+	runtime = gs_app_get_runtime (app);
+	g_assert (runtime != NULL);
+	g_assert_cmpstr (gs_app_get_branch (runtime), ==, "new_master");
+	g_object_ref (runtime);
+
+	/* remove the app, both runtimes and the remote */
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REMOVE,
+					 "app", app,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REMOVE,
+					 "app", old_runtime,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_object_unref (old_runtime);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REMOVE,
+					 "app", runtime,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_object_unref (runtime);
+	g_object_unref (plugin_job);
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REMOVE,
+					 "app", app_source,
+					 NULL);
+	ret = gs_plugin_loader_job_action (plugin_loader, plugin_job, NULL, &error);
+	gs_test_flush_main_context ();
+	g_assert_no_error (error);
+	g_assert (ret);
+}
+
 static void
 gs_plugins_flatpak_runtime_extension_func (GsPluginLoader *plugin_loader)
 {
@@ -1794,6 +1991,9 @@ main (int argc, char **argv)
 	g_test_add_data_func ("/gnome-software/plugins/flatpak/app-update-runtime",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_flatpak_app_update_func);
+	g_test_add_data_func ("/gnome-software/plugins/flatpak/app-update{failed-ref}",
+			      plugin_loader,
+			      (GTestDataFunc) gs_plugins_flatpak_app_update_failed_ref_func);
 	g_test_add_data_func ("/gnome-software/plugins/flatpak/repo",
 			      plugin_loader,
 			      (GTestDataFunc) gs_plugins_flatpak_repo_func);
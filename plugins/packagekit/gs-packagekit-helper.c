@@ -30,6 +30,7 @@ struct _GsPackagekitHelper {
 	GObject			 parent_instance;
 	GHashTable		*apps;
 	GsPlugin		*plugin;
+	guint64			 download_size_remaining;
 };
 
 G_DEFINE_TYPE (GsPackagekitHelper, gs_packagekit_helper, G_TYPE_OBJECT)
@@ -55,6 +56,16 @@ gs_packagekit_helper_cb (PkProgress *progress, PkProgressType type, gpointer use
 		gint percentage = pk_progress_get_percentage (progress);
 		if (app != NULL && percentage >= 0 && percentage <= 100)
 			gs_app_set_progress (app, (guint) percentage);
+	} else if (type == PK_PROGRESS_TYPE_DOWNLOAD_SIZE_REMAINING) {
+		guint64 remaining = pk_progress_get_download_size_remaining (progress);
+
+		/* the daemon does the fetching, so count what it has done
+		 * since the last update; it goes up for a new transaction */
+		if (remaining < self->download_size_remaining) {
+			gs_plugin_add_download_bytes (plugin,
+						      self->download_size_remaining - remaining);
+		}
+		self->download_size_remaining = remaining;
 	}
 
 	/* Only go from TRUE to FALSE - it doesn't make sense for a package
@@ -0,0 +1,400 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include "gs-app-prefetcher.h"
+#include "gs-details-page.h"
+
+/* the prefetches are only a guess, so never let them compete much with
+ * what the user actually asked for, nor keep too many apps alive */
+#define GS_APP_PREFETCHER_MAX_IN_FLIGHT		2
+#define GS_APP_PREFETCHER_MAX_PENDING		16
+#define GS_APP_PREFETCHER_MAX_APPS		64
+
+struct _GsAppPrefetcher
+{
+	GObject			 parent_instance;
+
+	GsPluginLoader		*plugin_loader;
+	GCancellable		*cancellable;
+	GQueue			*pending;	/* of GsApp, newest first */
+	GHashTable		*in_flight;	/* GsApp : GPtrArray of waiting GTask */
+	GQueue			*done;		/* of GsApp, newest first */
+	GHashTable		*done_hash;	/* GsApp : AsAppState when done */
+};
+
+G_DEFINE_TYPE (GsAppPrefetcher, gs_app_prefetcher, G_TYPE_OBJECT)
+
+static void gs_app_prefetcher_run (GsAppPrefetcher *self);
+
+typedef struct {
+	GsAppPrefetcher	*self;
+	GsApp		*app;
+	GCancellable	*cancellable;
+} GsAppPrefetcherHelper;
+
+static void
+gs_app_prefetcher_helper_free (GsAppPrefetcherHelper *helper)
+{
+	g_object_unref (helper->self);
+	g_object_unref (helper->app);
+	g_object_unref (helper->cancellable);
+	g_slice_free (GsAppPrefetcherHelper, helper);
+}
+
+static void gs_app_prefetcher_app_state_notify_cb (GsApp *app,
+						   GParamSpec *pspec,
+						   GsAppPrefetcher *self);
+
+static void
+gs_app_prefetcher_drop_done (GsAppPrefetcher *self, GsApp *app)
+{
+	g_hash_table_remove (self->done_hash, app);
+	g_signal_handlers_disconnect_by_func (app,
+					      gs_app_prefetcher_app_state_notify_cb,
+					      self);
+	g_object_unref (app);
+}
+
+/* returns TRUE if the app had been prefetched */
+static gboolean
+gs_app_prefetcher_remove_done (GsAppPrefetcher *self, GsApp *app)
+{
+	if (!g_hash_table_contains (self->done_hash, app))
+		return FALSE;
+	g_queue_remove (self->done, app);
+	gs_app_prefetcher_drop_done (self, app);
+	return TRUE;
+}
+
+static void
+gs_app_prefetcher_clear_done (GsAppPrefetcher *self)
+{
+	while (!g_queue_is_empty (self->done))
+		gs_app_prefetcher_drop_done (self, g_queue_pop_head (self->done));
+}
+
+/* installing, updating or removing changes what the packaging system knows;
+ * the notification is emitted from an idle, so it can arrive after the
+ * refine that set the state has completed */
+static void
+gs_app_prefetcher_app_state_notify_cb (GsApp *app,
+				       GParamSpec *pspec,
+				       GsAppPrefetcher *self)
+{
+	gpointer state = g_hash_table_lookup (self->done_hash, app);
+	if (GPOINTER_TO_UINT (state) == gs_app_get_state (app))
+		return;
+	gs_app_prefetcher_remove_done (self, app);
+}
+
+static void
+gs_app_prefetcher_add_done (GsAppPrefetcher *self, GsApp *app)
+{
+	g_queue_push_head (self->done, g_object_ref (app));
+	g_hash_table_insert (self->done_hash, app,
+			     GUINT_TO_POINTER (gs_app_get_state (app)));
+	g_signal_connect (app, "notify::state",
+			  G_CALLBACK (gs_app_prefetcher_app_state_notify_cb),
+			  self);
+
+	/* drop the ones that have been waiting longest */
+	while (self->done->length > GS_APP_PREFETCHER_MAX_APPS)
+		gs_app_prefetcher_drop_done (self, g_queue_pop_tail (self->done));
+}
+
+static void
+gs_app_prefetcher_refine_cb (GObject *source,
+			     GAsyncResult *res,
+			     gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
+	GsAppPrefetcherHelper *helper = (GsAppPrefetcherHelper *) user_data;
+	GsAppPrefetcher *self = helper->self;
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) waiters = NULL;
+
+	ret = gs_plugin_loader_job_action_finish (plugin_loader, res, &error);
+
+	/* the waiters have already been told when this was cancelled, and
+	 * the app may be in flight again for a newer prefetch */
+	if (g_cancellable_is_cancelled (helper->cancellable)) {
+		gs_app_prefetcher_helper_free (helper);
+		return;
+	}
+
+	waiters = g_ptr_array_ref (g_hash_table_lookup (self->in_flight, helper->app));
+	g_hash_table_remove (self->in_flight, helper->app);
+	if (!ret) {
+		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
+			g_debug ("failed to prefetch %s: %s",
+				 gs_app_get_unique_id (helper->app),
+				 error->message);
+		}
+	} else {
+		g_debug ("prefetched %s", gs_app_get_unique_id (helper->app));
+	}
+
+	/* anyone waiting uses the result straight away, or has to refine
+	 * the app itself if the prefetch failed */
+	for (guint i = 0; i < waiters->len; i++)
+		g_task_return_boolean (g_ptr_array_index (waiters, i), ret);
+	if (ret && waiters->len == 0)
+		gs_app_prefetcher_add_done (self, helper->app);
+	gs_app_prefetcher_helper_free (helper);
+
+	/* start the next one */
+	gs_app_prefetcher_run (self);
+}
+
+static void
+gs_app_prefetcher_run (GsAppPrefetcher *self)
+{
+	while (g_hash_table_size (self->in_flight) < GS_APP_PREFETCHER_MAX_IN_FLIGHT &&
+	       !g_queue_is_empty (self->pending)) {
+		GsAppPrefetcherHelper *helper;
+		g_autoptr(GsApp) app = g_queue_pop_head (self->pending);
+		g_autoptr(GsPluginJob) plugin_job = NULL;
+
+		helper = g_slice_new0 (GsAppPrefetcherHelper);
+		helper->self = g_object_ref (self);
+		helper->app = g_object_ref (app);
+		helper->cancellable = g_object_ref (self->cancellable);
+		g_hash_table_insert (self->in_flight, app,
+				     g_ptr_array_new_with_free_func (g_object_unref));
+
+		/* the details page always asks the packaging system itself, as
+		 * that changes whenever the app is installed or updated */
+		plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+						 "app", app,
+						 "refine-flags", GS_DETAILS_PAGE_REFINE_FLAGS_METADATA,
+						 NULL);
+		gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job,
+						    helper->cancellable,
+						    gs_app_prefetcher_refine_cb,
+						    helper);
+	}
+}
+
+/**
+ * gs_app_prefetcher_add_app:
+ * @self: A #GsAppPrefetcher
+ * @app: A #GsApp
+ *
+ * Refines the application in the background with the flags the details page
+ * needs, as the user is likely to look at it soon. The most recently added
+ * applications are prefetched first.
+ */
+void
+gs_app_prefetcher_add_app (GsAppPrefetcher *self, GsApp *app)
+{
+	g_return_if_fail (GS_IS_APP_PREFETCHER (self));
+	g_return_if_fail (GS_IS_APP (app));
+
+	/* already done or being done */
+	if (g_hash_table_contains (self->done_hash, app) ||
+	    g_hash_table_contains (self->in_flight, app))
+		return;
+
+	/* move to the front if already queued */
+	if (g_queue_remove (self->pending, app))
+		g_object_unref (app);
+	g_queue_push_head (self->pending, g_object_ref (app));
+	while (self->pending->length > GS_APP_PREFETCHER_MAX_PENDING)
+		g_object_unref (g_queue_pop_tail (self->pending));
+
+	gs_app_prefetcher_run (self);
+}
+
+/**
+ * gs_app_prefetcher_has_app:
+ * @self: A #GsAppPrefetcher
+ * @app: A #GsApp
+ *
+ * Returns: %TRUE if @app has been prefetched and not claimed since
+ */
+gboolean
+gs_app_prefetcher_has_app (GsAppPrefetcher *self, GsApp *app)
+{
+	g_return_val_if_fail (GS_IS_APP_PREFETCHER (self), FALSE);
+	return g_hash_table_contains (self->done_hash, app);
+}
+
+/**
+ * gs_app_prefetcher_claim_app_async:
+ * @self: A #GsAppPrefetcher
+ * @app: A #GsApp
+ * @cancellable: A #GCancellable, or %NULL
+ * @callback: function to call when complete
+ * @user_data: user data to pass to @callback
+ *
+ * Takes the prefetched metadata of @app for the details page. If @app is
+ * being prefetched right now this waits for it rather than refining the app
+ * twice. Either way the prefetcher forgets about @app, so the next visit
+ * refines it again.
+ */
+void
+gs_app_prefetcher_claim_app_async (GsAppPrefetcher *self,
+				   GsApp *app,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer user_data)
+{
+	GPtrArray *waiters;
+	g_autoptr(GTask) task = NULL;
+
+	g_return_if_fail (GS_IS_APP_PREFETCHER (self));
+	g_return_if_fail (GS_IS_APP (app));
+
+	task = g_task_new (self, cancellable, callback, user_data);
+	g_task_set_source_tag (task, gs_app_prefetcher_claim_app_async);
+
+	/* already done */
+	if (gs_app_prefetcher_remove_done (self, app)) {
+		g_task_return_boolean (task, TRUE);
+		return;
+	}
+
+	/* join the refine that is already running */
+	waiters = g_hash_table_lookup (self->in_flight, app);
+	if (waiters != NULL) {
+		g_ptr_array_add (waiters, g_steal_pointer (&task));
+		return;
+	}
+
+	/* not started yet, so the caller does it now */
+	if (g_queue_remove (self->pending, app))
+		g_object_unref (app);
+	g_task_return_boolean (task, FALSE);
+}
+
+/**
+ * gs_app_prefetcher_claim_app_finish:
+ * @self: A #GsAppPrefetcher
+ * @res: A #GAsyncResult
+ * @error: A #GError, or %NULL
+ *
+ * Returns: %TRUE if the app has been refined for the details page, %FALSE
+ * if the caller has to refine it
+ */
+gboolean
+gs_app_prefetcher_claim_app_finish (GsAppPrefetcher *self,
+				    GAsyncResult *res,
+				    GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (res, self), FALSE);
+	return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+/**
+ * gs_app_prefetcher_cancel:
+ * @self: A #GsAppPrefetcher
+ *
+ * Drops the queued prefetches and cancels the ones in flight, for instance
+ * when the metadata has changed.
+ */
+void
+gs_app_prefetcher_cancel (GsAppPrefetcher *self)
+{
+	GHashTableIter iter;
+	gpointer value;
+	g_autoptr(GPtrArray) waiters = g_ptr_array_new_with_free_func (g_object_unref);
+
+	g_return_if_fail (GS_IS_APP_PREFETCHER (self));
+
+	g_cancellable_cancel (self->cancellable);
+	g_clear_object (&self->cancellable);
+	self->cancellable = g_cancellable_new ();
+	g_queue_free_full (self->pending, g_object_unref);
+	self->pending = g_queue_new ();
+	gs_app_prefetcher_clear_done (self);
+
+	/* anyone waiting on a cancelled prefetch refines the app itself; the
+	 * table is emptied first as the callbacks may claim apps again */
+	g_hash_table_iter_init (&iter, self->in_flight);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		GPtrArray *tasks = (GPtrArray *) value;
+		for (guint i = 0; i < tasks->len; i++)
+			g_ptr_array_add (waiters, g_object_ref (g_ptr_array_index (tasks, i)));
+	}
+	g_hash_table_remove_all (self->in_flight);
+	for (guint i = 0; i < waiters->len; i++)
+		g_task_return_boolean (g_ptr_array_index (waiters, i), FALSE);
+}
+
+static void
+gs_app_prefetcher_dispose (GObject *object)
+{
+	GsAppPrefetcher *self = GS_APP_PREFETCHER (object);
+
+	if (self->cancellable != NULL)
+		g_cancellable_cancel (self->cancellable);
+	g_clear_object (&self->cancellable);
+	g_clear_object (&self->plugin_loader);
+
+	G_OBJECT_CLASS (gs_app_prefetcher_parent_class)->dispose (object);
+}
+
+static void
+gs_app_prefetcher_finalize (GObject *object)
+{
+	GsAppPrefetcher *self = GS_APP_PREFETCHER (object);
+
+	g_queue_free_full (self->pending, g_object_unref);
+	gs_app_prefetcher_clear_done (self);
+	g_queue_free (self->done);
+	g_hash_table_unref (self->done_hash);
+	g_hash_table_unref (self->in_flight);
+
+	G_OBJECT_CLASS (gs_app_prefetcher_parent_class)->finalize (object);
+}
+
+static void
+gs_app_prefetcher_class_init (GsAppPrefetcherClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	object_class->dispose = gs_app_prefetcher_dispose;
+	object_class->finalize = gs_app_prefetcher_finalize;
+}
+
+static void
+gs_app_prefetcher_init (GsAppPrefetcher *self)
+{
+	self->cancellable = g_cancellable_new ();
+	self->pending = g_queue_new ();
+	self->in_flight = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+						 NULL, (GDestroyNotify) g_ptr_array_unref);
+	self->done = g_queue_new ();
+	self->done_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
+}
+
+GsAppPrefetcher *
+gs_app_prefetcher_new (GsPluginLoader *plugin_loader)
+{
+	GsAppPrefetcher *self;
+	self = g_object_new (GS_TYPE_APP_PREFETCHER, NULL);
+	self->plugin_loader = g_object_ref (plugin_loader);
+	return GS_APP_PREFETCHER (self);
+}
+
+/* vim: set noexpandtab: */
@@ -0,0 +1,54 @@
+/* -*- Mode: C; tab-width: 8; indent-tabs-mode: t; c-basic-offset: 8 -*-
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Licensed under the GNU General Public License Version 2
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __GS_APP_PREFETCHER_H
+#define __GS_APP_PREFETCHER_H
+
+#include <glib-object.h>
+
+#include "gnome-software-private.h"
+
+G_BEGIN_DECLS
+
+#define GS_TYPE_APP_PREFETCHER (gs_app_prefetcher_get_type ())
+
+G_DECLARE_FINAL_TYPE (GsAppPrefetcher, gs_app_prefetcher, GS, APP_PREFETCHER, GObject)
+
+GsAppPrefetcher	*gs_app_prefetcher_new		(GsPluginLoader	*plugin_loader);
+void		 gs_app_prefetcher_add_app	(GsAppPrefetcher *self,
+						 GsApp		*app);
+gboolean	 gs_app_prefetcher_has_app	(GsAppPrefetcher *self,
+						 GsApp		*app);
+void		 gs_app_prefetcher_claim_app_async (GsAppPrefetcher *self,
+						 GsApp		*app,
+						 GCancellable	*cancellable,
+						 GAsyncReadyCallback callback,
+						 gpointer	 user_data);
+gboolean	 gs_app_prefetcher_claim_app_finish (GsAppPrefetcher *self,
+						 GAsyncResult	*res,
+						 GError		**error);
+void		 gs_app_prefetcher_cancel	(GsAppPrefetcher *self);
+
+G_END_DECLS
+
+#endif /* __GS_APP_PREFETCHER_H */
+
+/* vim: set noexpandtab: */
@@ -24,7 +24,33 @@
 #include "gs-app-tile.h"
 #include "gs-common.h"
 
-G_DEFINE_ABSTRACT_TYPE (GsAppTile, gs_app_tile, GTK_TYPE_BUTTON)
+#define GS_APP_TILE_HOVER_DELAY		250	/* ms */
+#define GS_APP_TILE_VIEWPORT_DELAY	1000	/* ms */
+
+/* shared by all the tiles in one scrolled window, so that scrolling only
+ * restarts one timeout however many tiles there are */
+typedef struct
+{
+	GtkAdjustment		*vadjustment;
+	GHashTable		*tiles;		/* GsAppTile, mapped and not emitted */
+	guint			 timeout_id;
+} GsAppTileViewport;
+
+typedef struct
+{
+	GsAppTileViewport	*viewport;
+	guint			 hover_id;
+	gboolean		 prefetch_emitted;
+} GsAppTilePrivate;
+
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GsAppTile, gs_app_tile, GTK_TYPE_BUTTON)
+
+enum {
+	SIGNAL_PREFETCH,
+	SIGNAL_LAST
+};
+
+static guint signals [SIGNAL_LAST] = { 0 };
 
 GsApp *
 gs_app_tile_get_app (GsAppTile *tile)
@@ -42,6 +68,7 @@ gs_app_tile_get_app (GsAppTile *tile)
 void
 gs_app_tile_set_app (GsAppTile *tile, GsApp *app)
 {
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
 	GsAppTileClass *klass;
 
 	g_return_if_fail (GS_IS_APP_TILE (tile));
@@ -51,11 +78,250 @@ gs_app_tile_set_app (GsAppTile *tile, GsApp *app)
 	g_assert (klass->get_app);
 
 	klass->set_app(tile, app);
+	priv->prefetch_emitted = FALSE;
+}
+
+static void
+gs_app_tile_viewport_remove (GsAppTile *tile)
+{
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+
+	if (priv->viewport == NULL)
+		return;
+	g_hash_table_remove (priv->viewport->tiles, tile);
+	if (g_hash_table_size (priv->viewport->tiles) == 0 &&
+	    priv->viewport->timeout_id != 0) {
+		g_source_remove (priv->viewport->timeout_id);
+		priv->viewport->timeout_id = 0;
+	}
+	priv->viewport = NULL;
+}
+
+static void
+gs_app_tile_cancel_timeouts (GsAppTile *tile)
+{
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+
+	if (priv->hover_id != 0) {
+		g_source_remove (priv->hover_id);
+		priv->hover_id = 0;
+	}
+	gs_app_tile_viewport_remove (tile);
+}
+
+/* the user is likely to look at the details of this app soon */
+static void
+gs_app_tile_emit_prefetch (GsAppTile *tile)
+{
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+
+	if (priv->prefetch_emitted || gs_app_tile_get_app (tile) == NULL)
+		return;
+	priv->prefetch_emitted = TRUE;
+	gs_app_tile_cancel_timeouts (tile);
+	g_signal_emit (tile, signals[SIGNAL_PREFETCH], 0);
+}
+
+static gboolean
+gs_app_tile_hover_cb (gpointer user_data)
+{
+	GsAppTile *tile = GS_APP_TILE (user_data);
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+
+	priv->hover_id = 0;
+	gs_app_tile_emit_prefetch (tile);
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+gs_app_tile_in_viewport (GsAppTile *tile)
+{
+	GtkWidget *widget = GTK_WIDGET (tile);
+	GtkWidget *scrolled;
+	GtkAllocation alloc;
+	gint x, y;
+
+	scrolled = gtk_widget_get_ancestor (widget, GTK_TYPE_SCROLLED_WINDOW);
+	if (scrolled == NULL)
+		return TRUE;
+	if (!gtk_widget_translate_coordinates (widget, scrolled, 0, 0, &x, &y))
+		return FALSE;
+	gtk_widget_get_allocation (widget, &alloc);
+	return y + alloc.height > 0 &&
+	       y < gtk_widget_get_allocated_height (scrolled) &&
+	       x + alloc.width > 0 &&
+	       x < gtk_widget_get_allocated_width (scrolled);
+}
+
+static gboolean
+gs_app_tile_viewport_cb (gpointer user_data)
+{
+	GsAppTileViewport *viewport = (GsAppTileViewport *) user_data;
+	g_autoptr(GList) tiles = NULL;
+
+	viewport->timeout_id = 0;
+
+	/* emitting removes the tile from the viewport */
+	tiles = g_hash_table_get_keys (viewport->tiles);
+	for (GList *l = tiles; l != NULL; l = l->next) {
+		GsAppTile *tile = GS_APP_TILE (l->data);
+		if (gs_app_tile_in_viewport (tile))
+			gs_app_tile_emit_prefetch (tile);
+	}
+	return G_SOURCE_REMOVE;
+}
+
+/* wait until the tiles have stayed on screen for a while */
+static void
+gs_app_tile_viewport_queue_check (GsAppTileViewport *viewport)
+{
+	if (g_hash_table_size (viewport->tiles) == 0)
+		return;
+	if (viewport->timeout_id != 0)
+		g_source_remove (viewport->timeout_id);
+	viewport->timeout_id = g_timeout_add_full (G_PRIORITY_LOW,
+						   GS_APP_TILE_VIEWPORT_DELAY,
+						   gs_app_tile_viewport_cb,
+						   viewport, NULL);
+}
+
+static void
+gs_app_tile_viewport_free (GsAppTileViewport *viewport)
+{
+	GHashTableIter iter;
+	gpointer key;
+
+	/* the tiles are normally unmapped first */
+	g_hash_table_iter_init (&iter, viewport->tiles);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		GsAppTilePrivate *priv = gs_app_tile_get_instance_private (GS_APP_TILE (key));
+		priv->viewport = NULL;
+	}
+	if (viewport->timeout_id != 0)
+		g_source_remove (viewport->timeout_id);
+	if (viewport->vadjustment != NULL) {
+		g_signal_handlers_disconnect_by_func (viewport->vadjustment,
+						      gs_app_tile_viewport_queue_check,
+						      viewport);
+		g_object_unref (viewport->vadjustment);
+	}
+	g_hash_table_unref (viewport->tiles);
+	g_slice_free (GsAppTileViewport, viewport);
+}
+
+static GsAppTileViewport *
+gs_app_tile_viewport_get (GtkWidget *scrolled)
+{
+	GsAppTileViewport *viewport;
+
+	viewport = g_object_get_data (G_OBJECT (scrolled), "GnomeSoftware::TileViewport");
+	if (viewport != NULL)
+		return viewport;
+	viewport = g_slice_new0 (GsAppTileViewport);
+	viewport->tiles = g_hash_table_new (g_direct_hash, g_direct_equal);
+	viewport->vadjustment = g_object_ref (gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (scrolled)));
+	g_signal_connect_swapped (viewport->vadjustment, "value-changed",
+				  G_CALLBACK (gs_app_tile_viewport_queue_check),
+				  viewport);
+	g_object_set_data_full (G_OBJECT (scrolled), "GnomeSoftware::TileViewport",
+				viewport, (GDestroyNotify) gs_app_tile_viewport_free);
+	return viewport;
+}
+
+static gboolean
+gs_app_tile_enter_notify_event (GtkWidget *widget, GdkEventCrossing *event)
+{
+	GsAppTile *tile = GS_APP_TILE (widget);
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+
+	if (!priv->prefetch_emitted && priv->hover_id == 0) {
+		priv->hover_id = g_timeout_add (GS_APP_TILE_HOVER_DELAY,
+						gs_app_tile_hover_cb, tile);
+	}
+	return GTK_WIDGET_CLASS (gs_app_tile_parent_class)->enter_notify_event (widget, event);
+}
+
+static gboolean
+gs_app_tile_leave_notify_event (GtkWidget *widget, GdkEventCrossing *event)
+{
+	GsAppTile *tile = GS_APP_TILE (widget);
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+
+	if (priv->hover_id != 0) {
+		g_source_remove (priv->hover_id);
+		priv->hover_id = 0;
+	}
+	return GTK_WIDGET_CLASS (gs_app_tile_parent_class)->leave_notify_event (widget, event);
+}
+
+static void
+gs_app_tile_map (GtkWidget *widget)
+{
+	GsAppTile *tile = GS_APP_TILE (widget);
+	GsAppTilePrivate *priv = gs_app_tile_get_instance_private (tile);
+	GtkWidget *scrolled;
+
+	GTK_WIDGET_CLASS (gs_app_tile_parent_class)->map (widget);
+
+	if (priv->prefetch_emitted)
+		return;
+
+	/* always on screen */
+	scrolled = gtk_widget_get_ancestor (widget, GTK_TYPE_SCROLLED_WINDOW);
+	if (scrolled == NULL) {
+		if (priv->hover_id == 0) {
+			priv->hover_id = g_timeout_add (GS_APP_TILE_VIEWPORT_DELAY,
+							gs_app_tile_hover_cb, tile);
+		}
+		return;
+	}
+
+	/* check again whenever the tile may have scrolled into view */
+	gs_app_tile_viewport_remove (tile);
+	priv->viewport = gs_app_tile_viewport_get (scrolled);
+	g_hash_table_add (priv->viewport->tiles, tile);
+	gs_app_tile_viewport_queue_check (priv->viewport);
+}
+
+static void
+gs_app_tile_unmap (GtkWidget *widget)
+{
+	GsAppTile *tile = GS_APP_TILE (widget);
+
+	gs_app_tile_cancel_timeouts (tile);
+
+	GTK_WIDGET_CLASS (gs_app_tile_parent_class)->unmap (widget);
+}
+
+static void
+gs_app_tile_dispose (GObject *object)
+{
+	GsAppTile *tile = GS_APP_TILE (object);
+
+	gs_app_tile_cancel_timeouts (tile);
+
+	G_OBJECT_CLASS (gs_app_tile_parent_class)->dispose (object);
 }
 
 void
 gs_app_tile_class_init (GsAppTileClass *klass)
-{}
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+	GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+	object_class->dispose = gs_app_tile_dispose;
+	widget_class->enter_notify_event = gs_app_tile_enter_notify_event;
+	widget_class->leave_notify_event = gs_app_tile_leave_notify_event;
+	widget_class->map = gs_app_tile_map;
+	widget_class->unmap = gs_app_tile_unmap;
+
+	signals [SIGNAL_PREFETCH] =
+		g_signal_new ("prefetch",
+			      G_TYPE_FROM_CLASS (object_class), G_SIGNAL_RUN_LAST,
+			      G_STRUCT_OFFSET (GsAppTileClass, prefetch),
+			      NULL, NULL, g_cclosure_marshal_VOID__VOID,
+			      G_TYPE_NONE, 0);
+}
 
 void
 gs_app_tile_init (GsAppTile *tile)
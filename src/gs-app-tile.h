@@ -39,6 +39,7 @@ struct _GsAppTileClass
 	void			(*set_app)		(GsAppTile	*tile,
 							 GsApp		*app);
         GsApp			*(*get_app)		(GsAppTile	*tile);
+	void			(*prefetch)		(GsAppTile	*tile);
 };
 
 GtkWidget	*gs_app_tile_new	(GsApp *app);
@@ -25,8 +25,11 @@
 
 #include "gs-application.h"
 
+#include <signal.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <glib/gi18n.h>
+#include <glib-unix.h>
 #include <gio/gio.h>
 #include <gio/gdesktopappinfo.h>
 #include <libsoup/soup.h>
@@ -46,7 +49,9 @@
 #include "gs-shell.h"
 #include "gs-update-monitor.h"
 #include "gs-shell-search-provider.h"
+#include "gs-stats-generated.h"
 #include "gs-folders.h"
+#include "gs-trace.h"
 
 #define ENABLE_REPOS_DIALOG_CONF_KEY "enable-repos-dialog"
 
@@ -62,9 +67,11 @@ struct _GsApplication {
 	GsDbusHelper	*dbus_helper;
 #endif
 	GsShellSearchProvider *search_provider;
+	GsSoftwareStats	*stats;
 	GSettings       *settings;
 	GSimpleActionGroup	*action_map;
 	guint		 shell_loaded_handler_id;
+	guint		 trace_signal_id;
 };
 
 G_DEFINE_TYPE (GsApplication, gs_application, GTK_TYPE_APPLICATION);
@@ -191,6 +198,106 @@ gs_application_initialize_plugins (GsApplication *app)
 
 }
 
+static gboolean
+gs_application_handle_get_plugin_stats_cb (GsSoftwareStats *stats,
+					   GDBusMethodInvocation *invocation,
+					   GsApplication *app)
+{
+	if (app->plugin_loader == NULL) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+							       G_DBUS_ERROR,
+							       G_DBUS_ERROR_FAILED,
+							       "Plugins not loaded");
+		return TRUE;
+	}
+	gs_software_stats_complete_get_plugin_stats (stats, invocation,
+						     gs_plugin_loader_get_stats (app->plugin_loader));
+	return TRUE;
+}
+
+static gboolean
+gs_application_handle_get_memory_stats_cb (GsSoftwareStats *stats,
+					   GDBusMethodInvocation *invocation,
+					   GsApplication *app)
+{
+	if (app->plugin_loader == NULL) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+							       G_DBUS_ERROR,
+							       G_DBUS_ERROR_FAILED,
+							       "Plugins not loaded");
+		return TRUE;
+	}
+	gs_software_stats_complete_get_memory_stats (stats, invocation,
+						     gs_plugin_loader_get_memory_stats (app->plugin_loader));
+	return TRUE;
+}
+
+static gboolean
+gs_application_handle_get_governor_stats_cb (GsSoftwareStats *stats,
+					     GDBusMethodInvocation *invocation,
+					     GsApplication *app)
+{
+	if (app->plugin_loader == NULL) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+							       G_DBUS_ERROR,
+							       G_DBUS_ERROR_FAILED,
+							       "Plugins not loaded");
+		return TRUE;
+	}
+	gs_software_stats_complete_get_governor_stats (stats, invocation,
+						       gs_plugin_loader_get_governor_stats (app->plugin_loader));
+	return TRUE;
+}
+
+static gboolean
+gs_application_handle_get_search_stats_cb (GsSoftwareStats *stats,
+					   GDBusMethodInvocation *invocation,
+					   GsApplication *app)
+{
+	if (app->shell == NULL) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+							       G_DBUS_ERROR,
+							       G_DBUS_ERROR_FAILED,
+							       "Window not created");
+		return TRUE;
+	}
+	gs_software_stats_complete_get_search_stats (stats, invocation,
+						     gs_shell_get_search_stats (app->shell));
+	return TRUE;
+}
+
+static gboolean
+gs_application_handle_get_trace_cb (GsSoftwareStats *stats,
+				    GDBusMethodInvocation *invocation,
+				    GsApplication *app)
+{
+	g_autofree gchar *json = gs_trace_to_json ();
+	gs_software_stats_complete_get_trace (stats, invocation, json);
+	return TRUE;
+}
+
+/* kill -USR1 is easier than D-Bus when debugging a stuck install */
+static gboolean
+gs_application_trace_signal_cb (gpointer user_data)
+{
+	g_autofree gchar *basename = g_strdup_printf ("trace-%i.json", getpid ());
+	g_autofree gchar *dirname = g_build_filename (g_get_user_cache_dir (),
+						      "gnome-software", NULL);
+	g_autofree gchar *filename = g_build_filename (dirname, basename, NULL);
+	g_autoptr(GError) error = NULL;
+
+	if (g_mkdir_with_parents (dirname, 0700) != 0) {
+		g_warning ("failed to create %s", dirname);
+		return G_SOURCE_CONTINUE;
+	}
+	if (!gs_trace_save (filename, &error)) {
+		g_warning ("failed to save trace: %s", error->message);
+		return G_SOURCE_CONTINUE;
+	}
+	g_message ("saved trace to %s", filename);
+	return G_SOURCE_CONTINUE;
+}
+
 static gboolean
 gs_application_dbus_register (GApplication    *application,
                               GDBusConnection *connection,
@@ -199,7 +306,23 @@ gs_application_dbus_register (GApplication    *application,
 {
 	GsApplication *app = GS_APPLICATION (application);
 	app->search_provider = gs_shell_search_provider_new ();
-	return gs_shell_search_provider_register (app->search_provider, connection, error);
+	if (!gs_shell_search_provider_register (app->search_provider, connection, error))
+		return FALSE;
+
+	/* so the latencies of the running instance can be looked at */
+	app->stats = gs_software_stats_skeleton_new ();
+	g_signal_connect (app->stats, "handle-get-plugin-stats",
+			  G_CALLBACK (gs_application_handle_get_plugin_stats_cb), app);
+	g_signal_connect (app->stats, "handle-get-memory-stats",
+			  G_CALLBACK (gs_application_handle_get_memory_stats_cb), app);
+	g_signal_connect (app->stats, "handle-get-governor-stats",
+			  G_CALLBACK (gs_application_handle_get_governor_stats_cb), app);
+	g_signal_connect (app->stats, "handle-get-search-stats",
+			  G_CALLBACK (gs_application_handle_get_search_stats_cb), app);
+	g_signal_connect (app->stats, "handle-get-trace",
+			  G_CALLBACK (gs_application_handle_get_trace_cb), app);
+	return g_dbus_interface_skeleton_export (G_DBUS_INTERFACE_SKELETON (app->stats),
+						 connection, object_path, error);
 }
 
 static void
@@ -213,6 +336,10 @@ gs_application_dbus_unregister (GApplication    *application,
 		gs_shell_search_provider_unregister (app->search_provider);
 		g_clear_object (&app->search_provider);
 	}
+	if (app->stats != NULL) {
+		g_dbus_interface_skeleton_unexport (G_DBUS_INTERFACE_SKELETON (app->stats));
+		g_clear_object (&app->stats);
+	}
 }
 
 static void
@@ -920,6 +1047,9 @@ gs_application_startup (GApplication *application)
 					 application);
 
 	gs_application_setup_search_provider (GS_APPLICATION (application));
+	app->trace_signal_id = g_unix_signal_add (SIGUSR1,
+						  gs_application_trace_signal_cb,
+						  app);
 
 #ifdef HAVE_PACKAGEKIT
 	GS_APPLICATION (application)->dbus_helper = gs_dbus_helper_new ();
@@ -952,6 +1082,18 @@ gs_application_activate (GApplication *application)
 	gs_application_show_first_run_dialog (GS_APPLICATION (application));
 }
 
+static void
+gs_application_shutdown (GApplication *application)
+{
+	GsApplication *app = GS_APPLICATION (application);
+
+	/* show the overview as it is now on the next start */
+	if (app->shell != NULL)
+		gs_shell_save_snapshot (app->shell);
+
+	G_APPLICATION_CLASS (gs_application_parent_class)->shutdown (application);
+}
+
 static void
 gs_application_dispose (GObject *object)
 {
@@ -960,6 +1102,10 @@ gs_application_dispose (GObject *object)
 	g_cancellable_cancel (app->cancellable);
 	g_clear_object (&app->cancellable);
 
+	if (app->trace_signal_id != 0) {
+		g_source_remove (app->trace_signal_id);
+		app->trace_signal_id = 0;
+	}
 	g_clear_object (&app->plugin_loader);
 	g_clear_object (&app->shell);
 	g_clear_object (&app->provider);
@@ -1098,6 +1244,7 @@ gs_application_class_init (GsApplicationClass *class)
 {
 	G_OBJECT_CLASS (class)->dispose = gs_application_dispose;
 	G_APPLICATION_CLASS (class)->startup = gs_application_startup;
+	G_APPLICATION_CLASS (class)->shutdown = gs_application_shutdown;
 	G_APPLICATION_CLASS (class)->activate = gs_application_activate;
 	G_APPLICATION_CLASS (class)->handle_local_options = gs_application_handle_local_options;
 	G_APPLICATION_CLASS (class)->open = gs_application_open;
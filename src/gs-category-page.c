@@ -37,6 +37,9 @@ typedef enum {
 	SUBCATEGORY_SORT_TYPE_NAME
 } SubcategorySortType;
 
+/* enough to fill the first screen, the rest is loaded on scrolling */
+#define GS_CATEGORY_PAGE_PAGE_SIZE	30
+
 struct _GsCategoryPage
 {
 	GsPage		 parent_instance;
@@ -50,6 +53,9 @@ struct _GsCategoryPage
 	guint		sort_rating_handler_id;
 	guint		sort_name_handler_id;
 	SubcategorySortType sort_type;
+	guint		 offset;
+	gboolean	 has_more;
+	gboolean	 loading_more;
 
 	GtkWidget	*infobar_category_shell_extensions;
 	GtkWidget	*button_category_shell_extensions;
@@ -71,6 +77,9 @@ struct _GsCategoryPage
 
 G_DEFINE_TYPE (GsCategoryPage, gs_category_page, GS_TYPE_PAGE)
 
+static void gs_category_page_reload (GsPage *page);
+static void gs_category_page_load_more (GsCategoryPage *self);
+
 static void
 gs_category_page_switch_to (GsPage *page, gboolean scroll_up)
 {
@@ -92,6 +101,13 @@ app_tile_clicked (GsAppTile *tile, gpointer data)
 	gs_shell_show_app (self->shell, app);
 }
 
+static void
+app_tile_prefetch (GsAppTile *tile, gpointer data)
+{
+	GsCategoryPage *self = GS_CATEGORY_PAGE (data);
+	gs_shell_prefetch_app (self->shell, gs_app_tile_get_app (tile));
+}
+
 static void
 gs_category_page_sort_by_type (GsCategoryPage *self,
 			       SubcategorySortType sort_type)
@@ -110,6 +126,12 @@ gs_category_page_sort_by_type (GsCategoryPage *self,
 		return;
 
 	self->sort_type = sort_type;
+
+	/* the pages already shown are not the start of the new order */
+	if (self->has_more) {
+		gs_category_page_reload (GS_PAGE (self));
+		return;
+	}
 	gtk_flow_box_invalidate_sort (GTK_FLOW_BOX (self->category_detail_box));
 }
 
@@ -146,18 +168,32 @@ gs_category_page_get_apps_cb (GObject *source_object,
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GsAppList) list = NULL;
 
-	/* show an empty space for no results */
-	gs_container_remove_all (GTK_CONTAINER (self->category_detail_box));
-
 	list = gs_plugin_loader_job_process_finish (plugin_loader,
 						    res,
 						    &error);
 	if (list == NULL) {
-		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			g_warning ("failed to get apps for category apps: %s", error->message);
+		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
+			return;
+		g_warning ("failed to get apps for category apps: %s", error->message);
+	}
+
+	/* show an empty space for no results */
+	if (self->offset == 0)
+		gs_container_remove_all (GTK_CONTAINER (self->category_detail_box));
+	self->loading_more = FALSE;
+	if (list == NULL) {
+		self->has_more = FALSE;
 		return;
 	}
 
+	/* the loader truncates the list when there are more to come */
+	self->offset += GS_CATEGORY_PAGE_PAGE_SIZE;
+	self->has_more = gs_app_list_has_flag (list, GS_APP_LIST_FLAG_IS_TRUNCATED);
+	g_debug ("got %u apps for %s, %s",
+		 gs_app_list_length (list),
+		 gs_category_get_id (self->subcategory),
+		 self->has_more ? "more to come" : "no more");
+
 	for (i = 0; i < gs_app_list_length (list); i++) {
 		app = gs_app_list_index (list, i);
 		if (g_strcmp0 (gs_category_get_id (self->category), "addons") == 0) {
@@ -168,10 +204,17 @@ gs_category_page_get_apps_cb (GObject *source_object,
 
 		g_signal_connect (tile, "clicked",
 				  G_CALLBACK (app_tile_clicked), self);
+		g_signal_connect (tile, "prefetch",
+				  G_CALLBACK (app_tile_prefetch), self);
 		gtk_container_add (GTK_CONTAINER (self->category_detail_box), tile);
 		gtk_widget_set_can_focus (gtk_widget_get_parent (tile), FALSE);
 	}
 
+	/* the first page may not fill the window */
+	gs_category_page_load_more (self);
+
+	if (self->sort_rating_handler_id > 0)
+		return;
 	self->sort_rating_handler_id = g_signal_connect (self->sort_rating_button,
 							 "clicked",
 							 G_CALLBACK (sort_button_clicked),
@@ -182,10 +225,28 @@ gs_category_page_get_apps_cb (GObject *source_object,
 						       self);
 }
 
-static gboolean
-_max_results_sort_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+/* the order must be complete so that the same app is never on two pages */
+static gint
+gs_category_page_sort_name_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	gint rc = g_strcmp0 (gs_app_get_name_sort_key (app1),
+			     gs_app_get_name_sort_key (app2));
+	if (rc != 0)
+		return rc;
+	return g_strcmp0 (gs_app_get_unique_id (app1),
+			  gs_app_get_unique_id (app2));
+}
+
+static gint
+gs_category_page_sort_rating_cb (GsApp *app1, GsApp *app2, gpointer user_data)
 {
-	return gs_app_get_rating (app1) < gs_app_get_rating (app2);
+	gint rating_app1 = gs_app_get_rating (app1);
+	gint rating_app2 = gs_app_get_rating (app2);
+	if (rating_app1 > rating_app2)
+		return -1;
+	if (rating_app1 < rating_app2)
+		return 1;
+	return gs_category_page_sort_name_cb (app1, app2, user_data);
 }
 
 static gint
@@ -196,28 +257,15 @@ gs_category_page_sort_flow_box_sort_func (GtkFlowBoxChild *child1,
 	GsApp *app1 = gs_app_tile_get_app (GS_APP_TILE (gtk_bin_get_child (GTK_BIN (child1))));
 	GsApp *app2 = gs_app_tile_get_app (GS_APP_TILE (gtk_bin_get_child (GTK_BIN (child2))));
 	SubcategorySortType sort_type;
-	g_autofree gchar *casefolded_name1 = NULL;
-	g_autofree gchar *casefolded_name2 = NULL;
 
 	if (!GS_IS_APP (app1) || !GS_IS_APP (app2))
 		return 0;
 
 	sort_type = GS_CATEGORY_PAGE (data)->sort_type;
 
-	if (sort_type == SUBCATEGORY_SORT_TYPE_RATING) {
-		gint rating_app1 = gs_app_get_rating (app1);
-		gint rating_app2 = gs_app_get_rating (app2);
-		if (rating_app1 > rating_app2)
-			return -1;
-		if (rating_app1 < rating_app2)
-			return 1;
-	}
-
-	if (gs_app_get_name (app1) != NULL)
-		casefolded_name1 = g_utf8_casefold (gs_app_get_name (app1), -1);
-	if (gs_app_get_name (app2) != NULL)
-		casefolded_name2 = g_utf8_casefold (gs_app_get_name (app2), -1);
-	return g_strcmp0 (casefolded_name1, casefolded_name2);
+	if (sort_type == SUBCATEGORY_SORT_TYPE_RATING)
+		return gs_category_page_sort_rating_cb (app1, app2, NULL);
+	return gs_category_page_sort_name_cb (app1, app2, NULL);
 }
 
 static void
@@ -228,6 +276,8 @@ gs_category_page_set_featured_placeholders (GsCategoryPage *self)
 		GtkWidget *tile = gs_summary_tile_new (NULL);
 		g_signal_connect (tile, "clicked",
 				  G_CALLBACK (app_tile_clicked), self);
+		g_signal_connect (tile, "prefetch",
+				  G_CALLBACK (app_tile_prefetch), self);
 		gtk_grid_attach (GTK_GRID (self->featured_grid), tile, i, 0, 1, 1);
 		gtk_widget_set_can_focus (gtk_widget_get_parent (tile), FALSE);
 	}
@@ -272,6 +322,8 @@ gs_category_page_get_featured_apps_cb (GObject *source_object,
 		tile = gs_summary_tile_new (app);
 		g_signal_connect (tile, "clicked",
 				  G_CALLBACK (app_tile_clicked), self);
+		g_signal_connect (tile, "prefetch",
+				  G_CALLBACK (app_tile_prefetch), self);
 		gtk_grid_attach (GTK_GRID (self->featured_grid), tile, i, 0, 1, 1);
 		gtk_widget_set_can_focus (gtk_widget_get_parent (tile), FALSE);
 	}
@@ -313,13 +365,61 @@ gs_category_page_set_featured_apps (GsCategoryPage *self)
 					    self);
 }
 
+/* only the apps on this page get their icons refined */
+static void
+gs_category_page_load_page (GsCategoryPage *self)
+{
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	self->loading_more = TRUE;
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_CATEGORY_APPS,
+					 "category", self->subcategory,
+					 "filter-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
+					 "dedupe-flags", GS_APP_LIST_FILTER_FLAG_PREFER_INSTALLED |
+							 GS_APP_LIST_FILTER_FLAG_KEY_ID_PROVIDES,
+					 "offset", self->offset,
+					 "max-results", GS_CATEGORY_PAGE_PAGE_SIZE,
+					 NULL);
+	if (self->sort_type == SUBCATEGORY_SORT_TYPE_NAME)
+		gs_plugin_job_set_sort_func (plugin_job, gs_category_page_sort_name_cb);
+	else
+		gs_plugin_job_set_sort_func (plugin_job, gs_category_page_sort_rating_cb);
+	gs_plugin_loader_job_process_async (self->plugin_loader,
+					    plugin_job,
+					    self->cancellable,
+					    gs_category_page_get_apps_cb,
+					    self);
+}
+
+/* fetch the next page when the user gets within a screen of the end */
+static void
+gs_category_page_load_more (GsCategoryPage *self)
+{
+	GtkAdjustment *adj;
+
+	if (!self->has_more || self->loading_more)
+		return;
+	adj = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (self->scrolledwindow_category));
+	if (gtk_adjustment_get_value (adj) + 2 * gtk_adjustment_get_page_size (adj) <
+	    gtk_adjustment_get_upper (adj))
+		return;
+	gs_category_page_load_page (self);
+}
+
+static void
+gs_category_page_adjustment_changed_cb (GtkAdjustment *adj, GsCategoryPage *self)
+{
+	gs_category_page_load_more (self);
+}
+
 static void
 gs_category_page_reload (GsPage *page)
 {
 	GsCategoryPage *self = GS_CATEGORY_PAGE (page);
 	GtkWidget *tile;
 	guint i, count;
-	g_autoptr(GsPluginJob) plugin_job = NULL;
 
 	if (self->subcategory == NULL)
 		return;
@@ -377,20 +477,9 @@ gs_category_page_reload (GsPage *page)
 
 	gs_category_page_set_featured_apps (self);
 
-	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_CATEGORY_APPS,
-					 "category", self->subcategory,
-					 "filter-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
-					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING,
-					 "dedupe-flags", GS_APP_LIST_FILTER_FLAG_PREFER_INSTALLED |
-							 GS_APP_LIST_FILTER_FLAG_KEY_ID_PROVIDES,
-					 NULL);
-	gs_plugin_job_set_sort_func (plugin_job, _max_results_sort_cb);
-	gs_plugin_loader_job_process_async (self->plugin_loader,
-					    plugin_job,
-					    self->cancellable,
-					    gs_category_page_get_apps_cb,
-					    self);
+	self->offset = 0;
+	self->has_more = FALSE;
+	gs_category_page_load_page (self);
 }
 
 static void
@@ -584,6 +673,12 @@ gs_category_page_setup (GsPage *page,
 
 	adj = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (self->scrolledwindow_category));
 	gtk_container_set_focus_vadjustment (GTK_CONTAINER (self->category_detail_box), adj);
+	g_signal_connect_object (adj, "value-changed",
+				 G_CALLBACK (gs_category_page_adjustment_changed_cb),
+				 self, 0);
+	g_signal_connect_object (adj, "changed",
+				 G_CALLBACK (gs_category_page_adjustment_changed_cb),
+				 self, 0);
 
 	g_signal_connect (self->button_category_shell_extensions, "clicked",
 			  G_CALLBACK (button_shell_extensions_cb), self);
@@ -23,6 +23,7 @@
 #include "config.h"
 
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 #include <gio/gdesktopappinfo.h>
 
 #include "gs-common.h"
@@ -606,4 +607,234 @@ gs_utils_list_has_app_fuzzy (GsAppList *list, GsApp *app)
 	return FALSE;
 }
 
+static gchar *
+gs_utils_fuzzy_index_key (gchar prefix, const gchar *value)
+{
+	/* keep NULL distinct from the empty string */
+	if (value == NULL)
+		return g_strdup_printf ("%c", prefix);
+	return g_strdup_printf ("%c:%s", prefix, value);
+}
+
+static void
+gs_utils_fuzzy_index_add (GHashTable *fuzzy_index, gchar *key, const gchar *hostname)
+{
+	GHashTable *hostnames = g_hash_table_lookup (fuzzy_index, key);
+	if (hostnames == NULL) {
+		hostnames = g_hash_table_new_full (g_str_hash, g_str_equal,
+						   g_free, NULL);
+		g_hash_table_insert (fuzzy_index, key, hostnames);
+	} else {
+		g_free (key);
+	}
+	g_hash_table_add (hostnames, g_strdup (hostname != NULL ? hostname : ""));
+}
+
+/**
+ * gs_utils_list_fuzzy_index_new:
+ * @list: A #GsAppList
+ *
+ * Builds an index of the applications in the list that can be used with
+ * gs_utils_fuzzy_index_has_app() to find out if an application should show
+ * its source, without scanning the whole list for each application.
+ *
+ * The index is a snapshot and does not follow changes to @list.
+ *
+ * Returns: (transfer full): an index
+ */
+GHashTable *
+gs_utils_list_fuzzy_index_new (GsAppList *list)
+{
+	GHashTable *fuzzy_index;
+
+	/* key is the ID or name, value is a set of origin hostnames */
+	fuzzy_index = g_hash_table_new_full (g_str_hash, g_str_equal,
+				       g_free, (GDestroyNotify) g_hash_table_unref);
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		const gchar *hostname = gs_app_get_origin_hostname (app);
+		gs_utils_fuzzy_index_add (fuzzy_index,
+					  gs_utils_fuzzy_index_key ('i', gs_app_get_id (app)),
+					  hostname);
+		gs_utils_fuzzy_index_add (fuzzy_index,
+					  gs_utils_fuzzy_index_key ('n', gs_app_get_name (app)),
+					  hostname);
+	}
+	return fuzzy_index;
+}
+
+static gboolean
+gs_utils_fuzzy_index_lookup (GHashTable *fuzzy_index, gchar *key, const gchar *hostname)
+{
+	g_autofree gchar *key_tmp = key;
+	GHashTable *hostnames = g_hash_table_lookup (fuzzy_index, key_tmp);
+
+	if (hostnames == NULL)
+		return FALSE;
+
+	/* anything from a different source */
+	if (g_hash_table_size (hostnames) > 1)
+		return TRUE;
+	return !g_hash_table_contains (hostnames, hostname != NULL ? hostname : "");
+}
+
+/**
+ * gs_utils_fuzzy_index_has_app:
+ * @fuzzy_index: An index from gs_utils_list_fuzzy_index_new()
+ * @app: A #GsApp
+ *
+ * Finds out if any application in the index would match a given application,
+ * with the same rules as gs_utils_list_has_app_fuzzy().
+ *
+ * Returns: %TRUE if the app is visually the "same"
+ */
+gboolean
+gs_utils_fuzzy_index_has_app (GHashTable *fuzzy_index, GsApp *app)
+{
+	const gchar *hostname = gs_app_get_origin_hostname (app);
+
+	if (gs_utils_fuzzy_index_lookup (fuzzy_index,
+					 gs_utils_fuzzy_index_key ('i', gs_app_get_id (app)),
+					 hostname))
+		return TRUE;
+	return gs_utils_fuzzy_index_lookup (fuzzy_index,
+					    gs_utils_fuzzy_index_key ('n', gs_app_get_name (app)),
+					    hostname);
+}
+
+static gchar *
+gs_utils_save_pixbuf_to_cache (GdkPixbuf *pixbuf, const gchar *kind, GError **error)
+{
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *filename = NULL;
+
+	checksum = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+						gdk_pixbuf_read_pixels (pixbuf),
+						gdk_pixbuf_get_byte_length (pixbuf));
+	basename = g_strdup_printf ("%s-%ix%i.png", checksum,
+				    gdk_pixbuf_get_width (pixbuf),
+				    gdk_pixbuf_get_height (pixbuf));
+	filename = gs_utils_get_cache_filename (kind,
+						basename,
+						GS_UTILS_CACHE_FLAG_WRITEABLE,
+						error);
+	if (filename == NULL)
+		return NULL;
+
+	/* keep icons that are still used from being pruned */
+	if (g_file_test (filename, G_FILE_TEST_EXISTS)) {
+		if (g_utime (filename, NULL) != 0)
+			g_debug ("failed to update the time of %s", filename);
+		return g_steal_pointer (&filename);
+	}
+	if (!gdk_pixbuf_save (pixbuf, filename, "png", error, NULL))
+		return NULL;
+	return g_steal_pointer (&filename);
+}
+
+/**
+ * gs_utils_get_app_icon_ref:
+ * @app: A #GsApp
+ * @kind: A cache kind, e.g. "search-provider"
+ *
+ * Gets an icon for the application that refers to the image rather than
+ * containing it, so it is cheap to serialize. Themed icons and icons already
+ * on disk are used as-is, and icons only loaded into memory are saved into
+ * the @kind cache directory first.
+ *
+ * If the icon cannot be saved the pixbuf itself is returned.
+ *
+ * Returns: (transfer full): a #GIcon, or %NULL if the application has no icon
+ */
+GIcon *
+gs_utils_get_app_icon_ref (GsApp *app, const gchar *kind)
+{
+	GPtrArray *icons = gs_app_get_icons (app);
+	GdkPixbuf *pixbuf;
+	g_autoptr(GFile) file = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* themed icon, or one already on disk */
+	for (guint i = 0; i < icons->len; i++) {
+		AsIcon *ic = g_ptr_array_index (icons, i);
+		switch (as_icon_get_kind (ic)) {
+		case AS_ICON_KIND_STOCK:
+			if (as_icon_get_name (ic) != NULL)
+				return g_themed_icon_new (as_icon_get_name (ic));
+			break;
+		case AS_ICON_KIND_LOCAL:
+		case AS_ICON_KIND_CACHED:
+			if (as_icon_get_filename (ic) != NULL &&
+			    g_file_test (as_icon_get_filename (ic), G_FILE_TEST_EXISTS)) {
+				file = g_file_new_for_path (as_icon_get_filename (ic));
+				return g_file_icon_new (file);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	/* only loaded into memory */
+	pixbuf = gs_app_get_pixbuf (app);
+	if (pixbuf == NULL)
+		return NULL;
+	filename = gs_utils_save_pixbuf_to_cache (pixbuf, kind, &error);
+	if (filename == NULL) {
+		g_warning ("failed to save icon for %s: %s",
+			   gs_app_get_unique_id (app), error->message);
+		return G_ICON (g_object_ref (pixbuf));
+	}
+	file = g_file_new_for_path (filename);
+	return g_file_icon_new (file);
+}
+
+/**
+ * gs_utils_prune_icon_cache:
+ * @kind: A cache kind, e.g. "search-provider"
+ * @age_max: The age in seconds
+ *
+ * Deletes the icons gs_utils_get_app_icon_ref() saved into the @kind cache
+ * directory that have not been used for @age_max seconds, as every icon
+ * that has ever been shown would otherwise be kept forever.
+ */
+void
+gs_utils_prune_icon_cache (const gchar *kind, guint age_max)
+{
+	const gchar *basename;
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GError) error = NULL;
+
+	filename = gs_utils_get_cache_filename (kind,
+						"icon.png",
+						GS_UTILS_CACHE_FLAG_WRITEABLE,
+						&error);
+	if (filename == NULL) {
+		g_warning ("failed to get the %s cache: %s", kind, error->message);
+		return;
+	}
+	cachedir = g_path_get_dirname (filename);
+	dir = g_dir_open (cachedir, 0, NULL);
+	if (dir == NULL)
+		return;
+	while ((basename = g_dir_read_name (dir)) != NULL) {
+		g_autofree gchar *fn = NULL;
+		g_autoptr(GFile) file = NULL;
+
+		if (!g_str_has_suffix (basename, ".png"))
+			continue;
+		fn = g_build_filename (cachedir, basename, NULL);
+		file = g_file_new_for_path (fn);
+		if (gs_utils_get_file_age (file) < age_max)
+			continue;
+		g_debug ("deleting unused icon %s", fn);
+		if (g_unlink (fn) != 0)
+			g_warning ("failed to delete %s", fn);
+	}
+}
+
 /* vim: set noexpandtab: */
@@ -58,6 +58,13 @@ gchar		*gs_utils_build_unique_id_kind	(AsAppKind	 kind,
 						 const gchar	*id);
 gboolean	 gs_utils_list_has_app_fuzzy	(GsAppList	*list,
 						 GsApp		*app);
+GHashTable	*gs_utils_list_fuzzy_index_new	(GsAppList	*list);
+gboolean	 gs_utils_fuzzy_index_has_app	(GHashTable	*fuzzy_index,
+						 GsApp		*app);
+GIcon		*gs_utils_get_app_icon_ref	(GsApp		*app,
+						 const gchar	*kind);
+void		 gs_utils_prune_icon_cache	(const gchar	*kind,
+						 guint		 age_max);
 
 G_END_DECLS
 
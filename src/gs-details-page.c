@@ -60,6 +60,7 @@ struct _GsDetailsPage
 	GtkBuilder		*builder;
 	GCancellable		*cancellable;
 	GCancellable		*app_cancellable;
+	GCancellable		*refine_cancellable;
 	GsApp			*app;
 	GsApp			*app_local_file;
 	GsShell			*shell;
@@ -1505,24 +1506,6 @@ gs_details_page_refresh_reviews (GsDetailsPage *self)
 	}
 }
 
-static void
-gs_details_page_app_refine_cb (GObject *source,
-				GAsyncResult *res,
-				gpointer user_data)
-{
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
-	GsDetailsPage *self = GS_DETAILS_PAGE (user_data);
-	g_autoptr(GError) error = NULL;
-	if (!gs_plugin_loader_job_action_finish (plugin_loader, res, &error)) {
-		g_warning ("failed to refine %s: %s",
-			   gs_app_get_id (self->app),
-			   error->message);
-		return;
-	}
-	gs_details_page_refresh_size (self);
-	gs_details_page_refresh_reviews (self);
-}
-
 static void
 gs_details_page_content_rating_set_css (GtkWidget *widget, guint age)
 {
@@ -1627,18 +1610,156 @@ _set_app (GsDetailsPage *self, GsApp *app)
 				 self, 0);
 }
 
-/* show the UI and do operations that should not block page load */
+typedef struct {
+	GsDetailsPage	*self;
+	GCancellable	*cancellable;
+} GsDetailsPageRefineHelper;
+
+static GsDetailsPageRefineHelper *
+gs_details_page_refine_helper_new (GsDetailsPage *self)
+{
+	GsDetailsPageRefineHelper *helper = g_new0 (GsDetailsPageRefineHelper, 1);
+	helper->self = g_object_ref (self);
+	helper->cancellable = g_object_ref (self->refine_cancellable);
+	return helper;
+}
+
 static void
-gs_details_page_load_stage2 (GsDetailsPage *self)
+gs_details_page_refine_helper_free (GsDetailsPageRefineHelper *helper)
+{
+	g_object_unref (helper->self);
+	g_object_unref (helper->cancellable);
+	g_free (helper);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GsDetailsPageRefineHelper, gs_details_page_refine_helper_free);
+
+/* stops the refine stages that are still to come for the current app */
+static void
+gs_details_page_cancel_refine (GsDetailsPage *self)
+{
+	if (self->refine_cancellable == NULL)
+		return;
+	g_cancellable_cancel (self->refine_cancellable);
+	g_clear_object (&self->refine_cancellable);
+}
+
+static void
+gs_details_page_reset_refine (GsDetailsPage *self)
+{
+	gs_details_page_cancel_refine (self);
+	self->refine_cancellable = g_cancellable_new ();
+}
+
+/* the page moved on, even if the plugins did not notice the cancellation */
+static gboolean
+gs_details_page_refine_is_stale (GsDetailsPageRefineHelper *helper,
+				 const GError *error)
+{
+	if (g_cancellable_is_cancelled (helper->cancellable))
+		return TRUE;
+	return g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED);
+}
+
+static void
+gs_details_page_load_stage3_cb (GObject *source,
+				GAsyncResult *res,
+				gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
+	g_autoptr(GsDetailsPageRefineHelper) helper = (GsDetailsPageRefineHelper *) user_data;
+	GsDetailsPage *self = helper->self;
+	g_autoptr(GError) error = NULL;
+
+	if (!gs_plugin_loader_job_action_finish (plugin_loader, res, &error)) {
+		if (gs_details_page_refine_is_stale (helper, error))
+			return;
+		g_warning ("failed to refine %s: %s",
+			   gs_app_get_id (self->app),
+			   error->message);
+		return;
+	}
+	if (gs_details_page_refine_is_stale (helper, NULL))
+		return;
+	gs_details_page_refresh_addons (self);
+	gs_details_page_refresh_reviews (self);
+}
+
+/* reviews and addons, which often need the network */
+static void
+gs_details_page_load_stage3 (GsDetailsPage *self)
+{
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	/* if this fails (e.g. because we have no networking) then it's
+	 * of no huge importance if we don't get the required data */
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "app", self->app,
+					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ADDONS |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
+							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEWS,
+					 NULL);
+	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job,
+					    self->refine_cancellable,
+					    gs_details_page_load_stage3_cb,
+					    gs_details_page_refine_helper_new (self));
+}
+
+static void
+gs_details_page_load_stage2_done (GsDetailsPage *self)
 {
 	g_autofree gchar *tmp = NULL;
-	g_autoptr(GsPluginJob) plugin_job1 = NULL;
-	g_autoptr(GsPluginJob) plugin_job2 = NULL;
+
+	if (gs_app_get_state (self->app) == AS_APP_STATE_UNKNOWN) {
+		g_autofree gchar *str = NULL;
+		const gchar *id = gs_app_get_id (self->app);
+		str = g_strdup_printf (_("Unable to find “%s”"), id == NULL ? gs_app_get_source_default (self->app) : id);
+		gtk_label_set_text (GTK_LABEL (self->label_failed), str);
+		gs_details_page_set_state (self, GS_DETAILS_PAGE_STATE_FAILED);
+		return;
+	}
 
 	/* print what we've got */
 	tmp = gs_app_to_string (self->app);
 	g_debug ("%s", tmp);
 
+	gs_details_page_refresh_size (self);
+	gs_details_page_refresh_all (self);
+
+	/* do 3rd stage refine */
+	gs_details_page_load_stage3 (self);
+}
+
+static void
+gs_details_page_load_stage2_cb (GObject *source,
+				GAsyncResult *res,
+				gpointer user_data)
+{
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
+	g_autoptr(GsDetailsPageRefineHelper) helper = (GsDetailsPageRefineHelper *) user_data;
+	GsDetailsPage *self = helper->self;
+	g_autoptr(GError) error = NULL;
+
+	if (!gs_plugin_loader_job_action_finish (plugin_loader, res, &error)) {
+		if (gs_details_page_refine_is_stale (helper, error))
+			return;
+		g_warning ("failed to refine %s: %s",
+			   gs_app_get_id (self->app),
+			   error->message);
+	}
+	if (gs_details_page_refine_is_stale (helper, NULL))
+		return;
+	gs_details_page_load_stage2_done (self);
+}
+
+/* show the UI and do operations that should not block page load */
+static void
+gs_details_page_load_stage2 (GsDetailsPage *self)
+{
+	g_autoptr(GsPluginJob) plugin_job1 = NULL;
+	g_autoptr(GsPluginJob) plugin_job2 = NULL;
+
 	/* update UI */
 	gs_details_page_set_state (self, GS_DETAILS_PAGE_STATE_READY);
 	gs_details_page_refresh_screenshots (self);
@@ -1647,57 +1768,99 @@ gs_details_page_load_stage2 (GsDetailsPage *self)
 	gs_details_page_refresh_all (self);
 	gs_details_page_refresh_content_rating (self);
 
-	/* if these tasks fail (e.g. because we have no networking) then it's
-	 * of no huge importance if we don't get the required data */
+	/* the size and anything else the packaging system knows */
 	plugin_job1 = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
 					  "app", self->app,
-					  "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_RATING |
-							  GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEW_RATINGS |
-							  GS_PLUGIN_REFINE_FLAGS_REQUIRE_REVIEWS |
-							  GS_PLUGIN_REFINE_FLAGS_REQUIRE_SIZE,
+					  "refine-flags", GS_DETAILS_PAGE_REFINE_FLAGS_PACKAGING,
 					  NULL);
+	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job1,
+					    self->refine_cancellable,
+					    gs_details_page_load_stage2_cb,
+					    gs_details_page_refine_helper_new (self));
 	plugin_job2 = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_ALTERNATES,
 					  "interactive", TRUE,
 					  "app", self->app,
 					  "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME |
 							  GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROVENANCE,
 					  NULL);
-	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job1,
-					    self->cancellable,
-					    gs_details_page_app_refine_cb,
-					    self);
 	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job2,
-					    self->cancellable,
+					    self->refine_cancellable,
 					    gs_details_page_get_alternates_cb,
 					    self);
 }
 
+static void
+gs_details_page_load_stage1_done (GsDetailsPage *self)
+{
+	if (gs_app_get_kind (self->app) == AS_APP_KIND_UNKNOWN ||
+	    gs_app_get_state (self->app) == AS_APP_STATE_UNKNOWN) {
+		g_autofree gchar *str = NULL;
+		const gchar *id = gs_app_get_id (self->app);
+		str = g_strdup_printf (_("Unable to find “%s”"), id == NULL ? gs_app_get_source_default (self->app) : id);
+		gtk_label_set_text (GTK_LABEL (self->label_failed), str);
+		gs_details_page_set_state (self, GS_DETAILS_PAGE_STATE_FAILED);
+		return;
+	}
+
+	/* do 2nd stage refine */
+	gs_details_page_load_stage2 (self);
+}
+
 static void
 gs_details_page_load_stage1_cb (GObject *source,
 				GAsyncResult *res,
 				gpointer user_data)
 {
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source);
-	GsDetailsPage *self = GS_DETAILS_PAGE (user_data);
+	g_autoptr(GsDetailsPageRefineHelper) helper = (GsDetailsPageRefineHelper *) user_data;
+	GsDetailsPage *self = helper->self;
 	g_autoptr(GError) error = NULL;
 
 	if (!gs_plugin_loader_job_action_finish (plugin_loader, res, &error)) {
+		if (gs_details_page_refine_is_stale (helper, error))
+			return;
 		g_warning ("failed to refine %s: %s",
 			   gs_app_get_id (self->app),
 			   error->message);
 	}
-	if (gs_app_get_kind (self->app) == AS_APP_KIND_UNKNOWN ||
-	    gs_app_get_state (self->app) == AS_APP_STATE_UNKNOWN) {
-		g_autofree gchar *str = NULL;
-		const gchar *id = gs_app_get_id (self->app);
-		str = g_strdup_printf (_("Unable to find “%s”"), id == NULL ? gs_app_get_source_default (self->app) : id);
-		gtk_label_set_text (GTK_LABEL (self->label_failed), str);
-		gs_details_page_set_state (self, GS_DETAILS_PAGE_STATE_FAILED);
+	if (gs_details_page_refine_is_stale (helper, NULL))
 		return;
-	}
+	gs_details_page_load_stage1_done (self);
+}
 
-	/* do 2nd stage refine */
-	gs_details_page_load_stage2 (self);
+static void
+gs_details_page_load_stage1_refine (GsDetailsPage *self)
+{
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
+					 "app", self->app,
+					 "refine-flags", GS_DETAILS_PAGE_REFINE_FLAGS_METADATA,
+					 NULL);
+	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job,
+					    self->refine_cancellable,
+					    gs_details_page_load_stage1_cb,
+					    gs_details_page_refine_helper_new (self));
+}
+
+static void
+gs_details_page_claim_prefetched_cb (GObject *source,
+				     GAsyncResult *res,
+				     gpointer user_data)
+{
+	GsAppPrefetcher *prefetcher = GS_APP_PREFETCHER (source);
+	g_autoptr(GsDetailsPageRefineHelper) helper = (GsDetailsPageRefineHelper *) user_data;
+	GsDetailsPage *self = helper->self;
+
+	if (gs_details_page_refine_is_stale (helper, NULL))
+		return;
+	if (!gs_app_prefetcher_claim_app_finish (prefetcher, res, NULL)) {
+		gs_details_page_load_stage1_refine (self);
+		return;
+	}
+	g_debug ("using prefetched details for %s",
+		 gs_app_get_unique_id (self->app));
+	gs_details_page_load_stage1_done (self);
 }
 
 static void
@@ -1721,6 +1884,7 @@ gs_details_page_file_to_app_cb (GObject *source,
 		GsApp *app = gs_app_list_index (list, 0);
 		g_set_object (&self->app_local_file, app);
 		_set_app (self, app);
+		gs_details_page_reset_refine (self);
 		gs_details_page_load_stage2 (self);
 	}
 }
@@ -1745,6 +1909,7 @@ gs_details_page_url_to_app_cb (GObject *source,
 	} else {
 		GsApp *app = gs_app_list_index (list, 0);
 		_set_app (self, app);
+		gs_details_page_reset_refine (self);
 		gs_details_page_load_stage2 (self);
 	}
 }
@@ -1816,47 +1981,46 @@ gs_details_page_set_url (GsDetailsPage *self, const gchar *url)
 					    self);
 }
 
-/* refines a GsApp */
+/* refines a GsApp with what the metadata already has, so the page can be
+ * shown before the slower plugins have finished */
 static void
 gs_details_page_load_stage1 (GsDetailsPage *self)
 {
-	g_autoptr(GsPluginJob) plugin_job = NULL;
+	GsAppPrefetcher *prefetcher = gs_shell_get_prefetcher (self->shell);
 
 	/* update UI */
 	gs_page_switch_to (GS_PAGE (self), TRUE);
 	gs_details_page_set_state (self, GS_DETAILS_PAGE_STATE_LOADING);
 
-	/* get extra details about the app */
-	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
-					 "app", self->app,
-					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_HISTORY |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_SETUP_ACTION |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_MENU_PATH |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_URL |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_SETUP_ACTION |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROVENANCE |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_RUNTIME |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_ADDONS |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROJECT_GROUP |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_DEVELOPER_NAME |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_KUDOS |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_CONTENT_RATING |
-							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS,
-					 NULL);
-	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job,
-					    self->cancellable,
-					    gs_details_page_load_stage1_cb,
-					    self);
+	/* get extra details about the app, unless that was already done or
+	 * is being done in the background */
+	gs_details_page_reset_refine (self);
+	if (prefetcher != NULL) {
+		gs_app_prefetcher_claim_app_async (prefetcher, self->app,
+						   self->refine_cancellable,
+						   gs_details_page_claim_prefetched_cb,
+						   gs_details_page_refine_helper_new (self));
+	} else {
+		gs_details_page_load_stage1_refine (self);
+	}
 
 	/* update UI with loading page */
 	gs_details_page_refresh_all (self);
 }
 
+static void
+gs_details_page_switch_from (GsPage *page)
+{
+	GsDetailsPage *self = GS_DETAILS_PAGE (page);
+
+	/* showing another app reuses this page and has already started */
+	if (gs_shell_get_mode (self->shell) == GS_SHELL_MODE_DETAILS)
+		return;
+
+	/* nobody is going to see the rest */
+	gs_details_page_cancel_refine (self);
+}
+
 static void
 gs_details_page_reload (GsPage *page)
 {
@@ -2457,6 +2621,7 @@ gs_details_page_dispose (GObject *object)
 	g_clear_object (&self->plugin_loader);
 	g_clear_object (&self->cancellable);
 	g_clear_object (&self->app_cancellable);
+	gs_details_page_cancel_refine (self);
 	g_clear_object (&self->session);
 	g_clear_object (&self->size_group_origin_popover);
 
@@ -2474,6 +2639,7 @@ gs_details_page_class_init (GsDetailsPageClass *klass)
 	page_class->app_installed = gs_details_page_app_installed;
 	page_class->app_removed = gs_details_page_app_removed;
 	page_class->switch_to = gs_details_page_switch_to;
+	page_class->switch_from = gs_details_page_switch_from;
 	page_class->reload = gs_details_page_reload;
 	page_class->setup = gs_details_page_setup;
 
@@ -29,6 +29,29 @@ G_BEGIN_DECLS
 
 #define GS_TYPE_DETAILS_PAGE (gs_details_page_get_type ())
 
+/* what the page needs before it can be shown, and then what the packaging
+ * system knows; reviews and addons are fetched later -- anything that can
+ * change the state has to be in the first stage, or the page would be shown
+ * as ready and then fail */
+#define GS_DETAILS_PAGE_REFINE_FLAGS_STATE	(GS_PLUGIN_REFINE_FLAGS_REQUIRE_SETUP_ACTION)
+#define GS_DETAILS_PAGE_REFINE_FLAGS_METADATA	(GS_DETAILS_PAGE_REFINE_FLAGS_STATE | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_SCREENSHOTS | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_LICENSE | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_URL | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROVENANCE | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_PROJECT_GROUP | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_DEVELOPER_NAME | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_KUDOS | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_CONTENT_RATING)
+#define GS_DETAILS_PAGE_REFINE_FLAGS_PACKAGING	(GS_PLUGIN_REFINE_FLAGS_REQUIRE_SIZE | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_HISTORY | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_ORIGIN_HOSTNAME | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_MENU_PATH | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_PERMISSIONS | \
+						 GS_PLUGIN_REFINE_FLAGS_REQUIRE_RUNTIME)
+
 G_DECLARE_FINAL_TYPE (GsDetailsPage, gs_details_page, GS, DETAILS_PAGE, GsPage)
 
 GsDetailsPage	*gs_details_page_new		(void);
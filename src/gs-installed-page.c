@@ -33,6 +33,11 @@
 #include "gs-app-folder-dialog.h"
 #include "gs-folders.h"
 
+/* rows are created in batches of this size; the first batch fills the
+ * viewport and the rest are added as the user scrolls to within a page of
+ * the last realized row */
+#define GS_INSTALLED_PAGE_ROWS_BATCH	30
+
 struct _GsInstalledPage
 {
 	GsPage			 parent_instance;
@@ -50,6 +55,9 @@ struct _GsInstalledPage
 	GtkWidget		*button_select;
 	gboolean 		 selection_mode;
 	GSettings		*settings;
+	GPtrArray		*pending_rows;	/* of GsApp, sorted */
+	guint			 pending_rows_idx;	/* first not yet realized */
+	GHashTable		*installed_index;	/* for gs_utils_fuzzy_index_has_app() */
 
 	GtkWidget		*bottom_install;
 	GtkWidget		*button_folder_add;
@@ -114,6 +122,14 @@ gs_installed_page_app_removed (GsPage *page, GsApp *app)
 	GsInstalledPage *self = GS_INSTALLED_PAGE (page);
 	g_autoptr(GList) children = NULL;
 
+	/* not yet realized as a row */
+	for (guint i = self->pending_rows_idx; i < self->pending_rows->len; i++) {
+		if (g_ptr_array_index (self->pending_rows, i) == app) {
+			g_ptr_array_remove_index (self->pending_rows, i);
+			break;
+		}
+	}
+
 	children = gtk_container_get_children (GTK_CONTAINER (self->list_box_install));
 	for (GList *l = children; l; l = l->next) {
 		GsAppRow *app_row = GS_APP_ROW (l->data);
@@ -181,14 +197,14 @@ gs_installed_page_is_actual_app (GsApp *app)
 }
 
 static void
-gs_installed_page_add_app (GsInstalledPage *self, GsAppList *list, GsApp *app)
+gs_installed_page_add_app (GsInstalledPage *self, GHashTable *fuzzy_index, GsApp *app)
 {
 	GtkWidget *app_row;
 
 	app_row = gs_app_row_new (app);
 	gs_app_row_set_show_folders (GS_APP_ROW (app_row), TRUE);
 	gs_app_row_set_show_buttons (GS_APP_ROW (app_row), TRUE);
-	if (gs_utils_list_has_app_fuzzy (list, app))
+	if (gs_utils_fuzzy_index_has_app (fuzzy_index, app))
 		gs_app_row_set_show_source (GS_APP_ROW (app_row), TRUE);
 	g_signal_connect (app_row, "button-clicked",
 			  G_CALLBACK (gs_installed_page_app_remove_cb), self);
@@ -215,17 +231,80 @@ gs_installed_page_add_app (GsInstalledPage *self, GsAppList *list, GsApp *app)
 	gtk_widget_set_visible (app_row, gs_installed_page_is_actual_app (app));
 }
 
+static gint gs_installed_page_sort_apps (GsApp *app1, GsApp *app2, gpointer user_data);
+
+static gint
+gs_installed_page_sort_pending_rows_cb (gconstpointer a, gconstpointer b)
+{
+	GsApp *app1 = *((GsApp **) a);
+	GsApp *app2 = *((GsApp **) b);
+	return gs_installed_page_sort_apps (app1, app2, NULL);
+}
+
+static void
+gs_installed_page_clear_pending_rows (GsInstalledPage *self)
+{
+	g_ptr_array_set_size (self->pending_rows, 0);
+	self->pending_rows_idx = 0;
+}
+
+/* returns the number of rows added */
+static guint
+gs_installed_page_add_pending_rows (GsInstalledPage *self, guint max_rows)
+{
+	guint added = 0;
+
+	while (added < max_rows &&
+	       self->pending_rows_idx < self->pending_rows->len) {
+		GsApp *app = g_ptr_array_index (self->pending_rows,
+						self->pending_rows_idx++);
+		gs_installed_page_add_app (self, self->installed_index, app);
+
+		/* hidden rows do not take up any of the viewport */
+		if (self->selection_mode || gs_installed_page_is_actual_app (app))
+			added++;
+	}
+	return added;
+}
+
+static void
+gs_installed_page_add_all_pending_rows (GsInstalledPage *self)
+{
+	gs_installed_page_add_pending_rows (self, G_MAXUINT);
+}
+
+/* add another batch of rows if the user is within one page of the end of
+ * what has been realized so far */
+static void
+gs_installed_page_adjustment_changed_cb (GtkAdjustment *adj,
+                                         GsInstalledPage *self)
+{
+	gdouble remaining;
+
+	if (self->pending_rows == NULL ||
+	    self->pending_rows_idx >= self->pending_rows->len)
+		return;
+	remaining = gtk_adjustment_get_upper (adj) -
+		    gtk_adjustment_get_value (adj) -
+		    gtk_adjustment_get_page_size (adj);
+	if (remaining > gtk_adjustment_get_page_size (adj))
+		return;
+	gs_installed_page_add_pending_rows (self, GS_INSTALLED_PAGE_ROWS_BATCH);
+}
+
 static void
 gs_installed_page_get_installed_cb (GObject *source_object,
                                     GAsyncResult *res,
                                     gpointer user_data)
 {
 	guint i;
+	guint added;
 	GsApp *app;
 	GsInstalledPage *self = GS_INSTALLED_PAGE (user_data);
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GsAppList) list = NULL;
+	g_autoptr(GTimer) timer = g_timer_new ();
 
 	gs_stop_spinner (GTK_SPINNER (self->spinner_install));
 	gtk_stack_set_visible_child_name (GTK_STACK (self->stack_install), "view");
@@ -241,10 +320,21 @@ gs_installed_page_get_installed_cb (GObject *source_object,
 			g_warning ("failed to get installed apps: %s", error->message);
 		goto out;
 	}
+
+	/* only create rows for the first screenful, in the same order the
+	 * list box would sort them, and add the rest when scrolled to */
+	g_clear_pointer (&self->installed_index, g_hash_table_unref);
+	self->installed_index = gs_utils_list_fuzzy_index_new (list);
+	gs_installed_page_clear_pending_rows (self);
 	for (i = 0; i < gs_app_list_length (list); i++) {
 		app = gs_app_list_index (list, i);
-		gs_installed_page_add_app (self, list, app);
+		g_ptr_array_add (self->pending_rows, g_object_ref (app));
 	}
+	g_ptr_array_sort (self->pending_rows, gs_installed_page_sort_pending_rows_cb);
+	added = gs_installed_page_add_pending_rows (self, GS_INSTALLED_PAGE_ROWS_BATCH);
+	g_debug ("added %u of %u installed rows in %.1fms",
+		 added, gs_app_list_length (list),
+		 g_timer_elapsed (timer, NULL) * 1000);
 out:
 	gs_installed_page_pending_apps_changed_cb (plugin_loader, self);
 }
@@ -260,6 +350,7 @@ gs_installed_page_load (GsInstalledPage *self)
 	self->waiting = TRUE;
 
 	/* remove old entries */
+	gs_installed_page_clear_pending_rows (self);
 	gs_container_remove_all (GTK_CONTAINER (self->list_box_install));
 
 	flags = GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
@@ -349,9 +440,9 @@ gs_installed_page_switch_to (GsPage *page, gboolean scroll_up)
 }
 
 /**
- * gs_installed_page_get_app_sort_key:
+ * gs_installed_page_get_app_sort_rank:
  *
- * Get a sort key to achive this:
+ * Get a sort rank to achive this:
  *
  * 1. state:installing applications
  * 2. state: applications queued for installing
@@ -359,79 +450,86 @@ gs_installed_page_switch_to (GsPage *page, gboolean scroll_up)
  * 4. kind:normal applications
  * 5. kind:system applications
  *
- * Within each of these groups, they are sorted by the install date and then
- * by name.
+ * Within each of these groups, they are sorted by the name collation key
+ * cached on the #GsApp, so no strings are built for each comparison.
  **/
-static gchar *
-gs_installed_page_get_app_sort_key (GsApp *app)
+static guint
+gs_installed_page_get_app_sort_rank (GsApp *app)
 {
-	GString *key;
-	g_autofree gchar *casefolded_name = NULL;
-
-	key = g_string_sized_new (64);
+	guint rank_state;
+	guint rank_kind;
+	guint rank_quirk;
 
 	/* sort installed, removing, other */
 	switch (gs_app_get_state (app)) {
 	case AS_APP_STATE_INSTALLING:
-		g_string_append (key, "1:");
+		rank_state = 1;
 		break;
 	case AS_APP_STATE_QUEUED_FOR_INSTALL:
-		g_string_append (key, "2:");
+		rank_state = 2;
 		break;
 	case AS_APP_STATE_REMOVING:
-		g_string_append (key, "3:");
+		rank_state = 3;
 		break;
 	default:
-		g_string_append (key, "4:");
+		rank_state = 4;
 		break;
 	}
 
 	/* sort apps by kind */
 	switch (gs_app_get_kind (app)) {
 	case AS_APP_KIND_OS_UPDATE:
-		g_string_append (key, "1:");
+		rank_kind = 1;
 		break;
 	case AS_APP_KIND_DESKTOP:
-		g_string_append (key, "2:");
+		rank_kind = 2;
 		break;
 	case AS_APP_KIND_WEB_APP:
-		g_string_append (key, "3:");
+		rank_kind = 3;
 		break;
 	case AS_APP_KIND_RUNTIME:
-		g_string_append (key, "4:");
+		rank_kind = 4;
 		break;
 	case AS_APP_KIND_ADDON:
-		g_string_append (key, "5:");
+		rank_kind = 5;
 		break;
 	case AS_APP_KIND_CODEC:
-		g_string_append (key, "6:");
+		rank_kind = 6;
 		break;
 	case AS_APP_KIND_FONT:
-		g_string_append (key, "6:");
+		rank_kind = 6;
 		break;
 	case AS_APP_KIND_INPUT_METHOD:
-		g_string_append (key, "7:");
+		rank_kind = 7;
 		break;
 	case AS_APP_KIND_SHELL_EXTENSION:
-		g_string_append (key, "8:");
+		rank_kind = 8;
 		break;
 	default:
-		g_string_append (key, "9:");
+		rank_kind = 9;
 		break;
 	}
 
 	/* sort normal, compulsory */
-	if (!gs_app_has_quirk (app, GS_APP_QUIRK_COMPULSORY))
-		g_string_append (key, "1:");
-	else
-		g_string_append (key, "2:");
-
-	/* finally, sort by short name */
-	if (gs_app_get_name (app) != NULL) {
-		casefolded_name = g_utf8_casefold (gs_app_get_name (app), -1);
-		g_string_append (key, casefolded_name);
-	}
-	return g_string_free (key, FALSE);
+	rank_quirk = gs_app_has_quirk (app, GS_APP_QUIRK_COMPULSORY) ? 2 : 1;
+
+	return (rank_state << 8) | (rank_kind << 4) | rank_quirk;
+}
+
+static gint
+gs_installed_page_sort_apps (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	guint rank1, rank2;
+
+	/* compare the ranks according to the algorithm above */
+	rank1 = gs_installed_page_get_app_sort_rank (app1);
+	rank2 = gs_installed_page_get_app_sort_rank (app2);
+	if (rank1 != rank2)
+		return rank1 < rank2 ? -1 : 1;
+
+	/* finally, sort by name */
+	return g_strcmp0 (gs_app_get_name_sort_key (app1),
+			  gs_app_get_name_sort_key (app2));
 }
 
 static gint
@@ -439,23 +537,15 @@ gs_installed_page_sort_func (GtkListBoxRow *a,
                              GtkListBoxRow *b,
                              gpointer user_data)
 {
-	GsApp *a1, *a2;
-	g_autofree gchar *key1 = NULL;
-	g_autofree gchar *key2 = NULL;
-
 	/* check valid */
 	if (!GTK_IS_BIN(a) || !GTK_IS_BIN(b)) {
 		g_warning ("GtkListBoxRow not valid");
 		return 0;
 	}
 
-	a1 = gs_app_row_get_app (GS_APP_ROW (a));
-	a2 = gs_app_row_get_app (GS_APP_ROW (b));
-	key1 = gs_installed_page_get_app_sort_key (a1);
-	key2 = gs_installed_page_get_app_sort_key (a2);
-
-	/* compare the keys according to the algorithm above */
-	return g_strcmp0 (key1, key2);
+	return gs_installed_page_sort_apps (gs_app_row_get_app (GS_APP_ROW (a)),
+					    gs_app_row_get_app (GS_APP_ROW (b)),
+					    user_data);
 }
 
 typedef enum {
@@ -538,6 +628,11 @@ gs_installed_page_has_app (GsInstalledPage *self,
 	gboolean ret = FALSE;
 	g_autoptr(GList) children = NULL;
 
+	for (guint i = self->pending_rows_idx; i < self->pending_rows->len; i++) {
+		if (g_ptr_array_index (self->pending_rows, i) == app)
+			return TRUE;
+	}
+
 	children = gtk_container_get_children (GTK_CONTAINER (self->list_box_install));
 	for (GList *l = children; l; l = l->next) {
 		GsAppRow *app_row = GS_APP_ROW (l->data);
@@ -558,9 +653,11 @@ gs_installed_page_pending_apps_changed_cb (GsPluginLoader *plugin_loader,
 	guint i;
 	guint cnt = 0;
 	g_autoptr(GsAppList) pending = NULL;
+	g_autoptr(GHashTable) pending_index = NULL;
 
 	/* add new apps to the list */
 	pending = gs_plugin_loader_get_pending (plugin_loader);
+	pending_index = gs_utils_list_fuzzy_index_new (pending);
 	for (i = 0; i < gs_app_list_length (pending); i++) {
 		app = gs_app_list_index (pending, i);
 
@@ -571,7 +668,7 @@ gs_installed_page_pending_apps_changed_cb (GsPluginLoader *plugin_loader,
 
 		/* do not to add pending apps more than once. */
 		if (gs_installed_page_has_app (self, app) == FALSE)
-			gs_installed_page_add_app (self, pending, app);
+			gs_installed_page_add_app (self, pending_index, app);
 
 		/* incremement the label */
 		cnt++;
@@ -620,6 +717,9 @@ set_selection_mode (GsInstalledPage *self, gboolean selection_mode)
 		gtk_widget_show (widget);
 		widget = GTK_WIDGET (gtk_builder_get_object (self->builder, "header_selection_label"));
 		gtk_label_set_label (GTK_LABEL (widget), _("Click on items to select them"));
+
+		/* every app has to be selectable */
+		gs_installed_page_add_all_pending_rows (self);
 	} else {
 		gtk_header_bar_set_show_close_button (GTK_HEADER_BAR (header), TRUE);
 		gtk_style_context_remove_class (context, "selection-mode");
@@ -788,6 +888,7 @@ gs_installed_page_setup (GsPage *page,
 {
 	GsInstalledPage *self = GS_INSTALLED_PAGE (page);
 	AtkObject *accessible;
+	GtkAdjustment *adj;
 	GtkWidget *widget;
 
 	g_return_val_if_fail (GS_IS_INSTALLED_PAGE (self), TRUE);
@@ -810,6 +911,11 @@ gs_installed_page_setup (GsPage *page,
 	gtk_list_box_set_sort_func (GTK_LIST_BOX (self->list_box_install),
 				    gs_installed_page_sort_func,
 				    self, NULL);
+	adj = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (self->scrolledwindow_install));
+	g_signal_connect (adj, "value-changed",
+			  G_CALLBACK (gs_installed_page_adjustment_changed_cb), self);
+	g_signal_connect (adj, "changed",
+			  G_CALLBACK (gs_installed_page_adjustment_changed_cb), self);
 
 	g_signal_connect (self->button_folder_add, "clicked",
 			  G_CALLBACK (show_folder_dialog), self);
@@ -851,6 +957,8 @@ gs_installed_page_dispose (GObject *object)
 	g_clear_object (&self->plugin_loader);
 	g_clear_object (&self->cancellable);
 	g_clear_object (&self->settings);
+	g_clear_pointer (&self->pending_rows, g_ptr_array_unref);
+	g_clear_pointer (&self->installed_index, g_hash_table_unref);
 
 	G_OBJECT_CLASS (gs_installed_page_parent_class)->dispose (object);
 }
@@ -890,6 +998,7 @@ gs_installed_page_init (GsInstalledPage *self)
 	self->sizegroup_desc = gtk_size_group_new (GTK_SIZE_GROUP_HORIZONTAL);
 	self->sizegroup_button = gtk_size_group_new (GTK_SIZE_GROUP_HORIZONTAL);
 
+	self->pending_rows = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	self->settings = g_settings_new ("org.gnome.software");
 	g_signal_connect_swapped (self->settings, "changed",
 				  G_CALLBACK (gs_shell_settings_changed_cb),
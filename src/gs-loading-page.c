@@ -124,7 +124,7 @@ gs_loading_page_refresh_cb (GObject *source_object, GAsyncResult *res, gpointer
 	g_signal_emit (self, signals[SIGNAL_REFRESHED], 0);
 }
 
-static void
+void
 gs_loading_page_load (GsLoadingPage *self)
 {
 	GsLoadingPagePrivate *priv = gs_loading_page_get_instance_private (self);
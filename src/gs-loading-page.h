@@ -39,6 +39,7 @@ struct _GsLoadingPageClass
 };
 
 GsLoadingPage	*gs_loading_page_new		(void);
+void		 gs_loading_page_load		(GsLoadingPage	*self);
 
 G_END_DECLS
 
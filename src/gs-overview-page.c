@@ -53,6 +53,11 @@ typedef struct
 	gboolean		 loading_popular_rotating;
 	gboolean		 loading_categories;
 	gboolean		 empty;
+	gboolean		 showing_snapshot;
+	gboolean		 clear_popular_rotating;
+	GKeyFile		*snapshot;	/* being built by the current load */
+	GKeyFile		*snapshot_last;	/* of the last complete load */
+	gint64			 setup_time;
 	gchar			*category_of_day;
 	GHashTable		*category_hash;		/* id : GsCategory */
 	GSettings		*settings;
@@ -125,6 +130,18 @@ app_tile_clicked (GsAppTile *tile, gpointer data)
 	gs_shell_show_app (priv->shell, app);
 }
 
+static void
+app_tile_prefetch (GsAppTile *tile, gpointer data)
+{
+	GsOverviewPage *self = GS_OVERVIEW_PAGE (data);
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+
+	/* snapshot apps have no plugin to refine them */
+	if (!gtk_widget_is_sensitive (GTK_WIDGET (tile)))
+		return;
+	gs_shell_prefetch_app (priv->shell, gs_app_tile_get_app (tile));
+}
+
 static gboolean
 filter_category (GsApp *app, gpointer user_data)
 {
@@ -133,6 +150,106 @@ filter_category (GsApp *app, gpointer user_data)
 	return !gs_app_has_category (app, category);
 }
 
+static void
+gs_overview_page_snapshot_add_app (GKeyFile *snapshot, GsApp *app)
+{
+	GPtrArray *key_colors = gs_app_get_key_colors (app);
+	const gchar *tmp;
+	g_autofree gchar *group = NULL;
+	g_autoptr(GIcon) icon = NULL;
+	g_autoptr(GPtrArray) colors = g_ptr_array_new_with_free_func (g_free);
+
+	group = g_strdup_printf ("app %s", gs_app_get_unique_id (app));
+	if (g_key_file_has_group (snapshot, group))
+		return;
+	if (gs_app_get_name (app) != NULL)
+		g_key_file_set_string (snapshot, group, "Name", gs_app_get_name (app));
+	if (gs_app_get_summary (app) != NULL)
+		g_key_file_set_string (snapshot, group, "Summary", gs_app_get_summary (app));
+	g_key_file_set_string (snapshot, group, "State",
+			       as_app_state_to_string (gs_app_get_state (app)));
+	g_key_file_set_integer (snapshot, group, "Rating", gs_app_get_rating (app));
+	for (guint i = 0; i < key_colors->len; i++) {
+		GdkRGBA *rgba = g_ptr_array_index (key_colors, i);
+		g_ptr_array_add (colors, gdk_rgba_to_string (rgba));
+	}
+	if (colors->len > 0) {
+		g_key_file_set_string_list (snapshot, group, "KeyColors",
+					    (const gchar * const *) colors->pdata,
+					    colors->len);
+	}
+	tmp = gs_app_get_metadata_item (app, "GnomeSoftware::FeatureTile-css");
+	if (tmp != NULL)
+		g_key_file_set_string (snapshot, group, "FeatureTileCss", tmp);
+	tmp = gs_app_get_metadata_item (app, "GnomeSoftware::PopularTile-css");
+	if (tmp != NULL)
+		g_key_file_set_string (snapshot, group, "PopularTileCss", tmp);
+
+	/* only store a reference to the icon, never the pixels */
+	icon = gs_utils_get_app_icon_ref (app, "overview");
+	if (icon != NULL) {
+		g_autofree gchar *icon_str = g_icon_to_string (icon);
+		if (icon_str != NULL)
+			g_key_file_set_string (snapshot, group, "Icon", icon_str);
+	}
+}
+
+/* remember what was shown so the next start can show it straight away */
+static void
+gs_overview_page_snapshot_add (GsOverviewPage *self,
+			       const gchar *group,
+			       GsAppList *list,
+			       guint max_results)
+{
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+	g_autoptr(GPtrArray) ids = g_ptr_array_new ();
+
+	if (priv->snapshot == NULL)
+		return;
+	for (guint i = 0; i < gs_app_list_length (list) && i < max_results; i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		if (gs_app_get_unique_id (app) == NULL)
+			continue;
+		gs_overview_page_snapshot_add_app (priv->snapshot, app);
+		g_ptr_array_add (ids, (gpointer) gs_app_get_unique_id (app));
+	}
+	g_key_file_set_string_list (priv->snapshot, group, "Apps",
+				    (const gchar * const *) ids->pdata, ids->len);
+}
+
+/**
+ * gs_overview_page_save_snapshot:
+ * @self: A #GsOverviewPage
+ *
+ * Saves the overview as it was last completely loaded, so that
+ * gs_overview_page_load_snapshot() can show it on the next start.
+ */
+void
+gs_overview_page_save_snapshot (GsOverviewPage *self)
+{
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+	g_autofree gchar *filename = NULL;
+	g_autoptr(GError) error = NULL;
+
+	g_return_if_fail (GS_IS_OVERVIEW_PAGE (self));
+
+	if (priv->snapshot_last == NULL)
+		return;
+	filename = gs_utils_get_cache_filename ("overview", "snapshot.ini",
+						GS_UTILS_CACHE_FLAG_WRITEABLE,
+						&error);
+	if (filename == NULL) {
+		g_warning ("failed to get overview snapshot filename: %s",
+			   error->message);
+		return;
+	}
+	if (!g_key_file_save_to_file (priv->snapshot_last, filename, &error)) {
+		g_warning ("failed to save overview snapshot: %s", error->message);
+		return;
+	}
+	g_debug ("saved overview snapshot to %s", filename);
+}
+
 static void
 gs_overview_page_decrement_action_cnt (GsOverviewPage *self)
 {
@@ -148,6 +265,16 @@ gs_overview_page_decrement_action_cnt (GsOverviewPage *self)
 
 	/* all done */
 	priv->cache_valid = TRUE;
+	priv->showing_snapshot = FALSE;
+	if (priv->clear_popular_rotating) {
+		gs_container_remove_all (GTK_CONTAINER (priv->box_popular_rotating));
+		priv->clear_popular_rotating = FALSE;
+	}
+	if (!priv->empty) {
+		g_clear_pointer (&priv->snapshot_last, g_key_file_unref);
+		priv->snapshot_last = g_steal_pointer (&priv->snapshot);
+	}
+	g_clear_pointer (&priv->snapshot, g_key_file_unref);
 	g_signal_emit (self, signals[SIGNAL_REFRESHED], 0);
 	priv->loading_categories = FALSE;
 	priv->loading_featured = FALSE;
@@ -156,6 +283,27 @@ gs_overview_page_decrement_action_cnt (GsOverviewPage *self)
 	priv->loading_popular_rotating = FALSE;
 }
 
+static void
+gs_overview_page_set_tiles (GsOverviewPage *self,
+			    GtkWidget *box,
+			    GtkWidget *heading,
+			    GsAppList *list)
+{
+	gs_container_remove_all (GTK_CONTAINER (box));
+
+	for (guint i = 0; i < gs_app_list_length (list) && i < N_TILES; i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GtkWidget *tile = gs_popular_tile_new (app);
+		g_signal_connect (tile, "clicked",
+			  G_CALLBACK (app_tile_clicked), self);
+		g_signal_connect (tile, "prefetch",
+			  G_CALLBACK (app_tile_prefetch), self);
+		gtk_container_add (GTK_CONTAINER (box), tile);
+	}
+	gtk_widget_set_visible (box, TRUE);
+	gtk_widget_set_visible (heading, TRUE);
+}
+
 static void
 gs_overview_page_get_popular_cb (GObject *source_object,
                                  GAsyncResult *res,
@@ -164,9 +312,6 @@ gs_overview_page_get_popular_cb (GObject *source_object,
 	GsOverviewPage *self = GS_OVERVIEW_PAGE (user_data);
 	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
-	guint i;
-	GsApp *app;
-	GtkWidget *tile;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GsAppList) list = NULL;
 
@@ -191,17 +336,8 @@ gs_overview_page_get_popular_cb (GObject *source_object,
 	gs_app_list_filter (list, filter_category, priv->category_of_day);
 	gs_app_list_randomize (list);
 
-	gs_container_remove_all (GTK_CONTAINER (priv->box_popular));
-
-	for (i = 0; i < gs_app_list_length (list) && i < N_TILES; i++) {
-		app = gs_app_list_index (list, i);
-		tile = gs_popular_tile_new (app);
-		g_signal_connect (tile, "clicked",
-			  G_CALLBACK (app_tile_clicked), self);
-		gtk_container_add (GTK_CONTAINER (priv->box_popular), tile);
-	}
-	gtk_widget_set_visible (priv->box_popular, TRUE);
-	gtk_widget_set_visible (priv->popular_heading, TRUE);
+	gs_overview_page_set_tiles (self, priv->box_popular, priv->popular_heading, list);
+	gs_overview_page_snapshot_add (self, "popular", list, N_TILES);
 
 	priv->empty = FALSE;
 
@@ -215,9 +351,6 @@ gs_overview_page_get_recent_cb (GObject *source_object, GAsyncResult *res, gpoin
 	GsOverviewPage *self = GS_OVERVIEW_PAGE (user_data);
 	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
 	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
-	guint i;
-	GsApp *app;
-	GtkWidget *tile;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GsAppList) list = NULL;
 
@@ -242,17 +375,8 @@ gs_overview_page_get_recent_cb (GObject *source_object, GAsyncResult *res, gpoin
 	gs_app_list_filter (list, filter_category, priv->category_of_day);
 	gs_app_list_randomize (list);
 
-	gs_container_remove_all (GTK_CONTAINER (priv->box_recent));
-
-	for (i = 0; i < gs_app_list_length (list) && i < N_TILES; i++) {
-		app = gs_app_list_index (list, i);
-		tile = gs_popular_tile_new (app);
-		g_signal_connect (tile, "clicked",
-			  G_CALLBACK (app_tile_clicked), self);
-		gtk_container_add (GTK_CONTAINER (priv->box_recent), tile);
-	}
-	gtk_widget_set_visible (priv->box_recent, TRUE);
-	gtk_widget_set_visible (priv->recent_heading, TRUE);
+	gs_overview_page_set_tiles (self, priv->box_recent, priv->recent_heading, list);
+	gs_overview_page_snapshot_add (self, "recent", list, N_TILES);
 
 	priv->empty = FALSE;
 
@@ -277,48 +401,25 @@ gs_overview_page_category_more_cb (GtkButton *button, GsOverviewPage *self)
 }
 
 static void
-gs_overview_page_get_category_apps_cb (GObject *source_object,
-                                       GAsyncResult *res,
-                                       gpointer user_data)
+gs_overview_page_add_category_section (GsOverviewPage *self,
+				       const gchar *cat_id,
+				       const gchar *title,
+				       GsAppList *list)
 {
-	LoadData *load_data = (LoadData *) user_data;
-	GsOverviewPage *self = load_data->self;
 	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
-	guint i;
 	GsApp *app;
 	GtkWidget *box;
 	GtkWidget *button;
 	GtkWidget *headerbox;
 	GtkWidget *label;
 	GtkWidget *tile;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GsAppList) list = NULL;
-
-	/* get popular apps */
-	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
-	if (list == NULL) {
-		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			goto out;
-		g_warning ("failed to get category %s featured applications: %s",
-			   gs_category_get_id (load_data->category),
-			   error->message);
-		goto out;
-	} else if (gs_app_list_length (list) < N_TILES) {
-		g_warning ("hiding category %s featured applications: "
-			   "found only %u to show, need at least %d",
-			   gs_category_get_id (load_data->category),
-			   gs_app_list_length (list), N_TILES);
-		goto out;
-	}
-	gs_app_list_randomize (list);
 
 	/* add header */
 	headerbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 9);
 	gtk_widget_set_visible (headerbox, TRUE);
 
 	/* add label */
-	label = gtk_label_new (load_data->title);
+	label = gtk_label_new (title);
 	gtk_widget_set_visible (label, TRUE);
 	gtk_label_set_xalign (GTK_LABEL (label), 0.f);
 	gtk_widget_set_margin_top (label, 24);
@@ -333,7 +434,7 @@ gs_overview_page_get_category_apps_cb (GObject *source_object,
 	gtk_style_context_add_class (gtk_widget_get_style_context (button),
 				     "overview-more-button");
 	g_object_set_data_full (G_OBJECT (button), "GnomeSoftware::CategoryId",
-				g_strdup (gs_category_get_id (load_data->category)),
+				g_strdup (cat_id),
 				g_free);
 	gtk_widget_set_visible (button, TRUE);
 	gtk_widget_set_valign (button, GTK_ALIGN_END);
@@ -351,13 +452,84 @@ gs_overview_page_get_category_apps_cb (GObject *source_object,
 	gtk_container_add (GTK_CONTAINER (priv->box_popular_rotating), box);
 
 	/* add all the apps */
-	for (i = 0; i < gs_app_list_length (list) && i < N_TILES; i++) {
+	for (guint i = 0; i < gs_app_list_length (list) && i < N_TILES; i++) {
 		app = gs_app_list_index (list, i);
 		tile = gs_popular_tile_new (app);
 		g_signal_connect (tile, "clicked",
 			  G_CALLBACK (app_tile_clicked), self);
+		g_signal_connect (tile, "prefetch",
+			  G_CALLBACK (app_tile_prefetch), self);
 		gtk_container_add (GTK_CONTAINER (box), tile);
 	}
+}
+
+static void
+gs_overview_page_snapshot_add_category (GsOverviewPage *self,
+					const gchar *cat_id,
+					const gchar *title,
+					GsAppList *list)
+{
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+	gsize len = 0;
+	g_autofree gchar *group = NULL;
+	g_auto(GStrv) cat_ids = NULL;
+	g_autoptr(GPtrArray) cat_ids_new = g_ptr_array_new ();
+
+	if (priv->snapshot == NULL)
+		return;
+
+	/* keep the sections in the order they were shown */
+	cat_ids = g_key_file_get_string_list (priv->snapshot, "overview",
+					      "Categories", &len, NULL);
+	for (gsize i = 0; i < len; i++)
+		g_ptr_array_add (cat_ids_new, cat_ids[i]);
+	g_ptr_array_add (cat_ids_new, (gpointer) cat_id);
+	g_key_file_set_string_list (priv->snapshot, "overview", "Categories",
+				    (const gchar * const *) cat_ids_new->pdata,
+				    cat_ids_new->len);
+
+	group = g_strdup_printf ("category %s", cat_id);
+	if (title != NULL)
+		g_key_file_set_string (priv->snapshot, group, "Title", title);
+	gs_overview_page_snapshot_add (self, group, list, N_TILES);
+}
+
+static void
+gs_overview_page_get_category_apps_cb (GObject *source_object,
+                                       GAsyncResult *res,
+                                       gpointer user_data)
+{
+	LoadData *load_data = (LoadData *) user_data;
+	GsOverviewPage *self = load_data->self;
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
+	const gchar *cat_id = gs_category_get_id (load_data->category);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	/* get popular apps */
+	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
+	if (list == NULL) {
+		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
+			goto out;
+		g_warning ("failed to get category %s featured applications: %s",
+			   cat_id, error->message);
+		goto out;
+	} else if (gs_app_list_length (list) < N_TILES) {
+		g_warning ("hiding category %s featured applications: "
+			   "found only %u to show, need at least %d",
+			   cat_id, gs_app_list_length (list), N_TILES);
+		goto out;
+	}
+	gs_app_list_randomize (list);
+
+	/* replace the sections from the snapshot, if any */
+	if (priv->clear_popular_rotating) {
+		gs_container_remove_all (GTK_CONTAINER (priv->box_popular_rotating));
+		priv->clear_popular_rotating = FALSE;
+	}
+	gs_overview_page_add_category_section (self, cat_id, load_data->title, list);
+	gs_overview_page_snapshot_add_category (self, cat_id, load_data->title, list);
 
 	priv->empty = FALSE;
 
@@ -455,19 +627,9 @@ featured_switcher_clicked (GtkWidget *event_box, GdkEventButton *event, gpointer
 }
 
 static void
-gs_overview_page_get_featured_cb (GObject *source_object,
-                                  GAsyncResult *res,
-                                  gpointer user_data)
+gs_overview_page_set_featured (GsOverviewPage *self, GsAppList *list)
 {
-	GsOverviewPage *self = GS_OVERVIEW_PAGE (user_data);
 	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GsAppList) list = NULL;
-
-	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
-	if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-		goto out;
 
 	if (priv->featured_rotate_timer_id != 0) {
 		g_source_remove (priv->featured_rotate_timer_id);
@@ -478,23 +640,9 @@ gs_overview_page_get_featured_cb (GObject *source_object,
 	gs_container_remove_all (GTK_CONTAINER (priv->stack_featured));
 	gtk_widget_hide (priv->box_featured_switcher);
 	gs_container_remove_all (GTK_CONTAINER (priv->box_featured_switcher));
-	if (list == NULL) {
-		g_warning ("failed to get featured apps: %s",
-			   error->message);
-		goto out;
-	}
-	if (gs_app_list_length (list) == 0) {
-		g_warning ("failed to get featured apps: "
-			   "no apps to show");
-		goto out;
-	}
+	if (list == NULL || gs_app_list_length (list) == 0)
+		return;
 
-	if (g_getenv ("GNOME_SOFTWARE_FEATURED") == NULL) {
-		/* Don't show apps from the category that's currently featured as the category of the day */
-		gs_app_list_filter (list, filter_category, priv->category_of_day);
-		gs_app_list_filter_duplicates (list, GS_APP_LIST_FILTER_FLAG_KEY_ID);
-		gs_app_list_randomize (list);
-	}
 	for (guint i = 0; i < gs_app_list_length (list); i++) {
 		GsApp *app = gs_app_list_index (list, i);
 		GtkWidget *event_box;
@@ -504,6 +652,8 @@ gs_overview_page_get_featured_cb (GObject *source_object,
 		tile = gs_feature_tile_new (app);
 		g_signal_connect (tile, "clicked",
 				  G_CALLBACK (app_tile_clicked), self);
+		g_signal_connect (tile, "prefetch",
+				  G_CALLBACK (app_tile_prefetch), self);
 		gtk_container_add (GTK_CONTAINER (priv->stack_featured), tile);
 
 		event_box = gtk_event_box_new ();
@@ -522,8 +672,47 @@ gs_overview_page_get_featured_cb (GObject *source_object,
 
 	gtk_widget_set_visible (priv->box_featured_switcher, gs_app_list_length (list) > 1);
 
-	priv->empty = FALSE;
 	featured_reset_rotate_timer (self);
+}
+
+static void
+gs_overview_page_get_featured_cb (GObject *source_object,
+                                  GAsyncResult *res,
+                                  gpointer user_data)
+{
+	GsOverviewPage *self = GS_OVERVIEW_PAGE (user_data);
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
+	if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
+		goto out;
+
+	if (list == NULL) {
+		gs_overview_page_set_featured (self, NULL);
+		g_warning ("failed to get featured apps: %s",
+			   error->message);
+		goto out;
+	}
+	if (gs_app_list_length (list) == 0) {
+		gs_overview_page_set_featured (self, NULL);
+		g_warning ("failed to get featured apps: "
+			   "no apps to show");
+		goto out;
+	}
+
+	if (g_getenv ("GNOME_SOFTWARE_FEATURED") == NULL) {
+		/* Don't show apps from the category that's currently featured as the category of the day */
+		gs_app_list_filter (list, filter_category, priv->category_of_day);
+		gs_app_list_filter_duplicates (list, GS_APP_LIST_FILTER_FLAG_KEY_ID);
+		gs_app_list_randomize (list);
+	}
+	gs_overview_page_set_featured (self, list);
+	gs_overview_page_snapshot_add (self, "featured", list, G_MAXUINT);
+
+	priv->empty = FALSE;
 
 out:
 	gs_overview_page_decrement_action_cnt (self);
@@ -759,6 +948,11 @@ gs_overview_page_load (GsOverviewPage *self)
 	guint i;
 
 	priv->empty = TRUE;
+	if (priv->snapshot == NULL)
+		priv->snapshot = g_key_file_new ();
+
+	/* the app sections share one walk over the plugins and one refine */
+	gs_plugin_loader_batch_begin (priv->plugin_loader);
 
 	if (!priv->loading_featured) {
 		g_autoptr(GsPluginJob) plugin_job = NULL;
@@ -823,8 +1017,8 @@ gs_overview_page_load (GsOverviewPage *self)
 		g_autoptr(GPtrArray) cats_random = NULL;
 		cats_random = gs_overview_page_get_random_categories ();
 
-		/* remove existing widgets, if any */
-		gs_container_remove_all (GTK_CONTAINER (priv->box_popular_rotating));
+		/* remove existing widgets when the new ones arrive */
+		priv->clear_popular_rotating = TRUE;
 
 		/* load all the categories */
 		for (i = 0; i < cats_random->len && i < MAX_CATS; i++) {
@@ -864,6 +1058,7 @@ gs_overview_page_load (GsOverviewPage *self)
 		}
 		priv->loading_popular_rotating = TRUE;
 	}
+	gs_plugin_loader_batch_end (priv->plugin_loader, priv->cancellable);
 
 	if (!priv->loading_categories) {
 		g_autoptr(GsPluginJob) plugin_job = NULL;
@@ -879,6 +1074,216 @@ gs_overview_page_load (GsOverviewPage *self)
 	reload_third_party_repo (self);
 }
 
+static GdkPixbuf *
+gs_overview_page_snapshot_load_icon (GsOverviewPage *self, const gchar *icon_str)
+{
+	gint scale = gtk_widget_get_scale_factor (GTK_WIDGET (self));
+	GdkPixbuf *pixbuf = NULL;
+	g_autoptr(GIcon) icon = NULL;
+	g_autoptr(GError) error = NULL;
+
+	icon = g_icon_new_for_string (icon_str, &error);
+	if (icon == NULL) {
+		g_debug ("failed to parse snapshot icon %s: %s",
+			 icon_str, error->message);
+		return NULL;
+	}
+	if (G_IS_FILE_ICON (icon)) {
+		g_autofree gchar *filename = NULL;
+		filename = g_file_get_path (g_file_icon_get_file (G_FILE_ICON (icon)));
+		if (filename == NULL)
+			return NULL;
+		pixbuf = gdk_pixbuf_new_from_file_at_size (filename,
+							   64 * scale,
+							   64 * scale,
+							   &error);
+	} else if (G_IS_THEMED_ICON (icon)) {
+		const gchar * const *names = g_themed_icon_get_names (G_THEMED_ICON (icon));
+		pixbuf = gtk_icon_theme_load_icon_for_scale (gtk_icon_theme_get_default (),
+							     names[0], 64, scale,
+							     GTK_ICON_LOOKUP_FORCE_SIZE,
+							     &error);
+	}
+	if (pixbuf == NULL && error != NULL) {
+		g_debug ("failed to load snapshot icon %s: %s",
+			 icon_str, error->message);
+	}
+	return pixbuf;
+}
+
+static GsApp *
+gs_overview_page_snapshot_get_app (GsOverviewPage *self,
+				   GKeyFile *snapshot,
+				   const gchar *unique_id)
+{
+	g_autofree gchar *group = NULL;
+	g_autofree gchar *icon_str = NULL;
+	g_autofree gchar *name = NULL;
+	g_autofree gchar *state = NULL;
+	g_autofree gchar *summary = NULL;
+	g_autofree gchar *tmp = NULL;
+	g_autoptr(GsApp) app = NULL;
+	g_auto(GStrv) colors = NULL;
+
+	group = g_strdup_printf ("app %s", unique_id);
+	if (!g_key_file_has_group (snapshot, group))
+		return NULL;
+
+	/* just enough for the tiles, the details page refines the rest */
+	app = gs_app_new (NULL);
+	gs_app_set_from_unique_id (app, unique_id);
+	name = g_key_file_get_string (snapshot, group, "Name", NULL);
+	if (name != NULL)
+		gs_app_set_name (app, GS_APP_QUALITY_LOWEST, name);
+	summary = g_key_file_get_string (snapshot, group, "Summary", NULL);
+	if (summary != NULL)
+		gs_app_set_summary (app, GS_APP_QUALITY_LOWEST, summary);
+	state = g_key_file_get_string (snapshot, group, "State", NULL);
+	if (state != NULL)
+		gs_app_set_state (app, as_app_state_from_string (state));
+	if (g_key_file_has_key (snapshot, group, "Rating", NULL)) {
+		gs_app_set_rating (app, g_key_file_get_integer (snapshot, group,
+								"Rating", NULL));
+	}
+	colors = g_key_file_get_string_list (snapshot, group, "KeyColors", NULL, NULL);
+	for (guint i = 0; colors != NULL && colors[i] != NULL; i++) {
+		GdkRGBA rgba;
+		if (gdk_rgba_parse (&rgba, colors[i]))
+			gs_app_add_key_color (app, &rgba);
+	}
+	tmp = g_key_file_get_string (snapshot, group, "FeatureTileCss", NULL);
+	if (tmp != NULL)
+		gs_app_set_metadata (app, "GnomeSoftware::FeatureTile-css", tmp);
+	g_clear_pointer (&tmp, g_free);
+	tmp = g_key_file_get_string (snapshot, group, "PopularTileCss", NULL);
+	if (tmp != NULL)
+		gs_app_set_metadata (app, "GnomeSoftware::PopularTile-css", tmp);
+	icon_str = g_key_file_get_string (snapshot, group, "Icon", NULL);
+	if (icon_str != NULL) {
+		g_autoptr(GdkPixbuf) pixbuf = NULL;
+		pixbuf = gs_overview_page_snapshot_load_icon (self, icon_str);
+		if (pixbuf != NULL)
+			gs_app_set_pixbuf (app, pixbuf);
+	}
+	return g_steal_pointer (&app);
+}
+
+static GsAppList *
+gs_overview_page_snapshot_get_apps (GsOverviewPage *self,
+				    GKeyFile *snapshot,
+				    const gchar *group)
+{
+	GsAppList *list = gs_app_list_new ();
+	g_auto(GStrv) ids = NULL;
+
+	ids = g_key_file_get_string_list (snapshot, group, "Apps", NULL, NULL);
+	for (guint i = 0; ids != NULL && ids[i] != NULL; i++) {
+		g_autoptr(GsApp) app = NULL;
+		app = gs_overview_page_snapshot_get_app (self, snapshot, ids[i]);
+		if (app != NULL)
+			gs_app_list_add (list, app);
+	}
+	return list;
+}
+
+/* the snapshot apps are not backed by any plugin, so they cannot be shown
+ * or installed until the live results replace the tiles */
+static void
+gs_overview_page_set_children_insensitive (GtkWidget *container)
+{
+	g_autoptr(GList) children = NULL;
+
+	children = gtk_container_get_children (GTK_CONTAINER (container));
+	for (GList *l = children; l != NULL; l = l->next)
+		gtk_widget_set_sensitive (GTK_WIDGET (l->data), FALSE);
+}
+
+/**
+ * gs_overview_page_load_snapshot:
+ * @self: A #GsOverviewPage
+ *
+ * Shows the overview as it was last rendered, until the live results replace
+ * it when the page is next reloaded.
+ *
+ * Returns: %TRUE if a snapshot was shown
+ */
+gboolean
+gs_overview_page_load_snapshot (GsOverviewPage *self)
+{
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+	g_autofree gchar *filename = NULL;
+	g_auto(GStrv) cat_ids = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GKeyFile) snapshot = g_key_file_new ();
+	g_autoptr(GsAppList) featured = NULL;
+	g_autoptr(GsAppList) popular = NULL;
+	g_autoptr(GsAppList) recent = NULL;
+
+	g_return_val_if_fail (GS_IS_OVERVIEW_PAGE (self), FALSE);
+
+	/* already have something better */
+	if (priv->cache_valid || priv->action_cnt > 0)
+		return FALSE;
+
+	filename = gs_utils_get_cache_filename ("overview", "snapshot.ini",
+						GS_UTILS_CACHE_FLAG_WRITEABLE,
+						&error);
+	if (filename == NULL) {
+		g_warning ("failed to get overview snapshot filename: %s",
+			   error->message);
+		return FALSE;
+	}
+	if (!g_key_file_load_from_file (snapshot, filename, G_KEY_FILE_NONE, &error)) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			g_warning ("failed to load overview snapshot: %s", error->message);
+		return FALSE;
+	}
+
+	featured = gs_overview_page_snapshot_get_apps (self, snapshot, "featured");
+	popular = gs_overview_page_snapshot_get_apps (self, snapshot, "popular");
+	recent = gs_overview_page_snapshot_get_apps (self, snapshot, "recent");
+	gs_overview_page_set_featured (self, featured);
+	if (gs_app_list_length (popular) > 0) {
+		gs_overview_page_set_tiles (self, priv->box_popular,
+					    priv->popular_heading, popular);
+	}
+	if (gs_app_list_length (recent) > 0) {
+		gs_overview_page_set_tiles (self, priv->box_recent,
+					    priv->recent_heading, recent);
+	}
+	cat_ids = g_key_file_get_string_list (snapshot, "overview", "Categories",
+					      NULL, NULL);
+	for (guint i = 0; cat_ids != NULL && cat_ids[i] != NULL; i++) {
+		g_autofree gchar *group = g_strdup_printf ("category %s", cat_ids[i]);
+		g_autofree gchar *title = NULL;
+		g_autoptr(GsAppList) list = NULL;
+
+		list = gs_overview_page_snapshot_get_apps (self, snapshot, group);
+		if (gs_app_list_length (list) == 0)
+			continue;
+		title = g_key_file_get_string (snapshot, group, "Title", NULL);
+		gs_overview_page_add_category_section (self, cat_ids[i], title, list);
+	}
+
+	/* nothing usable */
+	if (gs_app_list_length (featured) == 0 &&
+	    gs_app_list_length (popular) == 0 &&
+	    gs_app_list_length (recent) == 0 &&
+	    (cat_ids == NULL || cat_ids[0] == NULL)) {
+		return FALSE;
+	}
+
+	g_debug ("showing overview snapshot from %s", filename);
+	gs_overview_page_set_children_insensitive (priv->stack_featured);
+	gs_overview_page_set_children_insensitive (priv->box_featured_switcher);
+	gs_overview_page_set_children_insensitive (priv->box_popular);
+	gs_overview_page_set_children_insensitive (priv->box_recent);
+	gs_overview_page_set_children_insensitive (priv->box_popular_rotating);
+	priv->showing_snapshot = TRUE;
+	gtk_stack_set_visible_child_name (GTK_STACK (priv->stack_overview), "overview");
+	return TRUE;
+}
+
 static void
 gs_overview_page_reload (GsPage *page)
 {
@@ -921,7 +1326,8 @@ gs_overview_page_switch_to (GsPage *page, gboolean scroll_up)
 
 	gs_grab_focus_when_mapped (priv->scrolledwindow_overview);
 
-	if (priv->cache_valid || priv->action_cnt > 0)
+	/* the snapshot is replaced once the metadata has been refreshed */
+	if (priv->cache_valid || priv->action_cnt > 0 || priv->showing_snapshot)
 		return;
 	gs_overview_page_load (self);
 }
@@ -979,6 +1385,19 @@ third_party_response_cb (GtkInfoBar *info_bar,
 	refresh_third_party_repo (self);
 }
 
+static gboolean
+gs_overview_page_draw_cb (GtkWidget *widget, cairo_t *cr, GsOverviewPage *self)
+{
+	GsOverviewPagePrivate *priv = gs_overview_page_get_instance_private (self);
+
+	/* only interested in the time to the first frame */
+	g_signal_handlers_disconnect_by_func (widget, gs_overview_page_draw_cb, self);
+	g_debug ("overview first painted from %s after %" G_GINT64_FORMAT "ms",
+		 priv->showing_snapshot ? "snapshot" : "live results",
+		 (g_get_monotonic_time () - priv->setup_time) / 1000);
+	return FALSE;
+}
+
 static gboolean
 gs_overview_page_setup (GsPage *page,
                         GsShell *shell,
@@ -996,6 +1415,7 @@ gs_overview_page_setup (GsPage *page,
 
 	g_return_val_if_fail (GS_IS_OVERVIEW_PAGE (self), TRUE);
 
+	priv->setup_time = g_get_monotonic_time ();
 	priv->plugin_loader = g_object_ref (plugin_loader);
 	priv->builder = g_object_ref (builder);
 	priv->cancellable = g_object_ref (cancellable);
@@ -1049,6 +1469,10 @@ gs_overview_page_setup (GsPage *page,
 			  G_CALLBACK (gs_overview_page_categories_expander_down_cb), self);
 	g_signal_connect (priv->categories_expander_button_up, "clicked",
 			  G_CALLBACK (gs_overview_page_categories_expander_up_cb), self);
+
+	/* for startup timing */
+	g_signal_connect (priv->box_overview, "draw",
+			  G_CALLBACK (gs_overview_page_draw_cb), self);
 	return TRUE;
 }
 
@@ -1077,6 +1501,8 @@ gs_overview_page_dispose (GObject *object)
 	g_clear_object (&priv->third_party_repo);
 	g_clear_pointer (&priv->category_of_day, g_free);
 	g_clear_pointer (&priv->category_hash, g_hash_table_unref);
+	g_clear_pointer (&priv->snapshot, g_key_file_unref);
+	g_clear_pointer (&priv->snapshot_last, g_key_file_unref);
 
 	if (priv->featured_rotate_timer_id != 0) {
 		g_source_remove (priv->featured_rotate_timer_id);
@@ -39,6 +39,8 @@ struct _GsOverviewPageClass
 };
 
 GsOverviewPage	*gs_overview_page_new		(void);
+gboolean	 gs_overview_page_load_snapshot	(GsOverviewPage		*self);
+void		 gs_overview_page_save_snapshot	(GsOverviewPage		*self);
 void		 gs_overview_page_set_category	(GsOverviewPage		*self,
 						 const gchar		*category);
 
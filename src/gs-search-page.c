@@ -31,6 +31,10 @@
 #include "gs-app-row.h"
 
 #define GS_SEARCH_PAGE_MAX_RESULTS	50
+#define GS_SEARCH_PAGE_MAX_IN_FLIGHT	2	/* searches */
+#define GS_SEARCH_PAGE_DEBOUNCE_MIN	50	/* ms */
+#define GS_SEARCH_PAGE_DEBOUNCE_MAX	400	/* ms */
+#define GS_SEARCH_PAGE_HISTOGRAM_SIZE	13	/* last bucket is >2s */
 
 struct _GsSearchPage
 {
@@ -39,7 +43,16 @@ struct _GsSearchPage
 	GsPluginLoader		*plugin_loader;
 	GtkBuilder		*builder;
 	GCancellable		*cancellable;
-	GCancellable		*search_cancellable;
+	GPtrArray		*in_flight;		/* of GsSearchPageHelper */
+	gboolean		 load_pending;
+	guint			 debounce_id;
+	gint64			 last_text_time;
+	gint64			 typing_interval;	/* ms */
+	gchar			*last_value;
+	GsAppList		*last_results;
+	gboolean		 showing_reused;
+	guint			 latency_histogram[GS_SEARCH_PAGE_HISTOGRAM_SIZE];
+	guint			 cancel_lag_histogram[GS_SEARCH_PAGE_HISTOGRAM_SIZE];
 	GtkSizeGroup		*sizegroup_image;
 	GtkSizeGroup		*sizegroup_name;
 	GtkSizeGroup		*sizegroup_desc;
@@ -58,6 +71,25 @@ struct _GsSearchPage
 
 G_DEFINE_TYPE (GsSearchPage, gs_search_page, GS_TYPE_PAGE)
 
+typedef struct {
+	GsSearchPage	*self;
+	gchar		*value;
+	GCancellable	*cancellable;
+	gint64		 start_time;
+	gint64		 cancel_time;
+} GsSearchPageHelper;
+
+static void
+gs_search_page_helper_free (GsSearchPageHelper *helper)
+{
+	g_object_unref (helper->self);
+	g_object_unref (helper->cancellable);
+	g_free (helper->value);
+	g_slice_free (GsSearchPageHelper, helper);
+}
+
+static void gs_search_page_load (GsSearchPage *self);
+
 static void
 gs_search_page_app_row_clicked_cb (GsAppRow *app_row,
                                    GsSearchPage *self)
@@ -89,47 +121,76 @@ gs_search_page_waiting_cancel (GsSearchPage *self)
 	self->waiting_id = 0;
 }
 
+/* bucket n counts the durations shorter than 2^n ms */
 static void
-gs_search_page_get_search_cb (GObject *source_object,
-                              GAsyncResult *res,
-                              gpointer user_data)
+gs_search_page_histogram_add (guint *histogram, gint64 duration_ms)
 {
-	guint i;
-	GsApp *app;
-	GsSearchPage *self = GS_SEARCH_PAGE (user_data);
-	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
-	GtkWidget *app_row;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GsAppList) list = NULL;
+	guint idx = g_bit_storage ((gulong) MAX (duration_ms, 0));
+	histogram[MIN (idx, GS_SEARCH_PAGE_HISTOGRAM_SIZE - 1)]++;
+}
 
-	/* don't do the delayed spinner */
-	gs_search_page_waiting_cancel (self);
+static gchar *
+gs_search_page_histogram_to_string (const guint *histogram)
+{
+	GString *str = g_string_new (NULL);
+	for (guint i = 0; i < GS_SEARCH_PAGE_HISTOGRAM_SIZE; i++) {
+		if (i == GS_SEARCH_PAGE_HISTOGRAM_SIZE - 1)
+			g_string_append_printf (str, "more:%u", histogram[i]);
+		else
+			g_string_append_printf (str, "<%ums:%u ", 1u << i, histogram[i]);
+	}
+	return g_string_free (str, FALSE);
+}
 
-	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
-	if (list == NULL) {
-		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
-			g_debug ("search cancelled");
-			return;
-		}
-		g_warning ("failed to get search apps: %s", error->message);
-		gs_stop_spinner (GTK_SPINNER (self->spinner_search));
-		gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "no-results");
-		return;
+static GVariant *
+gs_search_page_histogram_to_variant (const guint *histogram)
+{
+	return g_variant_new_fixed_array (G_VARIANT_TYPE_UINT32,
+					  histogram,
+					  GS_SEARCH_PAGE_HISTOGRAM_SIZE,
+					  sizeof (guint));
+}
+
+static void
+gs_search_page_helper_done (GsSearchPageHelper *helper)
+{
+	GsSearchPage *self = helper->self;
+	gint64 now = g_get_monotonic_time ();
+
+	/* plugins may carry on long after the search was cancelled */
+	if (helper->cancel_time != 0) {
+		gint64 lag = (now - helper->cancel_time) / 1000;
+		gs_search_page_histogram_add (self->cancel_lag_histogram, lag);
+		g_debug ("search for '%s' finished %" G_GINT64_FORMAT "ms after being cancelled",
+			 helper->value, lag);
+	} else {
+		gint64 latency = (now - helper->start_time) / 1000;
+		gs_search_page_histogram_add (self->latency_histogram, latency);
+		g_debug ("search for '%s' took %" G_GINT64_FORMAT "ms",
+			 helper->value, latency);
 	}
 
-	/* no results */
-	if (gs_app_list_length (list) == 0) {
-		g_debug ("no search results to show");
-		gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "no-results");
+	/* start the search that had to wait for a free slot */
+	if (self->in_flight == NULL)
 		return;
-	}
+	g_ptr_array_remove (self->in_flight, helper);
+	if (self->load_pending &&
+	    self->in_flight->len < GS_SEARCH_PAGE_MAX_IN_FLIGHT)
+		gs_search_page_load (self);
+}
+
+static void
+gs_search_page_show_results (GsSearchPage *self, GsAppList *list)
+{
+	GsApp *app;
+	GtkWidget *app_row;
 
 	/* remove old entries */
 	gs_container_remove_all (GTK_CONTAINER (self->list_box_search));
 
 	gs_stop_spinner (GTK_SPINNER (self->spinner_search));
 	gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "results");
-	for (i = 0; i < gs_app_list_length (list); i++) {
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
 		app = gs_app_list_index (list, i);
 		app_row = gs_app_row_new (app);
 		g_signal_connect (app_row, "button-clicked",
@@ -165,7 +226,62 @@ gs_search_page_get_search_cb (GObject *source_object,
 		gtk_style_context_add_class (context, GTK_STYLE_CLASS_DIM_LABEL);
 		gtk_container_add (GTK_CONTAINER (self->list_box_search), w);
 		gtk_widget_show (w);
-	} else {
+	}
+}
+
+static void
+gs_search_page_get_search_cb (GObject *source_object,
+                              GAsyncResult *res,
+                              gpointer user_data)
+{
+	GsSearchPageHelper *helper = (GsSearchPageHelper *) user_data;
+	GsSearchPage *self = helper->self;
+	GsPluginLoader *plugin_loader = GS_PLUGIN_LOADER (source_object);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsAppList) list = NULL;
+
+	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
+	if (list == NULL) {
+		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
+			g_debug ("search cancelled");
+			goto out;
+		}
+		gs_search_page_waiting_cancel (self);
+		self->showing_reused = FALSE;
+		g_warning ("failed to get search apps: %s", error->message);
+		gs_stop_spinner (GTK_SPINNER (self->spinner_search));
+		gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "no-results");
+		goto out;
+	}
+
+	/* the plugins did not notice the cancellation */
+	if (g_cancellable_is_cancelled (helper->cancellable)) {
+		g_debug ("ignoring results of cancelled search for '%s'",
+			 helper->value);
+		goto out;
+	}
+
+	/* don't do the delayed spinner */
+	gs_search_page_waiting_cancel (self);
+	self->showing_reused = FALSE;
+
+	/* a longer query can be answered from these while it is searched */
+	g_clear_pointer (&self->last_value, g_free);
+	g_clear_object (&self->last_results);
+	if (!gs_app_list_has_flag (list, GS_APP_LIST_FLAG_IS_TRUNCATED)) {
+		self->last_value = g_strdup (helper->value);
+		self->last_results = g_object_ref (list);
+	}
+
+	/* no results */
+	if (gs_app_list_length (list) == 0) {
+		g_debug ("no search results to show");
+		gtk_stack_set_visible_child_name (GTK_STACK (self->stack_search), "no-results");
+		goto out;
+	}
+
+	gs_search_page_show_results (self, list);
+	if (!gs_app_list_has_flag (list, GS_APP_LIST_FLAG_IS_TRUNCATED)) {
 		/* reset to default */
 		self->max_results = GS_SEARCH_PAGE_MAX_RESULTS;
 	}
@@ -181,6 +297,9 @@ gs_search_page_get_search_cb (GObject *source_object,
 		gs_shell_show_app (self->shell, a);
 		g_clear_pointer (&self->appid_to_show, g_free);
 	}
+out:
+	gs_search_page_helper_done (helper);
+	gs_search_page_helper_free (helper);
 }
 
 static gboolean
@@ -195,67 +314,105 @@ gs_search_page_waiting_show_cb (gpointer user_data)
 	return FALSE;
 }
 
-static gchar *
-gs_search_page_get_app_sort_key (GsApp *app)
+static guint
+gs_search_page_get_app_sort_rank (GsApp *app)
 {
-	GString *key = g_string_sized_new (64);
+	guint rank = 0;
 
 	/* sort apps before runtimes and extensions */
 	switch (gs_app_get_kind (app)) {
 	case AS_APP_KIND_DESKTOP:
 	case AS_APP_KIND_SHELL_EXTENSION:
-		g_string_append (key, "9:");
+		rank |= 1 << 1;
 		break;
 	default:
-		g_string_append (key, "1:");
 		break;
 	}
 
 	/* sort missing codecs before applications */
-	switch (gs_app_get_state (app)) {
-	case AS_APP_STATE_UNAVAILABLE:
-		g_string_append (key, "9:");
-		break;
-	default:
-		g_string_append (key, "1:");
-		break;
-	}
+	if (gs_app_get_state (app) == AS_APP_STATE_UNAVAILABLE)
+		rank |= 1 << 0;
+
+	return rank;
+}
+
+static gboolean
+gs_search_page_sort_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+{
+	guint rank1 = gs_search_page_get_app_sort_rank (app1);
+	guint rank2 = gs_search_page_get_app_sort_rank (app2);
+
+	/* highest rank first */
+	if (rank1 != rank2)
+		return rank1 < rank2 ? 1 : -1;
 
 	/* sort by the search key */
-	g_string_append_printf (key, "%05x:", gs_app_get_match_value (app));
+	if (gs_app_get_match_value (app1) != gs_app_get_match_value (app2))
+		return gs_app_get_match_value (app1) < gs_app_get_match_value (app2) ? 1 : -1;
 
 	/* sort by rating */
-	g_string_append_printf (key, "%03i:", gs_app_get_rating (app));
+	if (gs_app_get_rating (app1) != gs_app_get_rating (app2))
+		return gs_app_get_rating (app1) < gs_app_get_rating (app2) ? 1 : -1;
 
 	/* sort by kudos */
-	g_string_append_printf (key, "%03u:", gs_app_get_kudos_percentage (app));
+	if (gs_app_get_kudos_percentage (app1) != gs_app_get_kudos_percentage (app2))
+		return gs_app_get_kudos_percentage (app1) < gs_app_get_kudos_percentage (app2) ? 1 : -1;
 
-	return g_string_free (key, FALSE);
+	return 0;
 }
 
-static gboolean
-gs_search_page_sort_cb (GsApp *app1, GsApp *app2, gpointer user_data)
+static void
+gs_search_page_cancel_in_flight (GsSearchPage *self)
 {
-	g_autofree gchar *key1 = NULL;
-	g_autofree gchar *key2 = NULL;
-	key1 = gs_search_page_get_app_sort_key (app1);
-	key2 = gs_search_page_get_app_sort_key (app2);
-	return g_strcmp0 (key2, key1);
+	gint64 now = g_get_monotonic_time ();
+
+	for (guint i = 0; i < self->in_flight->len; i++) {
+		GsSearchPageHelper *helper = g_ptr_array_index (self->in_flight, i);
+		if (helper->cancel_time == 0)
+			helper->cancel_time = now;
+		g_cancellable_cancel (helper->cancellable);
+	}
+}
+
+static void
+gs_search_page_debounce_cancel (GsSearchPage *self)
+{
+	if (self->debounce_id != 0)
+		g_source_remove (self->debounce_id);
+	self->debounce_id = 0;
 }
 
 static void
 gs_search_page_load (GsSearchPage *self)
 {
+	GsSearchPageHelper *helper;
 	g_autoptr(GsPluginJob) plugin_job = NULL;
 
 	/* cancel any pending searches */
-	g_cancellable_cancel (self->search_cancellable);
-	g_clear_object (&self->search_cancellable);
-	self->search_cancellable = g_cancellable_new ();
+	gs_search_page_debounce_cancel (self);
+	gs_search_page_cancel_in_flight (self);
 
-	/* search for apps */
+	/* keep showing the reused results rather than the spinner */
 	gs_search_page_waiting_cancel (self);
-	self->waiting_id = g_timeout_add (250, gs_search_page_waiting_show_cb, self);
+	if (!self->showing_reused)
+		self->waiting_id = g_timeout_add (250, gs_search_page_waiting_show_cb, self);
+
+	/* some plugins ignore cancellation, so don't pile up more work */
+	if (self->in_flight->len >= GS_SEARCH_PAGE_MAX_IN_FLIGHT) {
+		g_debug ("%u searches still running, deferring search for '%s'",
+			 self->in_flight->len, self->value);
+		self->load_pending = TRUE;
+		return;
+	}
+	self->load_pending = FALSE;
+
+	/* search for apps */
+	helper = g_slice_new0 (GsSearchPageHelper);
+	helper->self = g_object_ref (self);
+	helper->value = g_strdup (self->value);
+	helper->cancellable = g_cancellable_new ();
+	helper->start_time = g_get_monotonic_time ();
+	g_ptr_array_add (self->in_flight, helper);
 	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_SEARCH,
 					 "search", self->value,
 					 "max-results", self->max_results,
@@ -275,9 +432,66 @@ gs_search_page_load (GsSearchPage *self)
 	gs_plugin_job_set_sort_func (plugin_job, gs_search_page_sort_cb);
 	gs_plugin_job_set_sort_func_data (plugin_job, self);
 	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job,
-					    self->search_cancellable,
+					    helper->cancellable,
 					    gs_search_page_get_search_cb,
-					    self);
+					    helper);
+}
+
+static gboolean
+gs_search_page_debounce_cb (gpointer user_data)
+{
+	GsSearchPage *self = GS_SEARCH_PAGE (user_data);
+	self->debounce_id = 0;
+	gs_search_page_load (self);
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+gs_search_page_app_matches_cb (GsApp *app, gpointer user_data)
+{
+	gchar **tokens = (gchar **) user_data;
+	g_autofree gchar *haystack = NULL;
+	g_autoptr(GString) str = g_string_new (NULL);
+
+	if (gs_app_get_id (app) != NULL)
+		g_string_append_printf (str, "%s ", gs_app_get_id (app));
+	if (gs_app_get_name (app) != NULL)
+		g_string_append_printf (str, "%s ", gs_app_get_name (app));
+	if (gs_app_get_summary (app) != NULL)
+		g_string_append (str, gs_app_get_summary (app));
+	haystack = g_utf8_casefold (str->str, -1);
+	for (guint i = 0; tokens[i] != NULL; i++) {
+		if (strstr (haystack, tokens[i]) == NULL)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/* a longer query can only match fewer apps, so show the ones from the last
+ * results that still match while the real search runs */
+static void
+gs_search_page_reuse_results (GsSearchPage *self)
+{
+	g_autoptr(GsAppList) list = NULL;
+	g_auto(GStrv) tokens = NULL;
+
+	self->showing_reused = FALSE;
+	if (self->last_value == NULL || self->last_results == NULL)
+		return;
+	if (!g_str_has_prefix (self->value, self->last_value))
+		return;
+	tokens = g_str_tokenize_and_fold (self->value, NULL, NULL);
+	if (tokens == NULL || tokens[0] == NULL)
+		return;
+	list = gs_app_list_copy (self->last_results);
+	gs_app_list_filter (list, gs_search_page_app_matches_cb, tokens);
+	if (gs_app_list_length (list) == 0)
+		return;
+	g_debug ("reusing %u results of '%s' for '%s'",
+		 gs_app_list_length (list), self->last_value, self->value);
+	gs_search_page_waiting_cancel (self);
+	gs_search_page_show_results (self, list);
+	self->showing_reused = TRUE;
 }
 
 static void
@@ -324,9 +538,27 @@ gs_search_page_get_text (GsSearchPage *self)
 	return self->value;
 }
 
+/* element n counts the searches that took less than 2^n ms, and the last
+ * one counts all the slower ones */
+GVariant *
+gs_search_page_get_stats (GsSearchPage *self)
+{
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add (&builder, "{sv}", "latency",
+			       gs_search_page_histogram_to_variant (self->latency_histogram));
+	g_variant_builder_add (&builder, "{sv}", "cancellation-lag",
+			       gs_search_page_histogram_to_variant (self->cancel_lag_histogram));
+	return g_variant_builder_end (&builder);
+}
+
 void
 gs_search_page_set_text (GsSearchPage *self, const gchar *value)
 {
+	gint64 delay;
+	gint64 now;
+
 	if (value == self->value)
 		return;
 	if (g_strcmp0 (value, self->value) == 0)
@@ -335,7 +567,21 @@ gs_search_page_set_text (GsSearchPage *self, const gchar *value)
 	g_free (self->value);
 	self->value = g_strdup (value);
 
-	gs_search_page_load (self);
+	/* wait for longer when the user is typing quickly */
+	now = g_get_monotonic_time ();
+	if (self->last_text_time != 0) {
+		gint64 interval = (now - self->last_text_time) / 1000;
+		interval = MIN (interval, GS_SEARCH_PAGE_DEBOUNCE_MAX);
+		self->typing_interval = (self->typing_interval * 3 + interval) / 4;
+	}
+	self->last_text_time = now;
+	delay = CLAMP (self->typing_interval * 3 / 2,
+		       GS_SEARCH_PAGE_DEBOUNCE_MIN,
+		       GS_SEARCH_PAGE_DEBOUNCE_MAX);
+
+	gs_search_page_reuse_results (self);
+	gs_search_page_debounce_cancel (self);
+	self->debounce_id = g_timeout_add ((guint) delay, gs_search_page_debounce_cb, self);
 }
 
 static void
@@ -396,7 +642,7 @@ static void
 gs_search_page_cancel_cb (GCancellable *cancellable,
                           GsSearchPage *self)
 {
-	g_cancellable_cancel (self->search_cancellable);
+	gs_search_page_cancel_in_flight (self);
 }
 
 static void
@@ -455,7 +701,22 @@ gs_search_page_dispose (GObject *object)
 	g_clear_object (&self->builder);
 	g_clear_object (&self->plugin_loader);
 	g_clear_object (&self->cancellable);
-	g_clear_object (&self->search_cancellable);
+	g_clear_object (&self->last_results);
+
+	gs_search_page_waiting_cancel (self);
+	gs_search_page_debounce_cancel (self);
+	if (self->in_flight != NULL) {
+		g_autofree gchar *latency = NULL;
+		g_autofree gchar *cancel_lag = NULL;
+
+		gs_search_page_cancel_in_flight (self);
+		g_clear_pointer (&self->in_flight, g_ptr_array_unref);
+
+		latency = gs_search_page_histogram_to_string (self->latency_histogram);
+		cancel_lag = gs_search_page_histogram_to_string (self->cancel_lag_histogram);
+		g_debug ("search latency: %s", latency);
+		g_debug ("search cancellation lag: %s", cancel_lag);
+	}
 
 	G_OBJECT_CLASS (gs_search_page_parent_class)->dispose (object);
 }
@@ -467,6 +728,7 @@ gs_search_page_finalize (GObject *object)
 
 	g_free (self->appid_to_show);
 	g_free (self->value);
+	g_free (self->last_value);
 
 	G_OBJECT_CLASS (gs_search_page_parent_class)->finalize (object);
 }
@@ -505,6 +767,7 @@ gs_search_page_init (GsSearchPage *self)
 	self->sizegroup_button = gtk_size_group_new (GTK_SIZE_GROUP_HORIZONTAL);
 
 	self->max_results = GS_SEARCH_PAGE_MAX_RESULTS;
+	self->in_flight = g_ptr_array_new ();
 }
 
 GsSearchPage *
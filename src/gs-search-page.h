@@ -37,6 +37,7 @@ void		 gs_search_page_set_appid_to_show	(GsSearchPage		*self,
 const gchar	*gs_search_page_get_text		(GsSearchPage		*self);
 void		 gs_search_page_set_text		(GsSearchPage		*self,
 							 const gchar		*value);
+GVariant	*gs_search_page_get_stats		(GsSearchPage		*self);
 
 G_END_DECLS
 
@@ -23,6 +23,8 @@
 
 #include "gnome-software-private.h"
 
+#include "gs-app-prefetcher.h"
+#include "gs-common.h"
 #include "gs-css.h"
 #include "gs-test.h"
 
@@ -53,17 +55,196 @@ gs_css_func (void)
 	g_assert_cmpstr (tmp, ==, "color: white;");
 }
 
+static GsApp *
+gs_self_test_fuzzy_app_new (const gchar *id, const gchar *name, const gchar *hostname)
+{
+	GsApp *app = gs_app_new (id);
+	gs_app_set_name (app, GS_APP_QUALITY_NORMAL, name);
+	gs_app_set_origin (app, hostname);
+	gs_app_set_origin_hostname (app, hostname);
+	return app;
+}
+
+static void
+gs_common_fuzzy_index_func (void)
+{
+	g_autoptr(GsAppList) list = gs_app_list_new ();
+	g_autoptr(GHashTable) fuzzy_index = NULL;
+	GsApp *app;
+
+	/* same ID from two sources */
+	app = gs_self_test_fuzzy_app_new ("a.desktop", "A", "example.com");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_self_test_fuzzy_app_new ("a.desktop", "A", "example.org");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+
+	/* same name, different ID */
+	app = gs_self_test_fuzzy_app_new ("b1.desktop", "B", "example.com");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_self_test_fuzzy_app_new ("b2.desktop", "B", "example.org");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+
+	/* unique */
+	app = gs_self_test_fuzzy_app_new ("c.desktop", "C", "example.com");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+
+	/* two copies from the same source */
+	app = gs_self_test_fuzzy_app_new ("d.desktop", "D", "example.com");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+	app = gs_self_test_fuzzy_app_new ("d.desktop", "D", "example.com");
+	gs_app_set_branch (app, "stable");
+	gs_app_list_add (list, app);
+	g_object_unref (app);
+
+	/* the index agrees with the linear scan */
+	fuzzy_index = gs_utils_list_fuzzy_index_new (list);
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
+		app = gs_app_list_index (list, i);
+		g_assert_cmpint (gs_utils_fuzzy_index_has_app (fuzzy_index, app), ==,
+				 gs_utils_list_has_app_fuzzy (list, app));
+	}
+	g_assert_true (gs_utils_fuzzy_index_has_app (fuzzy_index, gs_app_list_index (list, 0)));
+	g_assert_true (gs_utils_fuzzy_index_has_app (fuzzy_index, gs_app_list_index (list, 2)));
+	g_assert_false (gs_utils_fuzzy_index_has_app (fuzzy_index, gs_app_list_index (list, 4)));
+	g_assert_false (gs_utils_fuzzy_index_has_app (fuzzy_index, gs_app_list_index (list, 5)));
+}
+
+static void
+gs_common_icon_cache_func (void)
+{
+	g_autofree gchar *cachedir = NULL;
+	g_autoptr(GdkPixbuf) pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 16, 16);
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GIcon) icon = NULL;
+	g_autoptr(GsApp) app = gs_app_new ("chiron.desktop");
+
+	cachedir = g_build_filename (g_getenv ("GS_SELF_TEST_CACHEDIR"), "icon-cache", NULL);
+	g_assert_cmpint (g_mkdir_with_parents (cachedir, 0755), ==, 0);
+
+	/* an icon only in memory is saved to the cache */
+	gdk_pixbuf_fill (pixbuf, 0xff0000ff);
+	gs_app_set_pixbuf (app, pixbuf);
+	icon = gs_utils_get_app_icon_ref (app, "icon-cache");
+	g_assert_true (G_IS_FILE_ICON (icon));
+	file = g_object_ref (g_file_icon_get_file (G_FILE_ICON (icon)));
+	g_assert_true (g_file_query_exists (file, NULL));
+
+	/* recently used icons are kept, old ones deleted */
+	gs_utils_prune_icon_cache ("icon-cache", 60);
+	g_assert_true (g_file_query_exists (file, NULL));
+	gs_utils_prune_icon_cache ("icon-cache", 0);
+	g_assert_false (g_file_query_exists (file, NULL));
+}
+
+static void
+gs_app_prefetcher_claim_cb (GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	gint *claimed = (gint *) user_data;
+	g_autoptr(GError) error = NULL;
+
+	*claimed = gs_app_prefetcher_claim_app_finish (GS_APP_PREFETCHER (source), res, &error);
+	g_assert_no_error (error);
+}
+
+static gint
+gs_app_prefetcher_test_claim (GsAppPrefetcher *prefetcher, GsApp *app)
+{
+	gint claimed = -1;
+
+	gs_app_prefetcher_claim_app_async (prefetcher, app, NULL,
+					   gs_app_prefetcher_claim_cb, &claimed);
+	while (claimed < 0)
+		g_main_context_iteration (NULL, TRUE);
+	return claimed;
+}
+
+static void
+gs_app_prefetcher_test_wait (GsAppPrefetcher *prefetcher, GsApp *app)
+{
+	while (!gs_app_prefetcher_has_app (prefetcher, app))
+		g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+gs_app_prefetcher_func (GsPluginLoader *plugin_loader)
+{
+	g_autoptr(GsApp) app1 = gs_app_new ("chiron.desktop");
+	g_autoptr(GsApp) app2 = gs_app_new ("zeus.desktop");
+	g_autoptr(GsAppPrefetcher) prefetcher = gs_app_prefetcher_new (plugin_loader);
+
+	gs_app_set_management_plugin (app1, "dummy");
+	gs_app_set_management_plugin (app2, "dummy");
+
+	/* nothing prefetched, so the caller has to refine it */
+	g_assert_cmpint (gs_app_prefetcher_test_claim (prefetcher, app1), ==, FALSE);
+
+	/* a prefetched app can only be claimed once */
+	gs_app_prefetcher_add_app (prefetcher, app1);
+	gs_app_prefetcher_test_wait (prefetcher, app1);
+	g_assert_cmpint (gs_app_get_kind (app1), ==, AS_APP_KIND_DESKTOP);
+	g_assert_cmpint (gs_app_get_state (app1), ==, AS_APP_STATE_AVAILABLE);
+	g_assert_cmpint (gs_app_prefetcher_test_claim (prefetcher, app1), ==, TRUE);
+	g_assert_false (gs_app_prefetcher_has_app (prefetcher, app1));
+	g_assert_cmpint (gs_app_prefetcher_test_claim (prefetcher, app1), ==, FALSE);
+
+	/* installing the app makes the prefetched details stale */
+	gs_app_prefetcher_add_app (prefetcher, app1);
+	gs_app_prefetcher_test_wait (prefetcher, app1);
+	gs_app_set_state (app1, AS_APP_STATE_INSTALLING);
+	gs_test_flush_main_context ();
+	g_assert_false (gs_app_prefetcher_has_app (prefetcher, app1));
+
+	/* a prefetch that is still running is joined rather than repeated */
+	gs_app_prefetcher_add_app (prefetcher, app2);
+	g_assert_false (gs_app_prefetcher_has_app (prefetcher, app2));
+	g_assert_cmpint (gs_app_prefetcher_test_claim (prefetcher, app2), ==, TRUE);
+	g_assert_cmpint (gs_app_get_state (app2), ==, AS_APP_STATE_AVAILABLE);
+	g_assert_false (gs_app_prefetcher_has_app (prefetcher, app2));
+}
+
 int
 main (int argc, char **argv)
 {
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GsPluginLoader) plugin_loader = NULL;
+	const gchar *whitelist[] = {
+		"dummy",
+		NULL
+	};
+
 	g_test_init (&argc, &argv, NULL);
 	g_setenv ("G_MESSAGES_DEBUG", "all", TRUE);
+	g_setenv ("GS_SELF_TEST_DUMMY_ENABLE", "1", TRUE);
+	g_setenv ("GS_SELF_TEST_CACHEDIR", "/var/tmp/self-test", TRUE);
 
 	/* only critical and error are fatal */
 	g_log_set_fatal_mask (NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
 
+	/* the prefetcher needs something to refine the apps */
+	plugin_loader = gs_plugin_loader_new ();
+	gs_plugin_loader_add_location (plugin_loader, LOCALPLUGINDIR);
+	ret = gs_plugin_loader_setup (plugin_loader,
+				      (gchar**) whitelist,
+				      NULL,
+				      NULL,
+				      &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
 	/* tests go here */
 	g_test_add_func ("/gnome-software/src/css", gs_css_func);
+	g_test_add_func ("/gnome-software/src/common{fuzzy-index}", gs_common_fuzzy_index_func);
+	g_test_add_func ("/gnome-software/src/common{icon-cache}", gs_common_icon_cache_func);
+	g_test_add_data_func ("/gnome-software/src/app-prefetcher",
+			      plugin_loader,
+			      (GTestDataFunc) gs_app_prefetcher_func);
 
 	return g_test_run ();
 }
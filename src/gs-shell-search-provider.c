@@ -32,6 +32,7 @@
 #include "gs-common.h"
 
 #define GS_SHELL_SEARCH_PROVIDER_MAX_RESULTS	20
+#define GS_SHELL_SEARCH_PROVIDER_ICON_AGE_MAX	(60 * 60 * 24 * 30)	/* s */
 
 typedef struct {
 	GsShellSearchProvider *provider;
@@ -112,48 +113,42 @@ search_done_cb (GObject *source,
 	g_application_release (g_application_get_default ());
 }
 
-static gchar *
-gs_shell_search_provider_get_app_sort_key (GsApp *app)
+static guint
+gs_shell_search_provider_get_app_sort_rank (GsApp *app)
 {
-	GString *key = g_string_sized_new (64);
+	guint rank = 0;
 
 	/* sort available apps before installed ones */
-	switch (gs_app_get_state (app)) {
-	case AS_APP_STATE_AVAILABLE:
-		g_string_append (key, "9:");
-		break;
-	default:
-		g_string_append (key, "1:");
-		break;
-	}
+	if (gs_app_get_state (app) == AS_APP_STATE_AVAILABLE)
+		rank |= 1 << 1;
 
 	/* sort apps before runtimes and extensions */
-	switch (gs_app_get_kind (app)) {
-	case AS_APP_KIND_DESKTOP:
-		g_string_append (key, "9:");
-		break;
-	default:
-		g_string_append (key, "1:");
-		break;
-	}
-
-	/* sort by the search key */
-	g_string_append_printf (key, "%05x:", gs_app_get_match_value (app));
+	if (gs_app_get_kind (app) == AS_APP_KIND_DESKTOP)
+		rank |= 1 << 0;
 
-	/* tie-break with id */
-	g_string_append (key, gs_app_get_unique_id (app));
-
-	return g_string_free (key, FALSE);
+	return rank;
 }
 
 static gboolean
 gs_shell_search_provider_sort_cb (GsApp *app1, GsApp *app2, gpointer user_data)
 {
-	g_autofree gchar *key1 = NULL;
-	g_autofree gchar *key2 = NULL;
-	key1 = gs_shell_search_provider_get_app_sort_key (app1);
-	key2 = gs_shell_search_provider_get_app_sort_key (app2);
-	return g_strcmp0 (key2, key1);
+	guint rank1 = gs_shell_search_provider_get_app_sort_rank (app1);
+	guint rank2 = gs_shell_search_provider_get_app_sort_rank (app2);
+	guint match1, match2;
+
+	/* highest rank first */
+	if (rank1 != rank2)
+		return rank1 < rank2 ? 1 : -1;
+
+	/* sort by the search key */
+	match1 = gs_app_get_match_value (app1);
+	match2 = gs_app_get_match_value (app2);
+	if (match1 != match2)
+		return match1 < match2 ? 1 : -1;
+
+	/* tie-break with id */
+	return g_strcmp0 (gs_app_get_unique_id (app2),
+			  gs_app_get_unique_id (app1));
 }
 
 static void
@@ -227,6 +222,16 @@ handle_get_subsearch_result_set (GsShellSearchProvider2	*skeleton,
 	return TRUE;
 }
 
+/* send the icon by reference rather than the pixel data */
+static GVariant *
+gs_shell_search_provider_get_icon (GsApp *app)
+{
+	g_autoptr(GIcon) icon = gs_utils_get_app_icon_ref (app, "search-provider");
+	if (icon == NULL)
+		return NULL;
+	return g_icon_serialize (icon);
+}
+
 static gboolean
 handle_get_result_metas (GsShellSearchProvider2	*skeleton,
 			 GDBusMethodInvocation	 *invocation,
@@ -236,14 +241,15 @@ handle_get_result_metas (GsShellSearchProvider2	*skeleton,
 	GsShellSearchProvider *self = user_data;
 	GVariantBuilder meta;
 	GVariant *meta_variant;
-	GdkPixbuf *pixbuf;
 	gint i;
 	GVariantBuilder builder;
+	g_autoptr(GHashTable) fuzzy_index = NULL;
 
 	g_debug ("****** GetResultMetas");
 
 	for (i = 0; results[i]; i++) {
 		GsApp *app;
+		GVariant *icon;
 		g_autofree gchar *description = NULL;
 
 		/* already built */
@@ -260,11 +266,13 @@ handle_get_result_metas (GsShellSearchProvider2	*skeleton,
 		g_variant_builder_init (&meta, G_VARIANT_TYPE ("a{sv}"));
 		g_variant_builder_add (&meta, "{sv}", "id", g_variant_new_string (gs_app_get_unique_id (app)));
 		g_variant_builder_add (&meta, "{sv}", "name", g_variant_new_string (gs_app_get_name (app)));
-		pixbuf = gs_app_get_pixbuf (app);
-		if (pixbuf != NULL)
-			g_variant_builder_add (&meta, "{sv}", "icon", g_icon_serialize (G_ICON (pixbuf)));
+		icon = gs_shell_search_provider_get_icon (app);
+		if (icon != NULL)
+			g_variant_builder_add (&meta, "{sv}", "icon", icon);
 
-		if (gs_utils_list_has_app_fuzzy (self->search_results, app) &&
+		if (fuzzy_index == NULL)
+			fuzzy_index = gs_utils_list_fuzzy_index_new (self->search_results);
+		if (gs_utils_fuzzy_index_has_app (fuzzy_index, app) &&
 		    gs_app_get_origin_hostname (app) != NULL) {
 			/* TRANSLATORS: this refers to where the app came from */
 			g_autofree gchar *source_text = g_strdup_printf (_("Source: %s"),
@@ -412,4 +420,7 @@ gs_shell_search_provider_setup (GsShellSearchProvider *provider,
 				GsPluginLoader *loader)
 {
 	provider->plugin_loader = g_object_ref (loader);
+
+	/* the shell asks for the icons again each time they are shown */
+	gs_utils_prune_icon_cache ("search-provider", GS_SHELL_SEARCH_PROVIDER_ICON_AGE_MAX);
 }
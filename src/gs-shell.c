@@ -69,6 +69,7 @@ typedef struct
 	gboolean		 ignore_primary_buttons;
 	GCancellable		*cancellable;
 	GsPluginLoader		*plugin_loader;
+	GsAppPrefetcher		*prefetcher;
 	GsShellMode		 mode;
 	GHashTable		*pages;
 	GtkWidget		*header_start_widget;
@@ -80,6 +81,7 @@ typedef struct
 	gulong			 search_changed_id;
 	gchar			*events_info_uri;
 	gboolean		 in_mode_change;
+	gboolean		 showing_snapshot;
 	GsPage			*page;
 	GSimpleActionGroup	*auth_actions;
 } GsShellPrivate;
@@ -136,6 +138,30 @@ gs_shell_is_active (GsShell *shell)
 	return gtk_window_is_active (priv->main_window);
 }
 
+void
+gs_shell_prefetch_app (GsShell *shell, GsApp *app)
+{
+	GsShellPrivate *priv = gs_shell_get_instance_private (shell);
+	if (priv->prefetcher == NULL)
+		return;
+	gs_app_prefetcher_add_app (priv->prefetcher, app);
+}
+
+GsAppPrefetcher *
+gs_shell_get_prefetcher (GsShell *shell)
+{
+	GsShellPrivate *priv = gs_shell_get_instance_private (shell);
+	return priv->prefetcher;
+}
+
+void
+gs_shell_save_snapshot (GsShell *shell)
+{
+	GsShellPrivate *priv = gs_shell_get_instance_private (shell);
+	GsPage *page = GS_PAGE (gtk_builder_get_object (priv->builder, "overview_page"));
+	gs_overview_page_save_snapshot (GS_OVERVIEW_PAGE (page));
+}
+
 GtkWindow *
 gs_shell_get_window (GsShell *shell)
 {
@@ -143,6 +169,14 @@ gs_shell_get_window (GsShell *shell)
 	return priv->main_window;
 }
 
+GVariant *
+gs_shell_get_search_stats (GsShell *shell)
+{
+	GsShellPrivate *priv = gs_shell_get_instance_private (shell);
+	GsPage *page = GS_PAGE (g_hash_table_lookup (priv->pages, "search"));
+	return gs_search_page_get_stats (GS_SEARCH_PAGE (page));
+}
+
 void
 gs_shell_activate (GsShell *shell)
 {
@@ -553,6 +587,14 @@ initial_refresh_done (GsLoadingPage *loading_page, gpointer data)
 
 	g_signal_emit (shell, signals[SIGNAL_LOADED], 0);
 
+	/* replace the snapshot with the live overview */
+	if (priv->showing_snapshot) {
+		priv->showing_snapshot = FALSE;
+		page = GS_PAGE (gtk_builder_get_object (priv->builder, "overview_page"));
+		gs_page_reload (page);
+		return;
+	}
+
 	/* go to OVERVIEW, unless the "loading" callbacks changed mode already */
 	if (priv->mode == GS_SHELL_MODE_LOADING)
 		gs_shell_change_mode (shell, GS_SHELL_MODE_OVERVIEW, NULL, TRUE);
@@ -792,6 +834,9 @@ gs_shell_reload_cb (GsPluginLoader *plugin_loader, GsShell *shell)
 {
 	GsShellPrivate *priv = gs_shell_get_instance_private (shell);
 	g_autoptr(GList) keys = g_hash_table_get_keys (priv->pages);
+
+	/* anything refined in advance is now out of date */
+	gs_app_prefetcher_cancel (priv->prefetcher);
 	for (GList *l = keys; l != NULL; l = l->next) {
 		GsPage *page = GS_PAGE (g_hash_table_lookup (priv->pages, l->data));
 		gs_page_reload (page);
@@ -1965,6 +2010,7 @@ gs_shell_setup (GsShell *shell, GsPluginLoader *plugin_loader, GCancellable *can
 	g_return_if_fail (GS_IS_SHELL (shell));
 
 	priv->plugin_loader = g_object_ref (plugin_loader);
+	priv->prefetcher = gs_app_prefetcher_new (plugin_loader);
 	g_signal_connect (priv->plugin_loader, "reload",
 			  G_CALLBACK (gs_shell_reload_cb), shell);
 	g_signal_connect_object (priv->plugin_loader, "notify::events",
@@ -2167,6 +2213,17 @@ gs_shell_setup (GsShell *shell, GsPluginLoader *plugin_loader, GCancellable *can
 		g_menu_append_item (auth_menu, signout_item);
 	}
 
+	/* show the last overview straight away if there is one, and do the
+	 * initial refresh behind it */
+	page = GS_PAGE (gtk_builder_get_object (priv->builder, "overview_page"));
+	if (gs_overview_page_load_snapshot (GS_OVERVIEW_PAGE (page))) {
+		priv->showing_snapshot = TRUE;
+		gs_shell_change_mode (shell, GS_SHELL_MODE_OVERVIEW, NULL, TRUE);
+		page = GS_PAGE (gtk_builder_get_object (priv->builder, "loading_page"));
+		gs_loading_page_load (GS_LOADING_PAGE (page));
+		return;
+	}
+
 	/* show loading page, which triggers the initial refresh */
 	gs_shell_change_mode (shell, GS_SHELL_MODE_LOADING, NULL, TRUE);
 }
@@ -2337,6 +2394,7 @@ gs_shell_dispose (GObject *object)
 	g_clear_object (&priv->builder);
 	g_clear_object (&priv->cancellable);
 	g_clear_object (&priv->plugin_loader);
+	g_clear_object (&priv->prefetcher);
 	g_clear_object (&priv->header_start_widget);
 	g_clear_object (&priv->header_end_widget);
 	g_clear_object (&priv->page);
@@ -27,6 +27,8 @@
 
 #include "gnome-software-private.h"
 
+#include "gs-app-prefetcher.h"
+
 G_BEGIN_DECLS
 
 #define GS_TYPE_SHELL (gs_shell_get_type ())
@@ -101,7 +103,12 @@ void		 gs_shell_setup			(GsShell	*shell,
 						 GsPluginLoader	*plugin_loader,
 						 GCancellable	*cancellable);
 gboolean	 gs_shell_is_active		(GsShell	*shell);
+void		 gs_shell_prefetch_app		(GsShell	*shell,
+						 GsApp		*app);
+GsAppPrefetcher	*gs_shell_get_prefetcher	(GsShell	*shell);
+void		 gs_shell_save_snapshot		(GsShell	*shell);
 GtkWindow	*gs_shell_get_window		(GsShell	*shell);
+GVariant	*gs_shell_get_search_stats	(GsShell	*shell);
 
 G_END_DECLS
 
@@ -30,6 +30,50 @@
 #include "gs-update-monitor.h"
 #include "gs-common.h"
 
+/* never refresh a source more often than this, nor leave it longer */
+#define GS_REFRESH_INTERVAL_MIN		(60 * 60 * 24)		/* s */
+#define GS_REFRESH_INTERVAL_MAX		(60 * 60 * 24 * 3)	/* s */
+
+typedef struct {
+	gchar		*plugin_name;
+	gint64		 last_refresh;		/* unix time */
+	gint64		 last_changed;		/* unix time */
+	gint64		 change_interval;	/* s, moving average */
+	guint64		 download_bytes;
+	guint		 refresh_cnt;
+	guint		 skipped_cnt;
+	GHashTable	*updates;		/* not persisted */
+} GsRefreshSource;
+
+static GsRefreshSource *
+gs_refresh_source_new (const gchar *plugin_name)
+{
+	GsRefreshSource *source = g_slice_new0 (GsRefreshSource);
+	source->plugin_name = g_strdup (plugin_name);
+
+	/* assume a daily refresh until we know better */
+	source->change_interval = GS_REFRESH_INTERVAL_MIN * 2;
+	return source;
+}
+
+static void
+gs_refresh_source_free (GsRefreshSource *source)
+{
+	g_free (source->plugin_name);
+	if (source->updates != NULL)
+		g_hash_table_unref (source->updates);
+	g_slice_free (GsRefreshSource, source);
+}
+
+static gint64
+gs_refresh_source_get_interval (GsRefreshSource *source)
+{
+	/* sample at twice the rate we see changes */
+	return CLAMP (source->change_interval / 2,
+		      GS_REFRESH_INTERVAL_MIN,
+		      GS_REFRESH_INTERVAL_MAX);
+}
+
 struct _GsUpdateMonitor {
 	GObject		 parent;
 
@@ -38,6 +82,7 @@ struct _GsUpdateMonitor {
 	GSettings	*settings;
 	GsPluginLoader	*plugin_loader;
 	GDBusProxy	*proxy_upower;
+	gboolean	 upower_allows_updates;
 	GError		*last_offline_error;
 
 	GNetworkMonitor *network_monitor;
@@ -49,6 +94,12 @@ struct _GsUpdateMonitor {
 	guint		 check_hourly_id;		/* and then every hour */
 	guint		 check_daily_id;		/* every 3rd day */
 	guint		 notification_blocked_id;	/* rate limit notifications */
+
+	GHashTable	*refresh_sources;		/* plugin-name:GsRefreshSource */
+	GPtrArray	*refresh_queue;			/* of GsRefreshSource, most overdue first */
+	GsRefreshSource	*refresh_current;
+	GsPluginJob	*refresh_job;
+	gboolean	 refresh_any_ok;
 };
 
 G_DEFINE_TYPE (GsUpdateMonitor, gs_update_monitor, G_TYPE_OBJECT)
@@ -360,6 +411,7 @@ download_finished_cb (GObject *object, GAsyncResult *res, gpointer data)
 		g_autoptr(GsPluginJob) plugin_job = NULL;
 		plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_UPDATE,
 						 "list", update_online,
+						 "background", TRUE,
 						 NULL);
 		gs_plugin_loader_job_process_async (monitor->plugin_loader,
 						    plugin_job,
@@ -377,6 +429,8 @@ download_finished_cb (GObject *object, GAsyncResult *res, gpointer data)
 	}
 }
 
+static void refresh_planner_observe_updates (GsUpdateMonitor *monitor, GsAppList *apps);
+
 static void
 get_updates_finished_cb (GObject *object, GAsyncResult *res, gpointer data)
 {
@@ -395,6 +449,9 @@ get_updates_finished_cb (GObject *object, GAsyncResult *res, gpointer data)
 		return;
 	}
 
+	/* learn how often each source changes */
+	refresh_planner_observe_updates (monitor, apps);
+
 	/* no updates */
 	if (gs_app_list_length (apps) == 0) {
 		g_debug ("no updates; withdrawing updates-available notification");
@@ -426,6 +483,7 @@ get_updates_finished_cb (GObject *object, GAsyncResult *res, gpointer data)
 		g_autoptr(GsPluginJob) plugin_job = NULL;
 		plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_DOWNLOAD,
 						 "list", apps,
+						 "background", TRUE,
 						 NULL);
 		g_debug ("Getting updates");
 		gs_plugin_loader_job_process_async (monitor->plugin_loader,
@@ -579,6 +637,7 @@ get_updates (GsUpdateMonitor *monitor, GsUpdateMonitorMode mode)
 	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES,
 					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_DETAILS |
 							 GS_PLUGIN_REFINE_FLAGS_REQUIRE_UPDATE_SEVERITY,
+					 "background", TRUE,
 					 NULL);
 	gs_plugin_loader_job_process_async (monitor->plugin_loader,
 					    plugin_job,
@@ -609,6 +668,7 @@ get_upgrades (GsUpdateMonitor *monitor)
 	 * package being up-to-date, or the metadata being auto-downloaded */
 	g_debug ("Getting upgrades");
 	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_DISTRO_UPDATES,
+					 "background", TRUE,
 					 NULL);
 	gs_plugin_loader_job_process_async (monitor->plugin_loader,
 					    plugin_job,
@@ -627,6 +687,7 @@ get_system (GsUpdateMonitor *monitor)
 	app = gs_plugin_loader_get_system_app (monitor->plugin_loader);
 	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFINE,
 					 "app", app,
+					 "background", TRUE,
 					 NULL);
 	gs_plugin_loader_job_process_async (monitor->plugin_loader, plugin_job,
 					    monitor->cancellable,
@@ -634,27 +695,320 @@ get_system (GsUpdateMonitor *monitor)
 					    monitor);
 }
 
+static gchar *
+refresh_planner_get_filename (GError **error)
+{
+	return gs_utils_get_cache_filename ("refresh", "planner.ini",
+					    GS_UTILS_CACHE_FLAG_WRITEABLE,
+					    error);
+}
+
+static GsRefreshSource *
+refresh_planner_ensure_source (GsUpdateMonitor *monitor, const gchar *plugin_name)
+{
+	GsRefreshSource *source = g_hash_table_lookup (monitor->refresh_sources, plugin_name);
+	if (source == NULL) {
+		source = gs_refresh_source_new (plugin_name);
+		g_hash_table_insert (monitor->refresh_sources,
+				     source->plugin_name, source);
+	}
+	return source;
+}
+
+static void
+refresh_planner_load (GsUpdateMonitor *monitor)
+{
+	g_autofree gchar *fn = NULL;
+	g_auto(GStrv) groups = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GKeyFile) kf = g_key_file_new ();
+
+	fn = refresh_planner_get_filename (&error);
+	if (fn == NULL) {
+		g_warning ("failed to get refresh planner filename: %s", error->message);
+		return;
+	}
+	if (!g_key_file_load_from_file (kf, fn, G_KEY_FILE_NONE, &error)) {
+		if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			g_warning ("failed to load %s: %s", fn, error->message);
+		return;
+	}
+	groups = g_key_file_get_groups (kf, NULL);
+	for (guint i = 0; groups[i] != NULL; i++) {
+		GsRefreshSource *source = refresh_planner_ensure_source (monitor, groups[i]);
+		gint64 change_interval;
+		source->last_refresh = g_key_file_get_int64 (kf, groups[i], "LastRefresh", NULL);
+		source->last_changed = g_key_file_get_int64 (kf, groups[i], "LastChanged", NULL);
+		source->download_bytes = g_key_file_get_uint64 (kf, groups[i], "DownloadBytes", NULL);
+		source->refresh_cnt = (guint) g_key_file_get_integer (kf, groups[i], "RefreshCount", NULL);
+		source->skipped_cnt = (guint) g_key_file_get_integer (kf, groups[i], "SkippedCount", NULL);
+		change_interval = g_key_file_get_int64 (kf, groups[i], "ChangeInterval", NULL);
+		if (change_interval > 0)
+			source->change_interval = change_interval;
+	}
+}
+
+static void
+refresh_planner_save (GsUpdateMonitor *monitor)
+{
+	GHashTableIter iter;
+	gpointer value;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GKeyFile) kf = g_key_file_new ();
+
+	fn = refresh_planner_get_filename (&error);
+	if (fn == NULL) {
+		g_warning ("failed to get refresh planner filename: %s", error->message);
+		return;
+	}
+	g_hash_table_iter_init (&iter, monitor->refresh_sources);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		GsRefreshSource *source = (GsRefreshSource *) value;
+		const gchar *group = source->plugin_name;
+		g_key_file_set_int64 (kf, group, "LastRefresh", source->last_refresh);
+		g_key_file_set_int64 (kf, group, "LastChanged", source->last_changed);
+		g_key_file_set_int64 (kf, group, "ChangeInterval", source->change_interval);
+		g_key_file_set_uint64 (kf, group, "DownloadBytes", source->download_bytes);
+		g_key_file_set_integer (kf, group, "RefreshCount", (gint) source->refresh_cnt);
+		g_key_file_set_integer (kf, group, "SkippedCount", (gint) source->skipped_cnt);
+	}
+	if (!g_key_file_save_to_file (kf, fn, &error))
+		g_warning ("failed to save %s: %s", fn, error->message);
+}
+
+/* the management plugin of an update may be a sibling of the plugin that
+ * refreshes its metadata, e.g. packagekit and packagekit-refresh */
+static GsRefreshSource *
+refresh_planner_find_source_for_app (GsUpdateMonitor *monitor, GsApp *app)
+{
+	GHashTableIter iter;
+	gpointer value;
+	const gchar *management_plugin = gs_app_get_management_plugin (app);
+	gsize len;
+
+	if (management_plugin == NULL)
+		return NULL;
+	len = strlen (management_plugin);
+	g_hash_table_iter_init (&iter, monitor->refresh_sources);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		GsRefreshSource *source = (GsRefreshSource *) value;
+		if (strncmp (source->plugin_name, management_plugin, len) != 0)
+			continue;
+		if (source->plugin_name[len] == '\0' || source->plugin_name[len] == '-')
+			return source;
+	}
+	return NULL;
+}
+
+static void
+refresh_planner_observe_updates (GsUpdateMonitor *monitor, GsAppList *apps)
+{
+	GHashTableIter iter;
+	gpointer value;
+	gint64 now = g_get_real_time () / G_USEC_PER_SEC;
+	gboolean save = FALSE;
+	g_autoptr(GHashTable) updates_by_source = NULL;
+
+	/* split the update list by the source that provided it */
+	updates_by_source = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+						   NULL, (GDestroyNotify) g_hash_table_unref);
+	g_hash_table_iter_init (&iter, monitor->refresh_sources);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		g_hash_table_insert (updates_by_source, value,
+				     g_hash_table_new_full (g_str_hash, g_str_equal,
+							    g_free, NULL));
+	}
+	for (guint i = 0; i < gs_app_list_length (apps); i++) {
+		GsApp *app = gs_app_list_index (apps, i);
+		GsRefreshSource *source = refresh_planner_find_source_for_app (monitor, app);
+		GHashTable *updates;
+		if (source == NULL)
+			continue;
+		updates = g_hash_table_lookup (updates_by_source, source);
+		g_hash_table_add (updates, g_strdup_printf ("%s@%s",
+							    gs_app_get_unique_id (app),
+							    gs_app_get_update_version (app) != NULL ?
+							    gs_app_get_update_version (app) : ""));
+	}
+
+	/* a source changed if it offers anything we have not seen before */
+	g_hash_table_iter_init (&iter, updates_by_source);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &value, NULL)) {
+		GsRefreshSource *source = (GsRefreshSource *) value;
+		GHashTable *updates = g_hash_table_lookup (updates_by_source, source);
+		gboolean changed = FALSE;
+
+		if (source->updates != NULL) {
+			GHashTableIter iter2;
+			gpointer key;
+			g_hash_table_iter_init (&iter2, updates);
+			while (g_hash_table_iter_next (&iter2, &key, NULL)) {
+				if (!g_hash_table_contains (source->updates, key)) {
+					changed = TRUE;
+					break;
+				}
+			}
+		}
+		if (changed) {
+			if (source->last_changed > 0) {
+				source->change_interval = (source->change_interval * 3 +
+							   (now - source->last_changed)) / 4;
+			}
+			source->last_changed = now;
+			g_debug ("refresh source %s changed, now expecting changes every %" G_GINT64_FORMAT "h",
+				 source->plugin_name, source->change_interval / 3600);
+			save = TRUE;
+		} else if (source->last_changed > 0 &&
+			   now - source->last_changed > source->change_interval) {
+			/* quiet for longer than expected, so back off, but only
+			 * as one sample so that a long time offline does not
+			 * skew the estimate for good */
+			source->change_interval = (source->change_interval * 3 +
+						   (now - source->last_changed)) / 4;
+			save = TRUE;
+		}
+		if (source->updates != NULL)
+			g_hash_table_unref (source->updates);
+		source->updates = g_hash_table_ref (updates);
+	}
+	if (save)
+		refresh_planner_save (monitor);
+}
+
+static gint
+refresh_planner_sort_cb (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	GsRefreshSource *source1 = *((GsRefreshSource **) a);
+	GsRefreshSource *source2 = *((GsRefreshSource **) b);
+	gint64 now = *((gint64 *) user_data);
+	gdouble overdue1 = (gdouble) (now - source1->last_refresh) /
+			   (gdouble) gs_refresh_source_get_interval (source1);
+	gdouble overdue2 = (gdouble) (now - source2->last_refresh) /
+			   (gdouble) gs_refresh_source_get_interval (source2);
+	if (overdue1 > overdue2)
+		return -1;
+	if (overdue1 < overdue2)
+		return 1;
+	return 0;
+}
+
+static void refresh_planner_run_next (GsUpdateMonitor *monitor);
+
 static void
 refresh_cache_finished_cb (GObject *object,
 			   GAsyncResult *res,
 			   gpointer data)
 {
 	GsUpdateMonitor *monitor = data;
-	g_autoptr(GDateTime) now = NULL;
+	GsRefreshSource *source = monitor->refresh_current;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GsPluginJob) plugin_job = g_steal_pointer (&monitor->refresh_job);
 
+	monitor->refresh_current = NULL;
 	if (!gs_plugin_loader_job_action_finish (GS_PLUGIN_LOADER (object), res, &error)) {
-		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
-			g_warning ("failed to refresh the cache: %s", error->message);
+		if (g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED)) {
+			g_ptr_array_set_size (monitor->refresh_queue, 0);
+			return;
+		}
+		g_warning ("failed to refresh the cache for %s: %s",
+			   source->plugin_name, error->message);
+	} else {
+		source->last_refresh = g_get_real_time () / G_USEC_PER_SEC;
+		source->refresh_cnt++;
+		monitor->refresh_any_ok = TRUE;
+	}
+
+	/* account for what this job fetched, but not any interactive
+	 * downloads from the same plugin that were running at the time */
+	source->download_bytes += gs_plugin_job_get_download_bytes (plugin_job);
+	g_debug ("refreshed %s, %" G_GUINT64_FORMAT " bytes downloaded in total",
+		 source->plugin_name, source->download_bytes);
+	refresh_planner_run_next (monitor);
+}
+
+static void
+refresh_planner_run_next (GsUpdateMonitor *monitor)
+{
+	GsPlugin *plugin = NULL;
+	GsRefreshSource *source = NULL;
+	g_autoptr(GsPluginJob) plugin_job = NULL;
+
+	/* find the next source that still exists */
+	while (plugin == NULL && monitor->refresh_queue->len > 0) {
+		source = g_ptr_array_index (monitor->refresh_queue, 0);
+		g_ptr_array_remove_index (monitor->refresh_queue, 0);
+		plugin = gs_plugin_loader_find_plugin (monitor->plugin_loader,
+						       source->plugin_name);
+	}
+
+	/* all done */
+	if (plugin == NULL) {
+		g_autoptr(GDateTime) now = NULL;
+		refresh_planner_save (monitor);
+		if (!monitor->refresh_any_ok)
+			return;
+
+		/* update the last checked timestamp */
+		now = g_date_time_new_now_local ();
+		g_settings_set (monitor->settings, "check-timestamp", "x",
+		                g_date_time_to_unix (now));
+
+		get_updates (monitor, GS_UPDATE_MONITOR_MODE_DO_AUTOUPDATES);
 		return;
 	}
 
-	/* update the last checked timestamp */
-	now = g_date_time_new_now_local ();
-	g_settings_set (monitor->settings, "check-timestamp", "x",
-	                g_date_time_to_unix (now));
+	g_debug ("refreshing %s", source->plugin_name);
+	monitor->refresh_current = source;
+	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFRESH,
+					 "age", (guint64) gs_refresh_source_get_interval (source),
+					 "background", TRUE,
+					 NULL);
+	gs_plugin_job_set_plugin_only (plugin_job, plugin);
+	monitor->refresh_job = g_object_ref (plugin_job);
+	gs_plugin_loader_job_process_async (monitor->plugin_loader, plugin_job,
+					    monitor->network_cancellable,
+					    refresh_cache_finished_cb,
+					    monitor);
+}
 
-	get_updates (monitor, GS_UPDATE_MONITOR_MODE_DO_AUTOUPDATES);
+static void
+refresh_planner_start (GsUpdateMonitor *monitor)
+{
+	gint64 now = g_get_real_time () / G_USEC_PER_SEC;
+	guint skipped = 0;
+	g_autoptr(GPtrArray) plugins = NULL;
+
+	/* already running */
+	if (monitor->refresh_current != NULL)
+		return;
+
+	/* only refresh the sources that are likely to have changed */
+	plugins = gs_plugin_loader_get_plugins_supported (monitor->plugin_loader,
+							  "gs_plugin_refresh");
+	for (guint i = 0; i < plugins->len; i++) {
+		GsPlugin *plugin = g_ptr_array_index (plugins, i);
+		GsRefreshSource *source;
+		source = refresh_planner_ensure_source (monitor, gs_plugin_get_name (plugin));
+		if (now - source->last_refresh < gs_refresh_source_get_interval (source)) {
+			source->skipped_cnt++;
+			skipped++;
+			continue;
+		}
+		g_ptr_array_add (monitor->refresh_queue, source);
+	}
+	g_debug ("refresh planner: %u sources due, %u skipped",
+		 monitor->refresh_queue->len, skipped);
+	if (monitor->refresh_queue->len == 0) {
+		refresh_planner_save (monitor);
+		return;
+	}
+
+	/* most overdue first */
+	g_ptr_array_sort_with_data (monitor->refresh_queue,
+				    refresh_planner_sort_cb, &now);
+	monitor->refresh_any_ok = FALSE;
+	refresh_planner_run_next (monitor);
 }
 
 typedef enum {
@@ -667,13 +1021,38 @@ typedef enum {
 	UP_DEVICE_LEVEL_LAST
 } UpDeviceLevel;
 
+typedef enum {
+	UP_DEVICE_STATE_UNKNOWN,
+	UP_DEVICE_STATE_CHARGING,
+	UP_DEVICE_STATE_DISCHARGING,
+	UP_DEVICE_STATE_EMPTY,
+	UP_DEVICE_STATE_FULLY_CHARGED,
+	UP_DEVICE_STATE_PENDING_CHARGE,
+	UP_DEVICE_STATE_PENDING_DISCHARGE,
+	UP_DEVICE_STATE_LAST
+} UpDeviceState;
+
+/* do not let the background jobs drain the battery */
+static void
+update_background_paused (GsUpdateMonitor *monitor)
+{
+	guint32 state = UP_DEVICE_STATE_UNKNOWN;
+	g_autoptr(GVariant) val = NULL;
+
+	if (monitor->proxy_upower == NULL)
+		return;
+	val = g_dbus_proxy_get_cached_property (monitor->proxy_upower, "State");
+	if (val != NULL)
+		state = g_variant_get_uint32 (val);
+	gs_plugin_loader_set_background_paused (monitor->plugin_loader,
+						state == UP_DEVICE_STATE_DISCHARGING ||
+						state == UP_DEVICE_STATE_PENDING_DISCHARGE);
+}
+
 static void
 check_updates (GsUpdateMonitor *monitor)
 {
-	gint64 tmp;
 	gboolean refresh_on_metered;
-	g_autoptr(GDateTime) last_refreshed = NULL;
-	g_autoptr(GsPluginJob) plugin_job = NULL;
 
 	/* never check for updates when offline */
 	if (!gs_plugin_loader_get_network_available (monitor->plugin_loader))
@@ -702,39 +1081,7 @@ check_updates (GsUpdateMonitor *monitor)
 		g_debug ("no UPower support, so not doing power level checks");
 	}
 
-	g_settings_get (monitor->settings, "check-timestamp", "x", &tmp);
-	last_refreshed = g_date_time_new_from_unix_local (tmp);
-	if (last_refreshed != NULL) {
-		gint now_year, now_month, now_day, now_hour;
-		gint year, month, day;
-		g_autoptr(GDateTime) now = NULL;
-
-		now = g_date_time_new_now_local ();
-
-		g_date_time_get_ymd (now, &now_year, &now_month, &now_day);
-		now_hour = g_date_time_get_hour (now);
-
-		g_date_time_get_ymd (last_refreshed, &year, &month, &day);
-
-		/* check that it is the next day */
-		if (!((now_year > year) ||
-		      (now_year == year && now_month > month) ||
-		      (now_year == year && now_month == month && now_day > day)))
-			return;
-
-		/* ...and past 6am */
-		if (!(now_hour >= 6))
-			return;
-	}
-
-	g_debug ("Daily update check due");
-	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_REFRESH,
-					 "age", (guint64) (60 * 60 * 24),
-					 NULL);
-	gs_plugin_loader_job_process_async (monitor->plugin_loader, plugin_job,
-					    monitor->network_cancellable,
-					    refresh_cache_finished_cb,
-					    monitor);
+	refresh_planner_start (monitor);
 }
 
 static gboolean
@@ -816,15 +1163,64 @@ check_updates_on_startup_cb (gpointer data)
 	return G_SOURCE_REMOVE;
 }
 
+/* not on battery, and not low on power */
+static gboolean
+upower_allows_updates (GsUpdateMonitor *monitor)
+{
+	guint32 level = UP_DEVICE_LEVEL_UNKNOWN;
+	guint32 state = UP_DEVICE_STATE_UNKNOWN;
+	g_autoptr(GVariant) val_level = NULL;
+	g_autoptr(GVariant) val_state = NULL;
+
+	if (monitor->proxy_upower == NULL)
+		return TRUE;
+	val_level = g_dbus_proxy_get_cached_property (monitor->proxy_upower, "WarningLevel");
+	if (val_level != NULL)
+		level = g_variant_get_uint32 (val_level);
+	val_state = g_dbus_proxy_get_cached_property (monitor->proxy_upower, "State");
+	if (val_state != NULL)
+		state = g_variant_get_uint32 (val_state);
+	return level < UP_DEVICE_LEVEL_LOW &&
+	       state != UP_DEVICE_STATE_DISCHARGING &&
+	       state != UP_DEVICE_STATE_PENDING_DISCHARGE;
+}
+
 static void
 check_updates_upower_changed_cb (GDBusProxy *proxy,
-				 GParamSpec *pspec,
+				 GVariant *changed_properties,
+				 GStrv invalidated_properties,
 				 GsUpdateMonitor *monitor)
 {
+	gboolean allowed;
+	g_autoptr(GVariant) val_level = NULL;
+	g_autoptr(GVariant) val_state = NULL;
+
+	/* the percentage and time estimates change all the time */
+	val_level = g_variant_lookup_value (changed_properties, "WarningLevel", NULL);
+	val_state = g_variant_lookup_value (changed_properties, "State", NULL);
+	if (val_level == NULL && val_state == NULL)
+		return;
+
+	/* only check when the updates were held back and now are not */
+	allowed = upower_allows_updates (monitor);
+	if (allowed == monitor->upower_allows_updates)
+		return;
+	monitor->upower_allows_updates = allowed;
+	if (!allowed)
+		return;
 	g_debug ("upower changed updates check");
 	check_updates (monitor);
 }
 
+static void
+upower_properties_changed_cb (GDBusProxy *proxy,
+			      GVariant *changed_properties,
+			      GStrv invalidated_properties,
+			      GsUpdateMonitor *monitor)
+{
+	update_background_paused (monitor);
+}
+
 static void
 network_available_notify_cb (GsPluginLoader *plugin_loader,
 			     GParamSpec *pspec,
@@ -936,6 +1332,7 @@ cleanup_notifications_cb (gpointer user_data)
 	g_debug ("getting historical updates for fresh session");
 	plugin_job = gs_plugin_job_newv (GS_PLUGIN_ACTION_GET_UPDATES_HISTORICAL,
 					 "refine-flags", GS_PLUGIN_REFINE_FLAGS_REQUIRE_VERSION,
+					 "background", TRUE,
 					 NULL);
 	gs_plugin_loader_job_process_async (monitor->plugin_loader,
 					    plugin_job,
@@ -1045,6 +1442,10 @@ gs_update_monitor_init (GsUpdateMonitor *monitor)
 	GNetworkMonitor *network_monitor;
 	g_autoptr(GError) error = NULL;
 	monitor->settings = g_settings_new ("org.gnome.software");
+	monitor->refresh_sources = g_hash_table_new_full (g_str_hash, g_str_equal,
+							  NULL, (GDestroyNotify) gs_refresh_source_free);
+	monitor->refresh_queue = g_ptr_array_new ();
+	refresh_planner_load (monitor);
 
 	/* cleanup at startup */
 	monitor->cleanup_notifications_id =
@@ -1070,7 +1471,11 @@ gs_update_monitor_init (GsUpdateMonitor *monitor)
 					NULL,
 					&error);
 	if (monitor->proxy_upower != NULL) {
-		g_signal_connect (monitor->proxy_upower, "notify",
+		/* pause first so that a check started on battery waits */
+		g_signal_connect (monitor->proxy_upower, "g-properties-changed",
+				  G_CALLBACK (upower_properties_changed_cb),
+				  monitor);
+		g_signal_connect (monitor->proxy_upower, "g-properties-changed",
 				  G_CALLBACK (check_updates_upower_changed_cb),
 				  monitor);
 	} else {
@@ -1118,7 +1523,16 @@ gs_update_monitor_dispose (GObject *object)
 		g_source_remove (monitor->cleanup_notifications_id);
 		monitor->cleanup_notifications_id = 0;
 	}
+	if (monitor->proxy_upower != NULL) {
+		g_signal_handlers_disconnect_by_func (monitor->proxy_upower,
+						      check_updates_upower_changed_cb,
+						      monitor);
+		g_signal_handlers_disconnect_by_func (monitor->proxy_upower,
+						      upower_properties_changed_cb,
+						      monitor);
+	}
 	if (monitor->plugin_loader != NULL) {
+		gs_plugin_loader_set_background_paused (monitor->plugin_loader, FALSE);
 		g_signal_handlers_disconnect_by_func (monitor->plugin_loader,
 		                                      updates_changed_cb,
 		                                      monitor);
@@ -1140,6 +1554,9 @@ gs_update_monitor_finalize (GObject *object)
 
 	g_application_release (monitor->application);
 	g_clear_error (&monitor->last_offline_error);
+	g_clear_object (&monitor->refresh_job);
+	g_ptr_array_unref (monitor->refresh_queue);
+	g_hash_table_unref (monitor->refresh_sources);
 
 	G_OBJECT_CLASS (gs_update_monitor_parent_class)->finalize (object);
 }
@@ -1168,6 +1585,8 @@ gs_update_monitor_new (GsApplication *application)
 			  G_CALLBACK (allow_updates_notify_cb), monitor);
 	g_signal_connect (monitor->plugin_loader, "notify::network-available",
 			  G_CALLBACK (network_available_notify_cb), monitor);
+	update_background_paused (monitor);
+	monitor->upower_allows_updates = upower_allows_updates (monitor);
 
 	return monitor;
 }
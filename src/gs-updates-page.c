@@ -83,6 +83,7 @@ struct _GsUpdatesPage
 	GtkWidget		*header_end_box;
 	gboolean		 has_agreed_to_mobile_data;
 	gboolean		 ampm_available;
+	gboolean		 has_partial_updates;
 
 	GtkWidget		*updates_box;
 	GtkWidget		*button_updates_mobile;
@@ -409,8 +410,13 @@ gs_updates_page_update_ui_state (GsUpdatesPage *self)
 		gtk_stack_set_visible_child_name (GTK_STACK (self->stack_updates), "failed");
 		break;
 	case GS_UPDATES_PAGE_STATE_ACTION_GET_UPDATES:
-		gtk_stack_set_visible_child_name (GTK_STACK (self->stack_updates),
-						  "spinner");
+		/* show what we have so far rather than a blank spinner */
+		if (self->has_partial_updates) {
+			gtk_stack_set_visible_child_name (GTK_STACK (self->stack_updates), "view");
+		} else {
+			gtk_stack_set_visible_child_name (GTK_STACK (self->stack_updates),
+							  "spinner");
+		}
 		break;
 	case GS_UPDATES_PAGE_STATE_ACTION_REFRESH:
 		if (self->result_flags != GS_UPDATES_PAGE_FLAG_NONE) {
@@ -510,6 +516,78 @@ gs_updates_page_network_available_notify_cb (GsPluginLoader *plugin_loader,
 	gs_updates_page_update_ui_state (self);
 }
 
+static void
+gs_updates_page_add_apps (GsUpdatesPage *self, GsAppList *list)
+{
+	for (guint i = 0; i < gs_app_list_length (list); i++) {
+		GsApp *app = gs_app_list_index (list, i);
+		GsUpdatesSectionKind section = _get_app_section (app);
+		gs_updates_section_add_app (GS_UPDATES_SECTION (self->sections[section]), app);
+	}
+
+	/* invalidate the headers */
+	for (guint i = 0; i < GS_UPDATES_SECTION_KIND_LAST; i++) {
+		if (self->sections[i] != NULL)
+			gtk_list_box_invalidate_headers (self->sections[i]);
+	}
+
+	/* update the counter in headerbar */
+	refresh_headerbar_updates_counter (self);
+}
+
+/* drop the partial results that are not in the final list, or that are now
+ * in a different section, so the rows that are kept are not rebuilt */
+static void
+gs_updates_page_remove_stale_apps (GsUpdatesPage *self, GsAppList *list)
+{
+	for (guint i = 0; i < GS_UPDATES_SECTION_KIND_LAST; i++) {
+		GsUpdatesSection *section = GS_UPDATES_SECTION (self->sections[i]);
+		g_autoptr(GsAppList) shown = NULL;
+
+		shown = gs_app_list_copy (gs_updates_section_get_list (section));
+		for (guint j = 0; j < gs_app_list_length (shown); j++) {
+			GsApp *app = gs_app_list_index (shown, j);
+			const gchar *unique_id = gs_app_get_unique_id (app);
+			GsApp *app_final = NULL;
+
+			if (list != NULL && unique_id != NULL)
+				app_final = gs_app_list_lookup (list, unique_id);
+			if (app_final == app && _get_app_section (app_final) == i)
+				continue;
+			gs_updates_section_remove_app (section, app);
+		}
+	}
+}
+
+static void
+gs_updates_page_weak_ref_free (GWeakRef *weak_ref)
+{
+	g_weak_ref_clear (weak_ref);
+	g_slice_free (GWeakRef, weak_ref);
+}
+
+static void
+gs_updates_page_get_updates_partial_cb (GsPluginJob *plugin_job,
+					GsAppList *list,
+					gpointer user_data)
+{
+	g_autoptr(GsUpdatesPage) self = g_weak_ref_get ((GWeakRef *) user_data);
+
+	/* the page has gone away */
+	if (self == NULL)
+		return;
+
+	/* the final results are already being shown */
+	if (self->state != GS_UPDATES_PAGE_STATE_ACTION_GET_UPDATES)
+		return;
+
+	g_debug ("updates-shell: showing %u partial updates",
+		 gs_app_list_length (list));
+	gs_updates_page_add_apps (self, list);
+	self->has_partial_updates = TRUE;
+	gs_updates_page_update_ui_state (self);
+}
+
 static void
 gs_updates_page_get_updates_cb (GsPluginLoader *plugin_loader,
                                 GAsyncResult *res,
@@ -523,6 +601,13 @@ gs_updates_page_get_updates_cb (GsPluginLoader *plugin_loader,
 
 	/* get the results */
 	list = gs_plugin_loader_job_process_finish (plugin_loader, res, &error);
+
+	/* the final list is authoritative, so drop any partial results it
+	 * does not have; the rest are already shown and are left alone */
+	if (self->has_partial_updates) {
+		gs_updates_page_remove_stale_apps (self, list);
+		self->has_partial_updates = FALSE;
+	}
 	if (list == NULL) {
 		gs_updates_page_clear_flag (self, GS_UPDATES_PAGE_FLAG_HAS_UPDATES);
 		if (!g_error_matches (error, GS_PLUGIN_ERROR, GS_PLUGIN_ERROR_CANCELLED))
@@ -538,20 +623,7 @@ gs_updates_page_get_updates_cb (GsPluginLoader *plugin_loader,
 	}
 
 	/* add the results */
-	for (guint i = 0; i < gs_app_list_length (list); i++) {
-		GsApp *app = gs_app_list_index (list, i);
-		GsUpdatesSectionKind section = _get_app_section (app);
-		gs_updates_section_add_app (GS_UPDATES_SECTION (self->sections[section]), app);
-	}
-
-	/* invalidate the headers */
-	for (guint i = 0; i < GS_UPDATES_SECTION_KIND_LAST; i++) {
-		if (self->sections[i] != NULL)
-			gtk_list_box_invalidate_headers (self->sections[i]);
-	}
-
-	/* update the counter in headerbar */
-	refresh_headerbar_updates_counter (self);
+	gs_updates_page_add_apps (self, list);
 
 	/* no results */
 	if (gs_app_list_length (list) == 0) {
@@ -659,6 +731,7 @@ gs_updates_page_get_system_finished_cb (GObject *source_object,
 static void
 gs_updates_page_load (GsUpdatesPage *self)
 {
+	GWeakRef *weak_ref;
 	guint64 refine_flags;
 	g_autoptr(GsApp) app = NULL;
 	g_autoptr(GsPluginJob) plugin_job = NULL;
@@ -669,6 +742,7 @@ gs_updates_page_load (GsUpdatesPage *self)
 	/* remove all existing apps */
 	for (guint i = 0; i < GS_UPDATES_SECTION_KIND_LAST; i++)
 		gs_updates_section_remove_all (GS_UPDATES_SECTION (self->sections[i]));
+	self->has_partial_updates = FALSE;
 
 	refine_flags = GS_PLUGIN_REFINE_FLAGS_REQUIRE_ICON |
 		       GS_PLUGIN_REFINE_FLAGS_REQUIRE_SIZE |
@@ -680,6 +754,15 @@ gs_updates_page_load (GsUpdatesPage *self)
 					 "refine-flags", refine_flags,
 					 "dedupe-flags", GS_APP_LIST_FILTER_FLAG_NONE,
 					 NULL);
+
+	/* the job can outlive the page, so only keep a weak ref to it */
+	weak_ref = g_slice_new0 (GWeakRef);
+	g_weak_ref_init (weak_ref, self);
+	g_object_set_data_full (G_OBJECT (plugin_job), "GsUpdatesPage::weak-ref",
+				weak_ref, (GDestroyNotify) gs_updates_page_weak_ref_free);
+	gs_plugin_job_set_partial_func (plugin_job,
+					gs_updates_page_get_updates_partial_cb,
+					weak_ref);
 	gs_plugin_loader_job_process_async (self->plugin_loader, plugin_job,
 					    self->cancellable,
 					    (GAsyncReadyCallback) gs_updates_page_get_updates_cb,
@@ -32,10 +32,18 @@
 #include "gs-update-dialog.h"
 #include "gs-updates-section.h"
 
+/* rows beyond the first batch are created from an idle handler, a batch at
+ * a time, so that a long list of updates does not block the first paint */
+#define GS_UPDATES_SECTION_ROWS_BATCH	30
+
 struct _GsUpdatesSection
 {
 	GtkListBox		 parent_instance;
 	GsAppList		*list;
+	GPtrArray		*pending_rows;	/* of GsApp */
+	guint			 pending_rows_idx;	/* first not yet realized */
+	guint			 n_rows;
+	guint			 add_rows_id;
 	GsUpdatesSectionKind	 kind;
 	GCancellable		*cancellable;
 	GsPage			*page;
@@ -77,10 +85,11 @@ _app_state_notify_cb (GsApp *app, GParamSpec *pspec, gpointer user_data)
 	}
 }
 
-void
-gs_updates_section_add_app (GsUpdatesSection *self, GsApp *app)
+static void
+_add_app_row (GsUpdatesSection *self, GsApp *app)
 {
 	GtkWidget *app_row;
+
 	app_row = gs_app_row_new (app);
 	gs_app_row_set_show_update (GS_APP_ROW (app_row), TRUE);
 	gs_app_row_set_show_buttons (GS_APP_ROW (app_row), TRUE);
@@ -88,7 +97,7 @@ gs_updates_section_add_app (GsUpdatesSection *self, GsApp *app)
 			  G_CALLBACK (_app_row_button_clicked_cb),
 			  self);
 	gtk_container_add (GTK_CONTAINER (self), app_row);
-	gs_app_list_add (self->list, app);
+	self->n_rows++;
 
 	gs_app_row_set_size_groups (GS_APP_ROW (app_row),
 				    self->sizegroup_image,
@@ -98,13 +107,94 @@ gs_updates_section_add_app (GsUpdatesSection *self, GsApp *app)
 	g_signal_connect_object (app, "notify::state",
 	                         G_CALLBACK (_app_state_notify_cb),
 	                         app_row, 0);
+}
+
+static gboolean
+_add_pending_rows_idle_cb (gpointer user_data)
+{
+	GsUpdatesSection *self = GS_UPDATES_SECTION (user_data);
+
+	for (guint i = 0; i < GS_UPDATES_SECTION_ROWS_BATCH; i++) {
+		GsApp *app;
+		if (self->pending_rows_idx >= self->pending_rows->len)
+			break;
+		app = g_ptr_array_index (self->pending_rows, self->pending_rows_idx++);
+
+		/* already updated before the row was shown */
+		if (gs_app_get_state (app) == AS_APP_STATE_INSTALLED)
+			continue;
+		_add_app_row (self, app);
+	}
+	if (self->pending_rows_idx < self->pending_rows->len)
+		return G_SOURCE_CONTINUE;
+	g_ptr_array_set_size (self->pending_rows, 0);
+	self->pending_rows_idx = 0;
+	self->add_rows_id = 0;
+	return G_SOURCE_REMOVE;
+}
+
+void
+gs_updates_section_add_app (GsUpdatesSection *self, GsApp *app)
+{
+	const gchar *unique_id = gs_app_get_unique_id (app);
+
+	/* already added from an earlier partial result */
+	if (unique_id != NULL && gs_app_list_lookup (self->list, unique_id) != NULL)
+		return;
+	gs_app_list_add (self->list, app);
 	gtk_widget_show (GTK_WIDGET (self));
+
+	/* the first batch is needed for the first paint */
+	if (self->n_rows < GS_UPDATES_SECTION_ROWS_BATCH) {
+		_add_app_row (self, app);
+		return;
+	}
+	g_ptr_array_add (self->pending_rows, g_object_ref (app));
+	if (self->add_rows_id == 0) {
+		self->add_rows_id = g_idle_add_full (G_PRIORITY_LOW,
+						     _add_pending_rows_idle_cb,
+						     self, NULL);
+	}
+}
+
+void
+gs_updates_section_remove_app (GsUpdatesSection *self, GsApp *app)
+{
+	g_autoptr(GList) children = NULL;
+
+	for (guint i = self->pending_rows_idx; i < self->pending_rows->len; i++) {
+		if (g_ptr_array_index (self->pending_rows, i) == app) {
+			g_ptr_array_remove_index (self->pending_rows, i);
+			break;
+		}
+	}
+	children = gtk_container_get_children (GTK_CONTAINER (self));
+	for (GList *l = children; l != NULL; l = l->next) {
+		GtkWidget *w = GTK_WIDGET (l->data);
+		if (!GS_IS_APP_ROW (w) || gs_app_row_get_app (GS_APP_ROW (w)) != app)
+			continue;
+		gtk_container_remove (GTK_CONTAINER (self), w);
+		self->n_rows--;
+		break;
+	}
+	gs_app_list_remove (self->list, app);
+	if (gs_app_list_length (self->list) == 0)
+		gs_updates_section_remove_all (self);
 }
 
 void
 gs_updates_section_remove_all (GsUpdatesSection *self)
 {
 	g_autoptr(GList) children = NULL;
+
+	if (self->add_rows_id != 0) {
+		g_source_remove (self->add_rows_id);
+		self->add_rows_id = 0;
+	}
+	g_ptr_array_set_size (self->pending_rows, 0);
+	self->pending_rows_idx = 0;
+	self->n_rows = 0;
+
 	children = gtk_container_get_children (GTK_CONTAINER (self));
 	for (GList *l = children; l != NULL; l = l->next) {
 		GtkWidget *w = GTK_WIDGET (l->data);
@@ -129,50 +219,32 @@ typedef struct {
 	gboolean		 do_reboot_notification;
 } GsUpdatesSectionUpdateHelper;
 
-static gchar *
-_get_app_sort_key (GsApp *app)
+static guint
+_get_app_sort_rank (GsApp *app)
 {
-	GString *key;
-
-	key = g_string_sized_new (64);
-
 	/* sort apps by kind */
 	switch (gs_app_get_kind (app)) {
 	case AS_APP_KIND_OS_UPDATE:
-		g_string_append (key, "1:");
-		break;
+		return 1;
 	case AS_APP_KIND_DESKTOP:
-		g_string_append (key, "2:");
-		break;
+		return 2;
 	case AS_APP_KIND_WEB_APP:
-		g_string_append (key, "3:");
-		break;
+		return 3;
 	case AS_APP_KIND_RUNTIME:
-		g_string_append (key, "4:");
-		break;
+		return 4;
 	case AS_APP_KIND_ADDON:
-		g_string_append (key, "5:");
-		break;
+		return 5;
 	case AS_APP_KIND_CODEC:
-		g_string_append (key, "6:");
-		break;
+		return 6;
 	case AS_APP_KIND_FONT:
-		g_string_append (key, "6:");
-		break;
+		return 6;
 	case AS_APP_KIND_INPUT_METHOD:
-		g_string_append (key, "7:");
-		break;
+		return 7;
 	case AS_APP_KIND_SHELL_EXTENSION:
-		g_string_append (key, "8:");
-		break;
+		return 8;
 	default:
-		g_string_append (key, "9:");
-		break;
+		return 9;
 	}
-
-	/* finally, sort by short name */
-	g_string_append (key, gs_app_get_name (app));
-	return g_string_free (key, FALSE);
 }
 
 static gint
@@ -180,11 +252,16 @@ _list_sort_func (GtkListBoxRow *a, GtkListBoxRow *b, gpointer user_data)
 {
 	GsApp *a1 = gs_app_row_get_app (GS_APP_ROW (a));
 	GsApp *a2 = gs_app_row_get_app (GS_APP_ROW (b));
-	g_autofree gchar *key1 = _get_app_sort_key (a1);
-	g_autofree gchar *key2 = _get_app_sort_key (a2);
+	guint rank1 = _get_app_sort_rank (a1);
+	guint rank2 = _get_app_sort_rank (a2);
+
+	/* compare the ranks according to the algorithm above */
+	if (rank1 != rank2)
+		return rank1 < rank2 ? -1 : 1;
 
-	/* compare the keys according to the algorithm above */
-	return g_strcmp0 (key1, key2);
+	/* finally, sort by name */
+	return g_strcmp0 (gs_app_get_name_sort_key (a1),
+			  gs_app_get_name_sort_key (a2));
 }
 
 static void
@@ -394,6 +471,10 @@ _get_listbox_apps (GsUpdatesSection *self)
 		gs_app_list_add (apps, gs_app_row_get_app (app_row));
 	}
 
+	/* rows that have not been created yet */
+	for (guint i = self->pending_rows_idx; i < self->pending_rows->len; i++)
+		gs_app_list_add (apps, g_ptr_array_index (self->pending_rows, i));
+
 	return g_steal_pointer (&apps);
 }
 
@@ -563,8 +644,14 @@ gs_updates_section_dispose (GObject *object)
 {
 	GsUpdatesSection *self = GS_UPDATES_SECTION (object);
 
+	if (self->add_rows_id != 0) {
+		g_source_remove (self->add_rows_id);
+		self->add_rows_id = 0;
+	}
+
 	g_clear_object (&self->cancellable);
 	g_clear_object (&self->list);
+	g_clear_pointer (&self->pending_rows, g_ptr_array_unref);
 	g_clear_object (&self->plugin_loader);
 	g_clear_object (&self->page);
 
@@ -616,6 +703,7 @@ gs_updates_section_init (GsUpdatesSection *self)
 {
 	GtkStyleContext *context;
 
+	self->pending_rows = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
 	self->list = gs_app_list_new ();
 	gs_app_list_add_flag (self->list,
 			      GS_APP_LIST_FLAG_WATCH_APPS |
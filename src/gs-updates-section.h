@@ -49,6 +49,8 @@ GtkListBox	*gs_updates_section_new			(GsUpdatesSectionKind	 kind,
 GsAppList	*gs_updates_section_get_list		(GsUpdatesSection	*self);
 void		 gs_updates_section_add_app		(GsUpdatesSection	*self,
 							 GsApp			*app);
+void		 gs_updates_section_remove_app		(GsUpdatesSection	*self,
+							 GsApp			*app);
 void		 gs_updates_section_remove_all		(GsUpdatesSection	*self);
 void		 gs_updates_section_set_size_groups	(GsUpdatesSection	*self,
 							 GtkSizeGroup		*image,